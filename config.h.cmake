@@ -4,4 +4,7 @@
 #define PACKAGE "${PROJECT_NAME}"
 #define VERSION "${PROJECT_VERSION}"
 
+#cmakedefine HAVE_STRTOD_L 1
+#cmakedefine HAVE_XLOCALE_H 1
+
 #endif
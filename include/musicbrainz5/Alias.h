@@ -43,6 +43,10 @@ namespace MusicBrainz5
 		CAlias(const XMLNode& Node);
 		CAlias(const CAlias& Other);
 		CAlias& operator =(const CAlias& Other);
+#if __cplusplus >= 201103L
+		CAlias(CAlias&& Other);
+		CAlias& operator =(CAlias&& Other);
+#endif
 		virtual ~CAlias();
 
 		virtual CAlias *Clone();
@@ -59,11 +63,11 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CAliasPrivate * const m_d;
+		CAliasPrivate *m_d;
 	};
 }
 
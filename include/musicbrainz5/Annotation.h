@@ -43,6 +43,10 @@ namespace MusicBrainz5
 		CAnnotation(const XMLNode& Node);
 		CAnnotation(const CAnnotation& Other);
 		CAnnotation& operator =(const CAnnotation& Other);
+#if __cplusplus >= 201103L
+		CAnnotation(CAnnotation&& Other);
+		CAnnotation& operator =(CAnnotation&& Other);
+#endif
 		virtual ~CAnnotation();
 
 		virtual CAnnotation *Clone();
@@ -56,11 +60,11 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CAnnotationPrivate * const m_d;
+		CAnnotationPrivate *m_d;
 	};
 }
 
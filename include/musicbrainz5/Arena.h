@@ -0,0 +1,200 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_ARENA_
+#define _MUSICBRAINZ5_ARENA_
+
+#include <cstddef>
+#include <new>
+
+namespace MusicBrainz5
+{
+	class CArenaPrivate;
+
+	/**
+	 * @brief Arena allocator for parsed entities
+	 *
+	 * Hands out memory for entities by bumping a pointer through large blocks, and frees
+	 * all the blocks at once when it is destroyed. Freeing an individual entity allocated
+	 * from an arena only runs its destructor.
+	 *
+	 * Entities are allocated from the arena made current on the calling thread by a
+	 * MusicBrainz5::CArenaScope, or from the heap if there is none. An arena must only be
+	 * used by one thread at a time, and must outlive everything allocated from it. Arenas
+	 * are normally created by MusicBrainz5::CMetadata::UseArena rather than directly.
+	 */
+	class CArena
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * Constructor
+		 *
+		 * @param BlockSize Size of the blocks the arena allocates from
+		 */
+
+		CArena(size_t BlockSize=65536);
+		~CArena();
+
+		/**
+		 * @brief Number of bytes allocated
+		 *
+		 * @return Number of bytes handed out by the arena
+		 */
+
+		size_t Allocated() const;
+
+		/**
+		 * @brief Number of bytes reserved
+		 *
+		 * @return Total size of the blocks held by the arena
+		 */
+
+		size_t Reserved() const;
+
+		/**
+		 * @brief Allocate memory
+		 *
+		 * Allocate memory from the current arena of the calling thread, or from the heap
+		 * if there is none.
+		 *
+		 * @param Size Number of bytes to allocate
+		 *
+		 * @return Allocated memory
+		 */
+
+		static void *Allocate(size_t Size);
+
+		/**
+		 * @brief Free memory
+		 *
+		 * Free memory returned by MusicBrainz5::CArena::Allocate. Memory that came from an
+		 * arena is only released when the arena is destroyed.
+		 *
+		 * @param Ptr Memory to free
+		 */
+
+		static void Free(void *Ptr);
+
+		/**
+		 * @brief Arena an allocation came from
+		 *
+		 * @param Ptr Memory returned by MusicBrainz5::CArena::Allocate
+		 *
+		 * @return Arena the memory was allocated from, or 0 if it came from the heap
+		 * (or does not belong to any arena)
+		 */
+
+		static CArena *Owner(const void *Ptr);
+
+		/**
+		 * @brief Current arena
+		 *
+		 * @return Current arena of the calling thread, or 0 if there is none
+		 */
+
+		static CArena *Current();
+
+	private:
+		friend class CArenaScope;
+
+		CArena(const CArena& Other);
+		CArena& operator =(const CArena& Other);
+
+		static void SetCurrent(CArena *Arena);
+
+		CArenaPrivate * const m_d;
+	};
+
+	/**
+	 * @brief Make an arena current
+	 *
+	 * Makes an arena the current arena of the calling thread for the lifetime of the
+	 * scope object, restoring the previous one afterwards. A scope for a null arena
+	 * sends allocations back to the heap.
+	 */
+	class CArenaScope
+	{
+	public:
+		CArenaScope(CArena *Arena);
+		~CArenaScope();
+
+	private:
+		CArenaScope(const CArenaScope& Other);
+		CArenaScope& operator =(const CArenaScope& Other);
+
+		CArena *m_Previous;
+	};
+
+	/**
+	 * @brief Base class for objects that may be allocated from an arena
+	 *
+	 * Objects are allocated from the current arena, or from the heap exactly as by the
+	 * global operator new if there is none. Placement new is passed through unchanged.
+	 */
+	class CArenaObject
+	{
+	public:
+		static void *operator new(size_t Size)
+		{
+			return CArena::Allocate(Size);
+		}
+
+		static void *operator new(size_t Size, const std::nothrow_t&) throw()
+		{
+			try
+			{
+				return CArena::Allocate(Size);
+			}
+
+			catch (...)
+			{
+				return 0;
+			}
+		}
+
+		static void *operator new(size_t, void *Ptr) throw()
+		{
+			return Ptr;
+		}
+
+		static void operator delete(void *Ptr)
+		{
+			CArena::Free(Ptr);
+		}
+
+		static void operator delete(void *Ptr, const std::nothrow_t&) throw()
+		{
+			CArena::Free(Ptr);
+		}
+
+		static void operator delete(void *, void *) throw()
+		{
+		}
+	};
+}
+
+#endif
@@ -56,6 +56,10 @@ namespace MusicBrainz5
 		CArtist(const XMLNode& Node=XMLNode::emptyNode());
 		CArtist(const CArtist& Other);
 		CArtist& operator =(const CArtist& Other);
+#if __cplusplus >= 201103L
+		CArtist(CArtist&& Other);
+		CArtist& operator =(CArtist&& Other);
+#endif
 		virtual ~CArtist();
 
 		virtual CArtist *Clone();
@@ -81,17 +85,29 @@ namespace MusicBrainz5
 		CRating *Rating() const;
 		CUserRating *UserRating() const;
 
+		/**
+		 * @brief Pooled field values
+		 *
+		 * The same values as the accessors of the same name, as the pooled strings held by
+		 * the entity. These can be compared by address with MusicBrainz5::CStringPool::Intern,
+		 * instead of comparing the strings.
+		 */
+
+		const std::string *InternedType() const;
+		const std::string *InternedGender() const;
+		const std::string *InternedCountry() const;
+
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
 		void Cleanup();
 
-		CArtistPrivate * const m_d;
+		CArtistPrivate *m_d;
 	};
 }
 
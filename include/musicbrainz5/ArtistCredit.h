@@ -43,6 +43,10 @@ namespace MusicBrainz5
 		CArtistCredit(const XMLNode& Node=XMLNode::emptyNode());
 		CArtistCredit(const CArtistCredit& Other);
 		CArtistCredit& operator =(const CArtistCredit& Other);
+#if __cplusplus >= 201103L
+		CArtistCredit(CArtistCredit&& Other);
+		CArtistCredit& operator =(CArtistCredit&& Other);
+#endif
 		virtual ~CArtistCredit();
 
 		virtual CArtistCredit *Clone();
@@ -53,13 +57,13 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
 		void Cleanup();
 
-		CArtistCreditPrivate * const m_d;
+		CArtistCreditPrivate *m_d;
 	};
 }
 
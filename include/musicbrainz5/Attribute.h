@@ -43,6 +43,10 @@ namespace MusicBrainz5
 		CAttribute(const XMLNode& Node=XMLNode::emptyNode());
 		CAttribute(const CAttribute& Other);
 		CAttribute& operator =(const CAttribute& Other);
+#if __cplusplus >= 201103L
+		CAttribute(CAttribute&& Other);
+		CAttribute& operator =(CAttribute&& Other);
+#endif
 		virtual ~CAttribute();
 
 		virtual CAttribute *Clone();
@@ -53,11 +57,11 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CAttributePrivate * const m_d;
+		CAttributePrivate *m_d;
 	};
 }
 
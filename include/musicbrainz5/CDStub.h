@@ -44,6 +44,10 @@ namespace MusicBrainz5
 		CCDStub(const XMLNode& Node);
 		CCDStub(const CCDStub& Other);
 		CCDStub& operator =(const CCDStub& Other);
+#if __cplusplus >= 201103L
+		CCDStub(CCDStub&& Other);
+		CCDStub& operator =(CCDStub&& Other);
+#endif
 		virtual ~CCDStub();
 
 		virtual CCDStub *Clone();
@@ -59,13 +63,13 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
 		void Cleanup();
 
-		CCDStubPrivate * const m_d;
+		CCDStubPrivate *m_d;
 	};
 }
 
@@ -41,6 +41,10 @@ namespace MusicBrainz5
 		CCollection(const XMLNode& Node);
 		CCollection(const CCollection& Other);
 		CCollection& operator =(const CCollection& Other);
+#if __cplusplus >= 201103L
+		CCollection(CCollection&& Other);
+		CCollection& operator =(CCollection&& Other);
+#endif
 		virtual ~CCollection();
 
 		virtual CCollection *Clone();
@@ -54,13 +58,13 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
 		void Cleanup();
 
-		CCollectionPrivate * const m_d;
+		CCollectionPrivate *m_d;
 	};
 }
 
@@ -47,6 +47,10 @@ namespace MusicBrainz5
 		CDisc(const XMLNode& Node=XMLNode::emptyNode());
 		CDisc(const CDisc& Other);
 		CDisc& operator =(const CDisc& Other);
+#if __cplusplus >= 201103L
+		CDisc(CDisc&& Other);
+		CDisc& operator =(CDisc&& Other);
+#endif
 		virtual ~CDisc();
 
 		virtual CDisc *Clone();
@@ -60,13 +64,13 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
 		void Cleanup();
 
-		CDiscPrivate * const m_d;
+		CDiscPrivate *m_d;
 	};
 }
 
@@ -0,0 +1,190 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_DISK_CACHE_
+#define _MUSICBRAINZ5_DISK_CACHE_
+
+#include <string>
+#include <vector>
+
+namespace MusicBrainz5
+{
+	class CDiskCachePrivate;
+
+	/**
+	 * @brief Persistent cache of web service responses
+	 *
+	 * Cache of web service responses stored in a directory, so that it survives
+	 * restarts of the application. Responses are compressed and appended to segment
+	 * files, and a hash index of the query URLs is kept in a memory mapped file.
+	 * Both are mapped into memory, so a lookup that finds a response does not need
+	 * to make any system calls.
+	 *
+	 * When the cache grows beyond its maximum size it is compacted, keeping the most
+	 * recently stored responses.
+	 *
+	 * Expired responses are kept if the server sent an ETag or Last-Modified header
+	 * with them, so that they can be revalidated with a conditional request.
+	 *
+	 * Only one process may use a cache directory at a time. A cache may be shared
+	 * by several MusicBrainz5::CQuery objects in the same process, and may be used
+	 * from multiple threads.
+	 */
+	class CDiskCache
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * Open the cache in a directory, creating it if required. If the cache cannot
+		 * be opened (for example because another process is using it), it behaves as
+		 * an empty cache that stores nothing (see MusicBrainz5::CDiskCache::IsOpen).
+		 *
+		 * @param Path Directory to store the cache in
+		 * @param MaxSize Maximum size in bytes of the cache on disk
+		 * @param IndexSize Number of entries in the index. Ignored if the cache already exists.
+		 */
+
+		CDiskCache(const std::string& Path, size_t MaxSize=256*1024*1024, int IndexSize=65536);
+		~CDiskCache();
+
+		/**
+		 * @brief Check whether the cache is open
+		 *
+		 * @return true if the cache was opened successfully
+		 */
+
+		bool IsOpen() const;
+
+		/**
+		 * @brief Set the maximum age of responses
+		 *
+		 * Set the number of seconds a response is returned from the cache after it was
+		 * stored. A maximum age of 0 (the default) means responses never expire.
+		 *
+		 * @param MaxAge Maximum age in seconds
+		 */
+
+		void SetMaxAge(int MaxAge);
+
+		/**
+		 * @brief Set the stale-while-revalidate period
+		 *
+		 * Set the number of seconds after its maximum age during which a response is
+		 * still returned, while a request to revalidate it is made in the background.
+		 *
+		 * @param StaleWhileRevalidate Period in seconds
+		 */
+
+		void SetStaleWhileRevalidate(int StaleWhileRevalidate);
+
+		/**
+		 * @brief Set the maximum size
+		 *
+		 * Set the maximum size in bytes of the cache on disk
+		 *
+		 * @param MaxSize Maximum size in bytes
+		 */
+
+		void SetMaxSize(size_t MaxSize);
+
+		int MaxAge() const;
+		int StaleWhileRevalidate() const;
+		size_t MaxSize() const;
+
+		/**
+		 * @brief Current size
+		 *
+		 * @return Size in bytes of the segment files, including responses that have
+		 * been replaced but not yet compacted away
+		 */
+
+		size_t Size() const;
+
+		/**
+		 * @brief Number of entries
+		 *
+		 * @return Number of responses in the index
+		 */
+
+		size_t Count() const;
+
+		/**
+		 * @brief Number of cache hits
+		 *
+		 * @return Number of queries answered from the cache
+		 */
+
+		unsigned long Hits() const;
+
+		/**
+		 * @brief Number of cache misses
+		 *
+		 * @return Number of queries not found in the cache
+		 */
+
+		unsigned long Misses() const;
+
+		/**
+		 * @brief Compact the cache
+		 *
+		 * Rewrite the segment files so that they only contain the current response
+		 * for each entry, dropping expired responses and, if the cache is larger than
+		 * its maximum size, the oldest ones.
+		 */
+
+		void Compact();
+
+		/**
+		 * @brief Remove all entries
+		 *
+		 * Remove all responses from the cache
+		 */
+
+		void Clear();
+
+	private:
+		friend class CQuery;
+
+		CDiskCache(const CDiskCache& Other);
+		CDiskCache& operator =(const CDiskCache& Other);
+
+		enum tFindResult
+		{
+			eFind_Miss=0,
+			eFind_Fresh,
+			eFind_Stale,
+			eFind_Expired
+		};
+
+		tFindResult Find(const std::string& Key, std::vector<unsigned char>& Data, std::string& ETag, std::string& LastModified);
+		void Store(const std::string& Key, const unsigned char *Data, size_t Length, const std::string& ETag, const std::string& LastModified);
+		void Refresh(const std::string& Key);
+
+		CDiskCachePrivate * const m_d;
+	};
+}
+
+#endif
@@ -30,7 +30,10 @@
 #include <string>
 #include <sstream>
 #include <map>
+#include <utility>
 
+#include "musicbrainz5/SharedData.h"
+#include "musicbrainz5/StringPool.h"
 #include "musicbrainz5/xmlParser.h"
 
 namespace MusicBrainz5
@@ -38,13 +41,18 @@ namespace MusicBrainz5
 	class CEntityPrivate;
 
 	class CRelationListList;
+	class CMetadataParserPrivate;
 
-	class CEntity
+	class CEntity: public CArenaObject
 	{
 	public:
 		CEntity();
 		CEntity(const CEntity& Other);
 		CEntity& operator =(const CEntity& Other);
+#if __cplusplus >= 201103L
+		CEntity(CEntity&& Other);
+		CEntity& operator =(CEntity&& Other);
+#endif
 		virtual ~CEntity();
 
 		virtual CEntity *Clone()=0;
@@ -100,18 +108,39 @@ namespace MusicBrainz5
 			}
 		}
 
+		void ProcessItem(const XMLNode& Node, int& RetVal);
+		void ProcessItem(const XMLNode& Node, double& RetVal);
+		void ProcessItem(const std::string& Text, int& RetVal);
+		void ProcessItem(const std::string& Text, double& RetVal);
+		void ProcessItem(const char *Text, int& RetVal);
+		void ProcessItem(const char *Text, double& RetVal);
+
 		void ProcessItem(const XMLNode& Node, std::string& RetVal)
 		{
 			if (Node.getText())
 				RetVal=Node.getText();
 		}
 
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value)=0;
+		void ProcessItem(const XMLNode& Node, const std::string* & RetVal)
+		{
+			if (Node.getText())
+				RetVal=CStringPool::Intern(Node.getText());
+		}
+
+		void ProcessItem(const std::string& Text, const std::string* & RetVal)
+		{
+			RetVal=CStringPool::Intern(Text);
+		}
+
+		virtual void ParseAttribute(const char *Name, const char *Value)=0;
 		virtual void ParseElement(const XMLNode& Node)=0;
 
 	private:
+		friend class CMetadataParserPrivate;
+
 		CEntityPrivate *m_d;
 
+		void ParseChild(const XMLNode& Node);
 		void Cleanup();
 	};
 }
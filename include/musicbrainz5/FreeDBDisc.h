@@ -44,6 +44,10 @@ namespace MusicBrainz5
 		CFreeDBDisc(const XMLNode& Node);
 		CFreeDBDisc(const CFreeDBDisc& Other);
 		CFreeDBDisc& operator =(const CFreeDBDisc& Other);
+#if __cplusplus >= 201103L
+		CFreeDBDisc(CFreeDBDisc&& Other);
+		CFreeDBDisc& operator =(CFreeDBDisc&& Other);
+#endif
 		virtual ~CFreeDBDisc();
 
 		virtual CFreeDBDisc *Clone();
@@ -59,13 +63,13 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
 		void Cleanup();
 
-		CFreeDBDiscPrivate * const m_d;
+		CFreeDBDiscPrivate *m_d;
 	};
 }
 
@@ -0,0 +1,140 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_HTTP_CONNECTION_POOL_
+#define _MUSICBRAINZ5_HTTP_CONNECTION_POOL_
+
+#include <string>
+
+struct ne_session_s;
+typedef struct ne_session_s ne_session;
+
+namespace MusicBrainz5
+{
+	class CHTTPConnectionPoolPrivate;
+
+	/**
+	 * @brief Pool of persistent HTTP connections
+	 *
+	 * Keeps idle HTTP sessions open so that consecutive requests to the same host
+	 * can reuse an existing keep-alive connection instead of performing a new
+	 * TCP handshake for every request.
+	 *
+	 * Sessions are pooled per host, port, proxy and user name. A pool may be
+	 * shared between several MusicBrainz5::CQuery objects, and may be used from
+	 * multiple threads.
+	 */
+	class CHTTPConnectionPool
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * Constructor
+		 *
+		 * @param MaxIdle Maximum number of idle connections to keep per host
+		 * @param IdleTimeout Number of seconds an idle connection is kept open
+		 */
+
+		CHTTPConnectionPool(int MaxIdle=4, int IdleTimeout=30);
+		~CHTTPConnectionPool();
+
+		/**
+		 * @brief Set the maximum number of idle connections
+		 *
+		 * Set the maximum number of idle connections kept open for each host. Setting
+		 * this to 0 disables connection reuse.
+		 *
+		 * @param MaxIdle Maximum number of idle connections per host
+		 */
+
+		void SetMaxIdle(int MaxIdle);
+
+		/**
+		 * @brief Set the idle timeout
+		 *
+		 * Set the number of seconds an unused connection is kept in the pool before
+		 * it is closed.
+		 *
+		 * @param IdleTimeout Idle timeout in seconds
+		 */
+
+		void SetIdleTimeout(int IdleTimeout);
+
+		/**
+		 * @brief Enable or disable liveness checks
+		 *
+		 * When enabled (the default), a request that fails with a connection error
+		 * on a reused connection is retried once on a newly created connection, as
+		 * the server may have closed the idle connection in the meantime.
+		 *
+		 * @param CheckLiveness true to enable liveness checks
+		 */
+
+		void SetCheckLiveness(bool CheckLiveness);
+
+		int MaxIdle() const;
+		int IdleTimeout() const;
+		bool CheckLiveness() const;
+
+		/**
+		 * @brief Number of times a pooled connection was reused
+		 *
+		 * @return Number of requests that were sent on a pooled connection
+		 */
+
+		unsigned long Reused() const;
+
+		/**
+		 * @brief Number of connections created
+		 *
+		 * @return Number of new connections that had to be created
+		 */
+
+		unsigned long Created() const;
+
+		/**
+		 * @brief Close all idle connections
+		 *
+		 * Close all connections currently held in the pool.
+		 */
+
+		void Clear();
+
+	private:
+		friend class CHTTPFetch;
+
+		CHTTPConnectionPool(const CHTTPConnectionPool& Other);
+		CHTTPConnectionPool& operator =(const CHTTPConnectionPool& Other);
+
+		ne_session *Acquire(const std::string& Key);
+		void SessionCreated();
+		void Release(const std::string& Key, ne_session *Session, bool Reusable);
+
+		CHTTPConnectionPoolPrivate * const m_d;
+	};
+}
+
+#endif
@@ -32,6 +32,7 @@
 namespace MusicBrainz5
 {
 	class CHTTPFetchPrivate;
+	class CHTTPConnectionPool;
 
 	class CExceptionBase: public std::exception
 	{
@@ -50,6 +51,17 @@ namespace MusicBrainz5
 	    return m_FullMessage.c_str();
 	  }
 
+		/**
+		 * @brief Return the error message
+		 *
+		 * @return Error message, without the kind of error that what() starts with
+		 */
+
+		const std::string& ErrorMessage() const throw()
+		{
+			return m_ErrorMessage;
+		}
+
 	 private:
 		std::string m_ErrorMessage;
 		std::string m_Exception;
@@ -143,6 +155,19 @@ namespace MusicBrainz5
 	class CHTTPFetch
 	{
 	public:
+		/**
+		 * @brief Reader for the response body
+		 *
+		 * Function called with each block of the response body as it is received.
+		 *
+		 * @param UserData User data passed to MusicBrainz5::CHTTPFetch::SetResponseReader
+		 * @param Data Block of data received
+		 * @param Length Length of the block of data
+		 *
+		 * @return 0 to continue reading the response, non-zero to abort the request
+		 */
+		typedef int (*tResponseReader)(void *UserData, const char *Data, size_t Length);
+
 		/**
 		 * @brief Constructor
 		 *
@@ -217,10 +242,69 @@ namespace MusicBrainz5
 
 		void SetProxyPassword(const std::string& ProxyPassword);
 
+		/**
+		 * @brief Set the connection pool to use
+		 *
+		 * Set the pool that connections are taken from and returned to. If no pool
+		 * is set, a new connection is created for each request.
+		 *
+		 * @param ConnectionPool Connection pool to use (may be NULL)
+		 */
+
+		void SetConnectionPool(CHTTPConnectionPool *ConnectionPool);
+
+		/**
+		 * @brief Make the request conditional on the entity tag
+		 *
+		 * Send an If-None-Match header with the request, so that the server responds
+		 * with status 304 (Not Modified) and no data if the resource still has this
+		 * entity tag.
+		 *
+		 * @param ETag Entity tag from a previous response (empty to send no header)
+		 */
+
+		void SetIfNoneMatch(const std::string& ETag);
+
+		/**
+		 * @brief Make the request conditional on the modification time
+		 *
+		 * Send an If-Modified-Since header with the request, so that the server responds
+		 * with status 304 (Not Modified) and no data if the resource has not changed
+		 * since this time.
+		 *
+		 * @param LastModified Last-Modified value from a previous response (empty to send no header)
+		 */
+
+		void SetIfModifiedSince(const std::string& LastModified);
+
+		/**
+		 * @brief Enable compressed transfers
+		 *
+		 * Ask the server to compress the response with gzip or deflate, and decompress
+		 * it as it is received. Has no effect if libneon was built without zlib support.
+		 *
+		 * @param Compression true to enable compressed transfers
+		 */
+
+		void SetCompression(bool Compression);
+
+		/**
+		 * @brief Set a reader for the response body
+		 *
+		 * Pass each block of a successful response to ResponseReader as it is received,
+		 * instead of collecting the response for MusicBrainz5::CHTTPFetch::Data.
+		 *
+		 * @param ResponseReader Reader to pass response data to (NULL to collect the response)
+		 * @param UserData User data to pass to the reader
+		 */
+
+		void SetResponseReader(tResponseReader ResponseReader, void *UserData);
+
 		/**
 		 * @brief Make a request to the server
 		 *
-		 * Make a request to the server
+		 * Make a request to the server. A conditional request that finds the resource
+		 * unchanged returns 0, and MusicBrainz5::CHTTPFetch::Status returns 304.
 		 *
 		 * @param URL URL to request
 		 * @param Request Request type (GET by default)
@@ -247,6 +331,81 @@ namespace MusicBrainz5
 
 		std::vector<unsigned char> Data() const;
 
+		/**
+		 * @brief Get a pointer to the data received
+		 *
+		 * Get a pointer to the data received from the request, without copying it.
+		 * The pointer remains valid until the next request, a call to
+		 * MusicBrainz5::CHTTPFetch::TakeData or the object is destroyed.
+		 *
+		 * @return Pointer to the data received (NULL if no data was received)
+		 */
+
+		const unsigned char *DataBuffer() const;
+
+		/**
+		 * @brief Get the size of the data received
+		 *
+		 * Get the size of the data returned by MusicBrainz5::CHTTPFetch::DataBuffer
+		 *
+		 * @return Number of bytes of data received
+		 */
+
+		size_t DataSize() const;
+
+		/**
+		 * @brief Take the data received
+		 *
+		 * Move the data received from the request into Data, without copying it.
+		 * The previous contents of Data are discarded, and its storage is reused
+		 * for the next request.
+		 *
+		 * @param Data Vector to move the received data into
+		 */
+
+		void TakeData(std::vector<unsigned char>& Data);
+
+		/**
+		 * @brief Number of bytes transferred
+		 *
+		 * Return the size of the response body as it was transferred, before it was
+		 * decompressed.
+		 *
+		 * @return Number of bytes transferred
+		 */
+
+		size_t WireBytes() const;
+
+		/**
+		 * @brief Number of bytes decoded
+		 *
+		 * Return the size of the response body after it was decompressed
+		 *
+		 * @return Number of bytes decoded
+		 */
+
+		size_t DecodedBytes() const;
+
+		/**
+		 * @brief Entity tag of the response
+		 *
+		 * Return the ETag header from the response
+		 *
+		 * @return Entity tag (empty if the server did not send one)
+		 */
+
+		std::string ETag() const;
+
+		/**
+		 * @brief Modification time of the response
+		 *
+		 * Return the Last-Modified header from the response
+		 *
+		 * @return Modification time (empty if the server did not send one)
+		 */
+
+		std::string LastModified() const;
+
 		/**
 		 * @brief libneon result code from the request
 		 *
@@ -43,6 +43,10 @@ namespace MusicBrainz5
 		CIPI(const XMLNode& Node=XMLNode::emptyNode());
 		CIPI(const CIPI& Other);
 		CIPI& operator =(const CIPI& Other);
+#if __cplusplus >= 201103L
+		CIPI(CIPI&& Other);
+		CIPI& operator =(CIPI&& Other);
+#endif
 		virtual ~CIPI();
 
 		virtual CIPI *Clone();
@@ -53,11 +57,11 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CIPIPrivate * const m_d;
+		CIPIPrivate *m_d;
 	};
 }
 
@@ -41,6 +41,10 @@ namespace MusicBrainz5
 		CISRC(const XMLNode& Node=XMLNode::emptyNode());
 		CISRC(const CISRC& Other);
 		CISRC& operator =(const CISRC& Other);
+#if __cplusplus >= 201103L
+		CISRC(CISRC&& Other);
+		CISRC& operator =(CISRC&& Other);
+#endif
 		virtual ~CISRC();
 
 		virtual CISRC *Clone();
@@ -52,13 +56,13 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
 		void Cleanup();
 
-		CISRCPrivate * const m_d;
+		CISRCPrivate *m_d;
 	};
 }
 
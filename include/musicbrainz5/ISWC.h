@@ -43,6 +43,10 @@ namespace MusicBrainz5
 		CISWC(const XMLNode& Node=XMLNode::emptyNode());
 		CISWC(const CISWC& Other);
 		CISWC& operator =(const CISWC& Other);
+#if __cplusplus >= 201103L
+		CISWC(CISWC&& Other);
+		CISWC& operator =(CISWC&& Other);
+#endif
 		virtual ~CISWC();
 
 		virtual CISWC *Clone();
@@ -53,13 +57,13 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
 		void Cleanup();
 
-		CISWCPrivate * const m_d;
+		CISWCPrivate *m_d;
 	};
 }
 
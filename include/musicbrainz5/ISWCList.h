@@ -44,6 +44,10 @@ namespace MusicBrainz5
 		CISWCList(const XMLNode& Node=XMLNode::emptyNode());
 		CISWCList(const CISWCList& Other);
 		CISWCList& operator =(const CISWCList& Other);
+#if __cplusplus >= 201103L
+		CISWCList(CISWCList&& Other);
+		CISWCList& operator =(CISWCList&& Other);
+#endif
 		virtual ~CISWCList();
 
 		virtual CISWCList *Clone();
@@ -52,11 +56,11 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CISWCListPrivate * const m_d;
+		CISWCListPrivate *m_d;
 	};
 }
 
@@ -0,0 +1,84 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_JSON_PARSER_
+#define _MUSICBRAINZ5_JSON_PARSER_
+
+#include <string>
+#include <cstddef>
+
+#include "musicbrainz5/xmlParser.h"
+
+namespace MusicBrainz5
+{
+	class CJSONParserPrivate;
+
+	/**
+	 * @brief Parser for JSON web service responses
+	 *
+	 * Converts a response requested with fmt=json into the document tree the same
+	 * response in XML would have produced, so that MusicBrainz5::CMetadata and the
+	 * entity classes build the same objects from either format.
+	 *
+	 * Keys are mapped to the XML element and attribute names they correspond to, and
+	 * arrays to the matching lists (for example "media" to a medium-list of medium
+	 * elements). Relations are grouped into one relation-list per target type. Null
+	 * and false values are left out, as the XML leaves out missing fields and unset
+	 * flags. Keys and arrays with no XML equivalent are skipped.
+	 */
+	class CJSONParser
+	{
+	public:
+		/**
+		 * @brief Check for a JSON response
+		 *
+		 * @param Data Response
+		 * @param Length Length of the response
+		 *
+		 * @return true if the response is a JSON object
+		 */
+
+		static bool IsJSON(const char *Data, size_t Length);
+
+		/**
+		 * @brief Parse a JSON response
+		 *
+		 * @param Data Response
+		 * @param Length Length of the response
+		 * @param Entity Entity the query was made for (for example "release" or "discid")
+		 * @param Results Details of any error in the response
+		 *
+		 * @return Root node of the document, which must be deleted by the caller. The node
+		 * is empty if the response could not be parsed.
+		 */
+
+		static XMLNode *Parse(const char *Data, size_t Length, const std::string& Entity, XMLResults *Results);
+
+	private:
+		CJSONParser();
+	};
+}
+
+#endif
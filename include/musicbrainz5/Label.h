@@ -53,6 +53,10 @@ namespace MusicBrainz5
 		CLabel(const XMLNode& Node=XMLNode::emptyNode());
 		CLabel(const CLabel& Other);
 		CLabel& operator =(const CLabel& Other);
+#if __cplusplus >= 201103L
+		CLabel(CLabel&& Other);
+		CLabel& operator =(CLabel&& Other);
+#endif
 		virtual ~CLabel();
 
 		virtual CLabel *Clone();
@@ -78,13 +82,13 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
 		void Cleanup();
 
-		CLabelPrivate * const m_d;
+		CLabelPrivate *m_d;
 	};
 }
 
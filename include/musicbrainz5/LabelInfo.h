@@ -45,6 +45,10 @@ namespace MusicBrainz5
 		CLabelInfo(const XMLNode& Node=XMLNode::emptyNode());
 		CLabelInfo(const CLabelInfo& Other);
 		CLabelInfo& operator =(const CLabelInfo& Other);
+#if __cplusplus >= 201103L
+		CLabelInfo(CLabelInfo&& Other);
+		CLabelInfo& operator =(CLabelInfo&& Other);
+#endif
 		virtual ~CLabelInfo();
 
 		virtual CLabelInfo *Clone();
@@ -56,13 +60,13 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
 		void Cleanup();
 
-		CLabelInfoPrivate * const m_d;
+		CLabelInfoPrivate *m_d;
 	};
 }
 
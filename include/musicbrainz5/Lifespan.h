@@ -43,6 +43,10 @@ namespace MusicBrainz5
 		CLifespan(const XMLNode& Node=XMLNode::emptyNode());
 		CLifespan(const CLifespan& Other);
 		CLifespan& operator =(const CLifespan& Other);
+#if __cplusplus >= 201103L
+		CLifespan(CLifespan&& Other);
+		CLifespan& operator =(CLifespan&& Other);
+#endif
 		virtual ~CLifespan();
 
 		virtual CLifespan *Clone();
@@ -55,11 +59,11 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CLifespanPrivate * const m_d;
+		CLifespanPrivate *m_d;
 	};
 }
 
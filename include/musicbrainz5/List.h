@@ -34,12 +34,18 @@ namespace MusicBrainz5
 {
 	class CListPrivate;
 
+	template <class T> class CListImpl;
+
 	class CList: public CEntity
 	{
 	public:
 		CList();
 		CList(const CList& Other);
 		CList& operator =(const CList& Other);
+#if __cplusplus >= 201103L
+		CList(CList&& Other);
+		CList& operator =(CList&& Other);
+#endif
 		virtual ~CList();
 
 		virtual CList *Clone();
@@ -52,15 +58,38 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
-		void AddItem(CEntity *Item);
 		CEntity *Item(int Item) const;
 
+		/**
+		 * @brief Reserve space for items
+		 *
+		 * @param Size Number of items the list is expected to hold
+		 */
+
+		void Reserve(int Size);
+
+		/**
+		 * @brief Return the items
+		 *
+		 * @return Pointer to the items, which are stored contiguously
+		 */
+
+		CEntity * const *Items() const;
+
 	private:
+		friend class CMetadataParserPrivate;
+		template <class T> friend class CListImpl;
+
 		CListPrivate *m_d;
 
+		// Only CListImpl<T> adds items, and only items of type T, which it relies on
+		// to return them without a checked cast
+
+		void AddItem(CEntity *Item);
+
 		void Cleanup();
 	};
 }
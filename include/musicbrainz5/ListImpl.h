@@ -28,12 +28,77 @@
 
 #include "musicbrainz5/List.h"
 
+#include <iterator>
+#include <cstddef>
+
 namespace MusicBrainz5
 {
 	template <class T>
 	class CListImpl: public CList
 	{
 	public:
+		/**
+		 * @brief Iterator over the items in a list
+		 *
+		 * Only items of type T are ever added to a list, so no checked cast is needed
+		 * to return them. Debug builds check the cast anyway.
+		 */
+		class const_iterator
+		{
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef T *value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef T * const *pointer;
+			typedef T *reference;
+
+			const_iterator(CEntity * const *Item=0)
+			:	m_Item(Item)
+			{
+			}
+
+			T *operator *() const
+			{
+				return Cast(*m_Item);
+			}
+
+			T *operator ->() const
+			{
+				return Cast(*m_Item);
+			}
+
+			const_iterator& operator ++()
+			{
+				++m_Item;
+
+				return *this;
+			}
+
+			const_iterator operator ++(int)
+			{
+				const_iterator Ret=*this;
+
+				++m_Item;
+
+				return Ret;
+			}
+
+			bool operator ==(const const_iterator& Other) const
+			{
+				return m_Item==Other.m_Item;
+			}
+
+			bool operator !=(const const_iterator& Other) const
+			{
+				return m_Item!=Other.m_Item;
+			}
+
+		private:
+			CEntity * const *m_Item;
+		};
+
+		typedef const_iterator iterator;
+
 		CListImpl(const XMLNode& Node=XMLNode::emptyNode())
 		:	CList()
 		{
@@ -61,6 +126,24 @@ namespace MusicBrainz5
 			return *this;
 		}
 
+#if __cplusplus >= 201103L
+		CListImpl(CListImpl<T>&& Other)
+		:	CList()
+		{
+			*this=std::move(Other);
+		}
+
+		MusicBrainz5::CListImpl<T>& operator =(CListImpl<T>&& Other)
+		{
+			if (this!=&Other)
+			{
+				CList::operator =(std::move(Other));
+			}
+
+			return *this;
+		}
+#endif
+
 		virtual ~CListImpl()
 		{
 		}
@@ -76,12 +159,8 @@ namespace MusicBrainz5
 
 			CList::Serialise(os);
 
-			for (int count=0;count<NumItems();count++)
-			{
-				T *ThisItem=Item(count);
-
-				os << *ThisItem << std::endl;
-			}
+			for (const_iterator ThisItem=begin();ThisItem!=end();++ThisItem)
+				os << **ThisItem << std::endl;
 
 			return os;
 		}
@@ -93,7 +172,29 @@ namespace MusicBrainz5
 
 		T *Item(int Item) const
 		{
-			return dynamic_cast<T *>(CList::Item(Item));
+			return Cast(CList::Item(Item));
+		}
+
+		/**
+		 * @brief Iterator to the first item
+		 *
+		 * @return Iterator to the first item in the list
+		 */
+
+		const_iterator begin() const
+		{
+			return const_iterator(Items());
+		}
+
+		/**
+		 * @brief Iterator past the last item
+		 *
+		 * @return Iterator past the last item in the list
+		 */
+
+		const_iterator end() const
+		{
+			return const_iterator(Items()+NumItems());
 		}
 
 		void AddItem(T *Item)
@@ -101,12 +202,37 @@ namespace MusicBrainz5
 			CList::AddItem(Item);
 		}
 
+		/**
+		 * @brief Reserve space for items
+		 *
+		 * Reserve space for a number of items before adding them. Lists being parsed
+		 * reserve space for the number of items given by their count attribute.
+		 *
+		 * @param Size Number of items the list is expected to hold
+		 */
+
+		void Reserve(int Size)
+		{
+			CList::Reserve(Size);
+		}
+
 	protected:
-		void ParseElement(const XMLNode& Node)
+		static T *Cast(CEntity *Item)
 		{
-			std::string NodeName=Node.getName();
+#ifdef _MB5_DEBUG_
+			T *Ret=dynamic_cast<T *>(Item);
+			if (Item && !Ret)
+				std::cerr << "Item of wrong type in " << T::GetElementName() << " list" << std::endl;
+
+			return Ret;
+#else
+			return static_cast<T *>(Item);
+#endif
+		}
 
-			if (T::GetElementName()==NodeName)
+		void ParseElement(const XMLNode& Node)
+		{
+			if (T::GetElementName()==Node.getName())
 			{
 				T *Item=0;
 
@@ -0,0 +1,99 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_LOOKUP_RESULT_
+#define _MUSICBRAINZ5_LOOKUP_RESULT_
+
+#include <string>
+
+#include "musicbrainz5/Query.h"
+#include "musicbrainz5/Metadata.h"
+
+namespace MusicBrainz5
+{
+	class CLookupResultPrivate;
+
+	/**
+	 * @brief Result of one lookup in a batch
+	 *
+	 * Result of looking up one ID with one of the batch lookup functions, such as
+	 * MusicBrainz5::CQuery::LookupReleases. Each lookup succeeds or fails on its own.
+	 */
+	class CLookupResult
+	{
+	public:
+		CLookupResult(const std::string& ID="");
+		CLookupResult(const CLookupResult& Other);
+		CLookupResult& operator =(const CLookupResult& Other);
+		~CLookupResult();
+
+		/**
+		 * @brief ID that was looked up
+		 *
+		 * @return MusicBrainz ID that was looked up
+		 */
+
+		std::string ID() const;
+
+		/**
+		 * @brief Result of the lookup
+		 *
+		 * @return Result of the lookup, MusicBrainz5::CQuery::eQuery_Success if it succeeded
+		 */
+
+		CQuery::tQueryResult Result() const;
+
+		/**
+		 * @brief Error message
+		 *
+		 * @return Error message if the lookup failed
+		 */
+
+		std::string ErrorMessage() const;
+
+		/**
+		 * @brief Metadata returned
+		 *
+		 * @return Metadata returned by the lookup (empty if it failed)
+		 */
+
+		CMetadata *Metadata() const;
+
+		CRelease *Release() const;
+		CArtist *Artist() const;
+		CRecording *Recording() const;
+		CLabel *Label() const;
+		CWork *Work() const;
+
+	private:
+		friend class CQuery;
+
+		void Set(const CMetadata& Metadata, CQuery::tQueryResult Result, const std::string& ErrorMessage);
+
+		CLookupResultPrivate * const m_d;
+	};
+}
+
+#endif
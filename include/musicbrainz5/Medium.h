@@ -45,6 +45,10 @@ namespace MusicBrainz5
 		CMedium(const XMLNode& Node=XMLNode::emptyNode());
 		CMedium(const CMedium& Other);
 		CMedium& operator =(const CMedium& Other);
+#if __cplusplus >= 201103L
+		CMedium(CMedium&& Other);
+		CMedium& operator =(CMedium&& Other);
+#endif
 		virtual ~CMedium();
 
 		virtual CMedium *Clone();
@@ -57,17 +61,27 @@ namespace MusicBrainz5
 
 		bool ContainsDiscID(const std::string& DiscID) const;
 
+		/**
+		 * @brief Pooled format
+		 *
+		 * The same value as MusicBrainz5::CMedium::Format, as the pooled string held by the
+		 * entity. It can be compared by address with MusicBrainz5::CStringPool::Intern,
+		 * instead of comparing the strings.
+		 */
+
+		const std::string *InternedFormat() const;
+
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
 		void Cleanup();
 
-		CMediumPrivate * const m_d;
+		CMediumPrivate *m_d;
 	};
 }
 
@@ -44,6 +44,10 @@ namespace MusicBrainz5
 		CMediumList(const XMLNode& Node=XMLNode::emptyNode());
 		CMediumList(const CMediumList& Other);
 		CMediumList& operator =(const CMediumList& Other);
+#if __cplusplus >= 201103L
+		CMediumList(CMediumList&& Other);
+		CMediumList& operator =(CMediumList&& Other);
+#endif
 		virtual ~CMediumList();
 
 		virtual CMediumList *Clone();
@@ -54,11 +58,11 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CMediumListPrivate * const m_d;
+		CMediumListPrivate *m_d;
 	};
 }
 
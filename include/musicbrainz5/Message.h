@@ -43,6 +43,10 @@ namespace MusicBrainz5
 		CMessage(const XMLNode& Node);
 		CMessage(const CMessage& Other);
 		CMessage& operator =(const CMessage& Other);
+#if __cplusplus >= 201103L
+		CMessage(CMessage&& Other);
+		CMessage& operator =(CMessage&& Other);
+#endif
 		virtual ~CMessage();
 
 		virtual CMessage *Clone();
@@ -53,11 +57,11 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CMessagePrivate * const m_d;
+		CMessagePrivate *m_d;
 	};
 }
 
@@ -72,10 +72,57 @@ namespace MusicBrainz5
 		CMetadata(const XMLNode& Node=XMLNode::emptyNode());
 		CMetadata(const CMetadata& Other);
 		CMetadata& operator =(const CMetadata& Other);
+#if __cplusplus >= 201103L
+		CMetadata(CMetadata&& Other);
+		CMetadata& operator =(CMetadata&& Other);
+#endif
 		virtual ~CMetadata();
 
 		virtual CMetadata *Clone();
 
+		/**
+		 * @brief Allocate entities from an arena
+		 *
+		 * Allocate the entities subsequently parsed into this object from an arena owned by
+		 * it, so that they are freed together when it is destroyed. Copies of this object
+		 * get an arena of their own. Any entities already in this object are removed.
+		 *
+		 * Entities copied out of this object are allocated normally.
+		 */
+
+		void UseArena();
+
+		/**
+		 * @brief Return the arena
+		 *
+		 * @return Arena entities in this object are allocated from, or 0 if there is none
+		 */
+
+		CArena *Arena() const;
+
+		/**
+		 * @brief Make parsed entities immutable
+		 *
+		 * Make this object, and the entities subsequently parsed into it, immutable. Copies
+		 * of immutable entities share their data with the original through a reference
+		 * count instead of duplicating it, so copying a result, or handing it to other
+		 * threads or caches, takes constant time. Immutable entities must not be modified
+		 * after they have been parsed. This should be called before anything is parsed
+		 * into this object.
+		 *
+		 * @param Immutable true to make entities immutable
+		 */
+
+		void SetImmutable(bool Immutable);
+
+		/**
+		 * @brief Whether parsed entities are immutable
+		 *
+		 * @return true if entities parsed into this object are immutable
+		 */
+
+		bool Immutable() const;
+
 		std::string XMLNS() const;
 		std::string XMLNSExt() const;
 		std::string Generator() const;
@@ -113,13 +160,13 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
 		void Cleanup();
 
-		CMetadataPrivate * const m_d;
+		CMetadataPrivate *m_d;
 	};
 }
 
@@ -0,0 +1,128 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_METADATA_PARSER_H
+#define _MUSICBRAINZ5_METADATA_PARSER_H
+
+#include <string>
+
+namespace MusicBrainz5
+{
+	class CMetadata;
+	class CEntity;
+	class CMetadataParserPrivate;
+
+	/**
+	 * @brief Streaming parser for web service responses
+	 *
+	 * Builds a MusicBrainz5::CMetadata object directly from SAX events, without first
+	 * building a DOM of the whole response. Each item in a top level list (for example
+	 * each release in a release list) is parsed and released as soon as it has been
+	 * read, so only one item's document tree is held in memory at a time.
+	 *
+	 * The response may be supplied all at once, or in chunks as it is received.
+	 */
+	class CMetadataParser
+	{
+	public:
+		/**
+		 * @brief Callback for streamed list items
+		 *
+		 * Function called as each item in a top level list has been parsed. The item is
+		 * freed once the callback returns. The callback must not throw an exception.
+		 *
+		 * @param Entity Item that has been parsed (for example a MusicBrainz5::CRelease)
+		 * @param UserData User data passed to MusicBrainz5::CMetadataParser::SetEntityCallback
+		 */
+		typedef void (*tEntityCallback)(const CEntity& Entity, void *UserData);
+
+		/**
+		 * @brief Constructor
+		 *
+		 * Constructor
+		 *
+		 * @param Metadata Object to build from the parsed response. The object must
+		 *		outlive the parser.
+		 */
+
+		CMetadataParser(CMetadata& Metadata);
+		~CMetadataParser();
+
+		/**
+		 * @brief Deliver list items to a callback
+		 *
+		 * Pass each item in a top level list to Callback as soon as it has been parsed,
+		 * instead of adding it to the list. The lists in the resulting
+		 * MusicBrainz5::CMetadata object keep their offset and count, but have no items.
+		 *
+		 * @param Callback Function called for each item, or 0 to add the items to their list
+		 * @param UserData User data passed to Callback
+		 */
+
+		void SetEntityCallback(tEntityCallback Callback, void *UserData=0);
+
+		/**
+		 * @brief Parse a chunk of the response
+		 *
+		 * Parse the next chunk of the response.
+		 *
+		 * @param Data Response data
+		 * @param Length Length of the response data
+		 * @param Terminate true if this is the last chunk of the response
+		 *
+		 * @return true if the response has been parsed without error so far
+		 */
+
+		bool ParseChunk(const char *Data, int Length, bool Terminate=false);
+
+		/**
+		 * @brief Return the error code
+		 *
+		 * Return the libxml2 error code of the first parse error
+		 *
+		 * @return Error code, or 0 if no error occurred
+		 */
+
+		int ErrorCode() const;
+
+		/**
+		 * @brief Return the error message
+		 *
+		 * Return the message for the first parse error
+		 *
+		 * @return Error message
+		 */
+
+		std::string ErrorMessage() const;
+
+	private:
+		CMetadataParser(const CMetadataParser& Other);
+		CMetadataParser& operator =(const CMetadataParser& Other);
+
+		CMetadataParserPrivate * const m_d;
+	};
+}
+
+#endif
@@ -45,6 +45,10 @@ namespace MusicBrainz5
 		CNameCredit(const XMLNode& Node=XMLNode::emptyNode());
 		CNameCredit(const CNameCredit& Other);
 		CNameCredit& operator =(const CNameCredit& Other);
+#if __cplusplus >= 201103L
+		CNameCredit(CNameCredit&& Other);
+		CNameCredit& operator =(CNameCredit&& Other);
+#endif
 		virtual ~CNameCredit();
 
 		virtual CNameCredit *Clone();
@@ -57,13 +61,13 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
 		void Cleanup();
 
-		CNameCreditPrivate * const m_d;
+		CNameCreditPrivate *m_d;
 	};
 }
 
@@ -0,0 +1,86 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_NAME_TABLE_
+#define _MUSICBRAINZ5_NAME_TABLE_
+
+namespace MusicBrainz5
+{
+	class CNameTablePrivate;
+
+	/**
+	 * @brief Perfect hash table of element and attribute names
+	 *
+	 * Maps a fixed set of names to values, for dispatching on the name of an XML element
+	 * or attribute without building a string from it or comparing it against each name
+	 * in turn.
+	 *
+	 * The table searches for a hash seed that gives each name a slot of its own when it
+	 * is constructed, so a lookup is one hash of the name and at most one string
+	 * comparison. Tables are normally static objects built from a static array of
+	 * entries, and may be used from multiple threads once constructed.
+	 */
+	class CNameTable
+	{
+	public:
+		class CEntry
+		{
+			public:
+				const char *m_Name;
+				int m_Value;
+		};
+
+		/**
+		 * @brief Constructor
+		 *
+		 * Constructor
+		 *
+		 * @param Entries Names and their values. The names must be distinct. The entries
+		 * are not copied, and must outlive the table.
+		 * @param NumEntries Number of entries
+		 */
+
+		CNameTable(const CEntry *Entries, int NumEntries);
+		~CNameTable();
+
+		/**
+		 * @brief Look up a name
+		 *
+		 * @param Name Name to look up
+		 *
+		 * @return Value of the name, or -1 if it is not in the table
+		 */
+
+		int Find(const char *Name) const;
+
+	private:
+		CNameTable(const CNameTable& Other);
+		CNameTable& operator =(const CNameTable& Other);
+
+		CNameTablePrivate * const m_d;
+	};
+}
+
+#endif
@@ -43,6 +43,10 @@ namespace MusicBrainz5
 		CNonMBTrack(const XMLNode& Node);
 		CNonMBTrack(const CNonMBTrack& Other);
 		CNonMBTrack& operator =(const CNonMBTrack& Other);
+#if __cplusplus >= 201103L
+		CNonMBTrack(CNonMBTrack&& Other);
+		CNonMBTrack& operator =(CNonMBTrack&& Other);
+#endif
 		virtual ~CNonMBTrack();
 
 		virtual CNonMBTrack *Clone();
@@ -55,11 +59,11 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CNonMBTrackPrivate * const m_d;
+		CNonMBTrackPrivate *m_d;
 	};
 }
 
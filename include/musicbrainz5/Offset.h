@@ -43,6 +43,10 @@ namespace MusicBrainz5
 		COffset(const XMLNode& Node=XMLNode::emptyNode());
 		COffset(const COffset& Other);
 		COffset& operator =(const COffset& Other);
+#if __cplusplus >= 201103L
+		COffset(COffset&& Other);
+		COffset& operator =(COffset&& Other);
+#endif
 		virtual ~COffset();
 
 		virtual COffset *Clone();
@@ -54,13 +58,13 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
 		void Cleanup();
 
-		COffsetPrivate * const m_d;
+		COffsetPrivate *m_d;
 	};
 }
 
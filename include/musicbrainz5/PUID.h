@@ -43,6 +43,10 @@ namespace MusicBrainz5
 		CPUID(const XMLNode& Node=XMLNode::emptyNode());
 		CPUID(const CPUID& Other);
 		CPUID& operator =(const CPUID& Other);
+#if __cplusplus >= 201103L
+		CPUID(CPUID&& Other);
+		CPUID& operator =(CPUID&& Other);
+#endif
 		virtual ~CPUID();
 
 		virtual CPUID *Clone();
@@ -54,13 +58,13 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
 		void Cleanup();
 
-		CPUIDPrivate * const m_d;
+		CPUIDPrivate *m_d;
 	};
 }
 
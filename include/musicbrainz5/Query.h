@@ -158,6 +158,11 @@ catch (MusicBrainz5::CResourceNotFoundError& Error)
 namespace MusicBrainz5
 {
 	class CQueryPrivate;
+	class CHTTPConnectionPool;
+	class CRateLimiter;
+	class CQueryCache;
+	class CDiskCache;
+	class CLookupResult;
 
 	/**
 	 * @brief Main object for generating queries to MusicBrainz
@@ -203,6 +208,58 @@ namespace MusicBrainz5
 			eQuery_ResourceNotFound
 		};
 
+		/**
+		 * @brief Enumerated type for the format of responses
+		 *
+		 * Enumerated type for the format of responses
+		 */
+		enum tWireFormat
+		{
+			eWireFormat_XML=0,
+			eWireFormat_JSON
+		};
+
+		/**
+		 * @brief Callback for asynchronous queries
+		 *
+		 * Function called when an asynchronous query completes. The callback is called
+		 * from a worker thread, or from the calling thread if no worker could be started.
+		 * It should not throw an exception, and any exception it does throw is discarded.
+		 *
+		 * @param Metadata Result of the query (empty if the query failed)
+		 * @param Result Result code of the query
+		 * @param ErrorMessage Error message if the query failed, as it would be returned
+		 * by MusicBrainz5::CQuery::LastErrorMessage
+		 * @param UserData User data passed to MusicBrainz5::CQuery::QueryAsync
+		 */
+		typedef void (*tQueryCallback)(const CMetadata& Metadata, tQueryResult Result, const std::string& ErrorMessage, void *UserData);
+
+		/**
+		 * @brief Callback for batch lookups
+		 *
+		 * Function called as each lookup in a batch completes, in the order they complete.
+		 * The callback is called from a worker thread, but calls for the same batch are
+		 * never made concurrently. It should not throw an exception, and any exception it
+		 * does throw is discarded.
+		 *
+		 * @param Result Result of the lookup
+		 * @param Index Position of the ID in the list passed to the batch lookup
+		 * @param UserData User data passed to the batch lookup
+		 */
+		typedef void (*tLookupCallback)(const CLookupResult& Result, int Index, void *UserData);
+
+		/**
+		 * @brief Callback for streamed queries
+		 *
+		 * Function called for each item in a list as soon as it has been parsed. The
+		 * item is freed once the callback returns. The callback must not throw an
+		 * exception.
+		 *
+		 * @param Entity Item that has been parsed (for example a MusicBrainz5::CRelease)
+		 * @param UserData User data passed to MusicBrainz5::CQuery::StreamQuery
+		 */
+		typedef void (*tEntityCallback)(const CEntity& Entity, void *UserData);
+
 		/**
 		 * @brief Constructor for MusicBrainz::CQuery object
 		 *
@@ -288,6 +345,169 @@ namespace MusicBrainz5
 
 		void SetProxyPassword(const std::string& ProxyPassword);
 
+		/**
+		 * @brief Set the connection pool
+		 *
+		 * Set the pool of persistent connections to use for queries. By default each
+		 * MusicBrainz5::CQuery object has its own pool. A pool may be shared by several
+		 * MusicBrainz5::CQuery objects, in which case it must outlive all of them.
+		 *
+		 * @param ConnectionPool Connection pool to use, or NULL to use the object's own pool
+		 */
+
+		void SetConnectionPool(CHTTPConnectionPool *ConnectionPool);
+
+		/**
+		 * @brief Return the connection pool
+		 *
+		 * Return the pool of persistent connections used for queries. This can be used
+		 * to configure the pool, or to retrieve connection reuse statistics.
+		 *
+		 * @return Connection pool in use
+		 */
+
+		CHTTPConnectionPool *ConnectionPool() const;
+
+		/**
+		 * @brief Set the rate limiter
+		 *
+		 * Set the rate limiter used to space out requests. By default all
+		 * MusicBrainz5::CQuery objects share MusicBrainz5::CRateLimiter::Default,
+		 * which limits requests to musicbrainz.org to one every two seconds. The
+		 * limiter must outlive the MusicBrainz5::CQuery object.
+		 *
+		 * @param RateLimiter Rate limiter to use, or NULL to use the default limiter
+		 */
+
+		void SetRateLimiter(CRateLimiter *RateLimiter);
+
+		/**
+		 * @brief Return the rate limiter
+		 *
+		 * Return the rate limiter used to space out requests. This can be used to
+		 * configure the limits for other hosts.
+		 *
+		 * @return Rate limiter in use
+		 */
+
+		CRateLimiter *RateLimiter() const;
+
+		/**
+		 * @brief Set the query cache
+		 *
+		 * Set a cache for the results of queries. Results found in the cache are
+		 * returned without contacting the server, and successful results are added
+		 * to it. By default no cache is used. A cache may be shared by several
+		 * MusicBrainz5::CQuery objects, in which case it must outlive all of them.
+		 *
+		 * @param Cache Cache to use, or NULL to disable caching
+		 */
+
+		void SetCache(CQueryCache *Cache);
+
+		/**
+		 * @brief Return the query cache
+		 *
+		 * Return the cache used for the results of queries
+		 *
+		 * @return Cache in use, or NULL if caching is disabled
+		 */
+
+		CQueryCache *Cache() const;
+
+		/**
+		 * @brief Set the disk cache
+		 *
+		 * Set a persistent cache for responses. It is consulted after the cache set
+		 * with MusicBrainz5::CQuery::SetCache, and responses found in it are added to
+		 * that cache. Queries made while a password is set do not use the disk cache.
+		 * By default no disk cache is used. The disk cache must outlive the
+		 * MusicBrainz5::CQuery object.
+		 *
+		 * @param DiskCache Disk cache to use, or NULL to disable it
+		 */
+
+		void SetDiskCache(CDiskCache *DiskCache);
+
+		/**
+		 * @brief Return the disk cache
+		 *
+		 * Return the persistent cache used for responses
+		 *
+		 * @return Disk cache in use, or NULL if it is disabled
+		 */
+
+		CDiskCache *DiskCache() const;
+
+		/**
+		 * @brief Use the streaming parser
+		 *
+		 * Build the results of queries with MusicBrainz5::CMetadataParser, which parses
+		 * the response as a stream instead of building a complete document tree first.
+		 * Each block of the response is parsed as soon as it is received, so parsing
+		 * overlaps the transfer and the response is never buffered. This also reduces
+		 * peak memory use for large list responses.
+		 *
+		 * @param StreamingParse true to use the streaming parser
+		 */
+
+		void SetStreamingParse(bool StreamingParse);
+
+		/**
+		 * @brief Enable compressed transfers
+		 *
+		 * Ask the server to send responses compressed with gzip or deflate. Responses
+		 * are decompressed as they are received. Disabled by default.
+		 *
+		 * @param Compression true to enable compressed transfers
+		 */
+
+		void SetCompression(bool Compression);
+
+		/**
+		 * @brief Enable arena allocation of results
+		 *
+		 * Build the entities in the results of queries from an arena owned by the
+		 * MusicBrainz5::CMetadata object returned (see MusicBrainz5::CMetadata::UseArena).
+		 * This saves a separate heap allocation for each entity, and frees them together.
+		 * Disabled by default.
+		 *
+		 * @param ArenaAllocation true to enable arena allocation
+		 */
+
+		void SetArenaAllocation(bool ArenaAllocation);
+
+		/**
+		 * @brief Return immutable results
+		 *
+		 * Make the entities in the results of queries immutable once they have been parsed
+		 * (see MusicBrainz5::CMetadata::SetImmutable). Copying a result, or any entity in
+		 * it, then shares the data instead of duplicating it, so results can be passed to
+		 * other threads or kept in caches cheaply. The results must not be modified.
+		 * Disabled by default.
+		 *
+		 * @param ImmutableResults true to return immutable results
+		 */
+
+		void SetImmutableResults(bool ImmutableResults);
+
+		/**
+		 * @brief Set the format of responses
+		 *
+		 * Ask the server for responses in XML (the default) or JSON. JSON responses are
+		 * smaller, and are converted into the same objects as XML responses, so the
+		 * results are used in the same way whichever format is chosen. Fields the server
+		 * only includes in one format are only available when using that format.
+		 *
+		 * JSON responses are parsed once they are complete, even with the streaming parser
+		 * enabled, and streamed queries (see MusicBrainz5::CQuery::StreamQuery) always use
+		 * XML.
+		 *
+		 * @param WireFormat Format of responses
+		 */
+
+		void SetWireFormat(tWireFormat WireFormat);
+
 		/**
 		 * @brief Return a list of releases that match a disc ID
 		 *
@@ -319,6 +539,87 @@ namespace MusicBrainz5
 
 		CRelease LookupRelease(const std::string& ReleaseID);
 
+		/**
+		 * @brief Look up a list of releases
+		 *
+		 * Look up a list of releases, making up to MusicBrainz5::CQuery::MaxAsyncWorkers
+		 * requests at once, subject to the rate limiter. Each lookup succeeds or fails
+		 * on its own, so this function does not throw. It returns once all the lookups
+		 * have completed. Must not be called from a query callback.
+		 *
+		 * The results are declared in musicbrainz5/LookupResult.h.
+		 *
+		 * @param ReleaseIDs MusicBrainz release IDs to look up
+		 * @param Params Parameters for the lookups (the includes used by
+		 *	MusicBrainz5::CQuery::LookupRelease if empty)
+		 * @param Callback Function called as each lookup completes (optional)
+		 * @param UserData User data passed to Callback
+		 *
+		 * @return Results of the lookups, in the same order as ReleaseIDs
+		 */
+
+		std::vector<CLookupResult> LookupReleases(const std::vector<std::string>& ReleaseIDs, const tParamMap& Params=tParamMap(), tLookupCallback Callback=0, void *UserData=0);
+
+		/**
+		 * @brief Look up a list of artists
+		 *
+		 * Look up a list of artists. See MusicBrainz5::CQuery::LookupReleases.
+		 *
+		 * @param ArtistIDs MusicBrainz artist IDs to look up
+		 * @param Params Parameters for the lookups
+		 * @param Callback Function called as each lookup completes (optional)
+		 * @param UserData User data passed to Callback
+		 *
+		 * @return Results of the lookups, in the same order as ArtistIDs
+		 */
+
+		std::vector<CLookupResult> LookupArtists(const std::vector<std::string>& ArtistIDs, const tParamMap& Params=tParamMap(), tLookupCallback Callback=0, void *UserData=0);
+
+		/**
+		 * @brief Look up a list of recordings
+		 *
+		 * Look up a list of recordings. See MusicBrainz5::CQuery::LookupReleases.
+		 *
+		 * @param RecordingIDs MusicBrainz recording IDs to look up
+		 * @param Params Parameters for the lookups
+		 * @param Callback Function called as each lookup completes (optional)
+		 * @param UserData User data passed to Callback
+		 *
+		 * @return Results of the lookups, in the same order as RecordingIDs
+		 */
+
+		std::vector<CLookupResult> LookupRecordings(const std::vector<std::string>& RecordingIDs, const tParamMap& Params=tParamMap(), tLookupCallback Callback=0, void *UserData=0);
+
+		/**
+		 * @brief Look up a list of labels
+		 *
+		 * Look up a list of labels. See MusicBrainz5::CQuery::LookupReleases.
+		 *
+		 * @param LabelIDs MusicBrainz label IDs to look up
+		 * @param Params Parameters for the lookups
+		 * @param Callback Function called as each lookup completes (optional)
+		 * @param UserData User data passed to Callback
+		 *
+		 * @return Results of the lookups, in the same order as LabelIDs
+		 */
+
+		std::vector<CLookupResult> LookupLabels(const std::vector<std::string>& LabelIDs, const tParamMap& Params=tParamMap(), tLookupCallback Callback=0, void *UserData=0);
+
+		/**
+		 * @brief Look up a list of works
+		 *
+		 * Look up a list of works. See MusicBrainz5::CQuery::LookupReleases.
+		 *
+		 * @param WorkIDs MusicBrainz work IDs to look up
+		 * @param Params Parameters for the lookups
+		 * @param Callback Function called as each lookup completes (optional)
+		 * @param UserData User data passed to Callback
+		 *
+		 * @return Results of the lookups, in the same order as WorkIDs
+		 */
+
+		std::vector<CLookupResult> LookupWorks(const std::vector<std::string>& WorkIDs, const tParamMap& Params=tParamMap(), tLookupCallback Callback=0, void *UserData=0);
+
 		/**
 		 * @brief Perform a generic query
 		 *
@@ -357,6 +658,88 @@ namespace MusicBrainz5
 
 		CMetadata Query(const std::string& Entity,const std::string& ID="",const std::string& Resource="",const tParamMap& Params=tParamMap());
 
+		/**
+		 * @brief Perform a generic query asynchronously
+		 *
+		 * Queue a generic query and return immediately. The query is performed by a pool
+		 * of worker threads, each of which reuses connections from the connection pool.
+		 * When the query completes, Callback is called from the worker thread. See
+		 * MusicBrainz5::CQuery::Query for details of the parameters.
+		 *
+		 * Each worker performs one request at a time, so at most
+		 * MusicBrainz5::CQuery::MaxAsyncWorkers queries are sent at once. Any further
+		 * queries wait in a queue until a worker is free.
+		 *
+		 * @param Entity Entity to lookup (e.g. artist, release, discid)
+		 * @param ID The MusicBrainz ID of the entity
+		 * @param Resource The resource (currently only used for collections)
+		 * @param Params Map of parameters to add to the query (e.g. inc)
+		 * @param Callback Function to call when the query completes
+		 * @param UserData User data to pass to the callback
+		 */
+
+		void QueryAsync(const std::string& Entity, const std::string& ID, const std::string& Resource, const tParamMap& Params, tQueryCallback Callback, void *UserData=0);
+
+		/**
+		 * @brief Perform a generic query, streaming the items in its list
+		 *
+		 * Perform a generic query, passing each item in the list it returns (for example
+		 * each release in a release search) to Callback as soon as it has been received
+		 * and parsed. Only one item is held in memory at a time, however long the list.
+		 * The lists in the returned object keep their offset and count, but have no items.
+		 *
+		 * Streamed queries are always sent to the server. They do not use or fill the
+		 * caches, and are not shared with other queries in progress. See
+		 * MusicBrainz5::CQuery::Query for details of the other parameters.
+		 *
+		 * @param Entity Entity to lookup (e.g. artist, release, discid)
+		 * @param ID The MusicBrainz ID of the entity
+		 * @param Resource The resource (currently only used for collections)
+		 * @param Params Map of parameters to add to the query (e.g. inc)
+		 * @param Callback Function to call for each item
+		 * @param UserData User data to pass to the callback
+		 *
+		 * @return MusicBrainz5::CMetadata object, with empty lists
+		 *
+		 * @throw CConnectionError An error occurred connecting to the web server
+		 * @throw CTimeoutError A timeout occurred when connecting to the web server
+		 * @throw CAuthenticationError An authentication error occurred
+		 * @throw CFetchError An error occurred fetching data
+		 * @throw CRequestError The request was invalid
+		 * @throw CResourceNotFoundError The requested resource was not found
+		 */
+
+		CMetadata StreamQuery(const std::string& Entity, const std::string& ID, const std::string& Resource, const tParamMap& Params, tEntityCallback Callback, void *UserData=0);
+
+		/**
+		 * @brief Wait for asynchronous queries
+		 *
+		 * Wait until all queries queued with MusicBrainz5::CQuery::QueryAsync have
+		 * completed, and their callbacks have returned.
+		 */
+
+		void WaitAsync();
+
+		/**
+		 * @brief Set the maximum number of worker threads
+		 *
+		 * Set the maximum number of worker threads (and so connections) used for
+		 * asynchronous queries, which is also the number of them that can be in progress
+		 * at once. The default is 4.
+		 *
+		 * @param MaxAsyncWorkers Maximum number of worker threads
+		 */
+
+		void SetMaxAsyncWorkers(int MaxAsyncWorkers);
+
+		/**
+		 * @brief Return the maximum number of worker threads
+		 *
+		 * @return Maximum number of worker threads used for asynchronous queries
+		 */
+
+		int MaxAsyncWorkers() const;
+
 		/**
 		 * @brief Add entries to the specified collection
 		 *
@@ -416,6 +799,37 @@ namespace MusicBrainz5
 		 */
 		int LastHTTPCode() const;
 
+		/**
+		 * @brief Return the number of bytes transferred by the last query
+		 *
+		 * Return the size of the response to the last query sent to the server, as it
+		 * was transferred
+		 *
+		 * @return Number of bytes transferred
+		 */
+		size_t LastWireBytes() const;
+
+		/**
+		 * @brief Return the number of bytes decoded by the last query
+		 *
+		 * Return the size of the response to the last query sent to the server, after
+		 * it was decompressed
+		 *
+		 * @return Number of bytes decoded
+		 */
+		size_t LastDecodedBytes() const;
+
+		/**
+		 * @brief Return the number of coalesced queries
+		 *
+		 * Return the number of queries that were answered by sharing the response to an
+		 * identical query that was already in progress, from this or any other
+		 * MusicBrainz5::CQuery object, instead of sending a request of their own
+		 *
+		 * @return Number of coalesced queries
+		 */
+		unsigned long CoalescedRequests() const;
+
 		/**
 		 * @brief Return error message from the last query
 		 *
@@ -435,9 +849,22 @@ namespace MusicBrainz5
 		std::string Version() const;
 
 	private:
+		friend class CSearchResultsBase;
+
 		CQueryPrivate * const m_d;
 
-		CMetadata PerformQuery(const std::string& Query);
+		CMetadata PerformQuery(const std::string& Query, bool Revalidate=false);
+		CMetadata ExecuteQuery(const std::string& Query, bool Revalidate, tQueryResult& Result, int& HTTPCode, std::string& ErrorMessage);
+		static void ThrowError(tQueryResult Result, const std::string& ErrorMessage);
+		std::string BuildQuery(const std::string& Entity, const std::string& ID, const std::string& Resource, const tParamMap& Params, bool Stream=false);
+		void SetLastResult(tQueryResult Result, int HTTPCode, const std::string& ErrorMessage);
+		void StartAsync(const std::string& Query, tQueryCallback Callback, void *UserData, bool Revalidate);
+		static void *AsyncWorker(void *UserData);
+		void RunAsync(const std::string& Query, tQueryCallback Callback, void *UserData, bool Revalidate);
+		std::vector<CLookupResult> LookupBatch(const std::string& Entity, const std::vector<std::string>& IDs, const tParamMap& Params, tLookupCallback Callback, void *UserData);
+		static void LookupCompleted(const CMetadata& Metadata, tQueryResult Result, const std::string& ErrorMessage, void *UserData);
+		static int ParseResponse(void *UserData, const char *Data, size_t Length);
+		bool ParseMetadata(const std::string& Query, const char *Data, size_t Length, CMetadata& Metadata) const;
 		void WaitRequest() const;
 		std::string UserAgent() const;
 		bool EditCollection(const std::string& CollectionID, const std::vector<std::string>& Entries, const std::string& Action);
@@ -0,0 +1,207 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_QUERY_CACHE_
+#define _MUSICBRAINZ5_QUERY_CACHE_
+
+#include <string>
+#include <vector>
+
+#include "musicbrainz5/Metadata.h"
+
+namespace MusicBrainz5
+{
+	class CQueryCachePrivate;
+
+	/**
+	 * @brief In-memory cache of query results
+	 *
+	 * Least recently used cache of web service responses, keyed on the server and
+	 * the canonical URL of the query. The cache holds either the raw response or
+	 * the parsed MusicBrainz5::CMetadata, and is bounded by the total size of the
+	 * responses it holds.
+	 *
+	 * Each entry expires after a time to live that may be set per entity type. An
+	 * expired entry is kept if the server sent an ETag or Last-Modified header with
+	 * it, and is then revalidated with a conditional request instead of fetched again.
+	 * Optionally, expired entries can be returned straight away while they are
+	 * revalidated in the background (stale-while-revalidate).
+	 *
+	 * A cache may be shared by several MusicBrainz5::CQuery objects, and may be used
+	 * from multiple threads.
+	 */
+	class CQueryCache
+	{
+	public:
+		enum tStorage
+		{
+			eStorage_Response=0,
+			eStorage_Metadata
+		};
+
+		/**
+		 * @brief Constructor
+		 *
+		 * Constructor
+		 *
+		 * @param Capacity Maximum total size in bytes of the responses held
+		 * @param Storage Whether to hold the raw responses, or the parsed results
+		 */
+
+		CQueryCache(size_t Capacity=16*1024*1024, tStorage Storage=eStorage_Response);
+		~CQueryCache();
+
+		/**
+		 * @brief Set the capacity
+		 *
+		 * Set the maximum total size in bytes of the responses held. Least recently
+		 * used entries are evicted to make room for new ones.
+		 *
+		 * @param Capacity Capacity in bytes
+		 */
+
+		void SetCapacity(size_t Capacity);
+
+		/**
+		 * @brief Set the default time to live
+		 *
+		 * Set the number of seconds an entry is kept for entity types that do not have
+		 * a time to live of their own. Defaults to one hour.
+		 *
+		 * @param TTL Time to live in seconds
+		 */
+
+		void SetDefaultTTL(int TTL);
+
+		/**
+		 * @brief Set the time to live for an entity type
+		 *
+		 * Set the number of seconds results for an entity type are kept. Results for
+		 * an entity type with a time to live of 0 are not cached.
+		 *
+		 * @param Entity Entity type (for example "release" or "artist")
+		 * @param TTL Time to live in seconds
+		 */
+
+		void SetTTL(const std::string& Entity, int TTL);
+
+		/**
+		 * @brief Set the stale-while-revalidate period
+		 *
+		 * Set the number of seconds after its time to live during which an entry is
+		 * still returned, while a request to revalidate it is made in the background.
+		 * Defaults to 0, which means expired entries are always revalidated before
+		 * they are returned.
+		 *
+		 * @param StaleWhileRevalidate Period in seconds
+		 */
+
+		void SetStaleWhileRevalidate(int StaleWhileRevalidate);
+
+		size_t Capacity() const;
+		tStorage Storage() const;
+		int DefaultTTL() const;
+		int StaleWhileRevalidate() const;
+		int TTL(const std::string& Entity) const;
+
+		/**
+		 * @brief Current size
+		 *
+		 * @return Total size in bytes of the responses currently held
+		 */
+
+		size_t Size() const;
+
+		/**
+		 * @brief Number of entries
+		 *
+		 * @return Number of entries currently held
+		 */
+
+		size_t Count() const;
+
+		/**
+		 * @brief Number of cache hits
+		 *
+		 * @return Number of queries answered from the cache
+		 */
+
+		unsigned long Hits() const;
+
+		/**
+		 * @brief Number of cache misses
+		 *
+		 * @return Number of queries not found in the cache
+		 */
+
+		unsigned long Misses() const;
+
+		/**
+		 * @brief Number of evictions
+		 *
+		 * @return Number of entries removed to make room for new ones
+		 */
+
+		unsigned long Evictions() const;
+
+		/**
+		 * @brief Number of revalidations
+		 *
+		 * @return Number of expired entries the server confirmed were unchanged
+		 */
+
+		unsigned long Revalidations() const;
+
+		/**
+		 * @brief Remove all entries
+		 *
+		 * Remove all entries from the cache. The counters are not reset.
+		 */
+
+		void Clear();
+
+	private:
+		friend class CQuery;
+
+		CQueryCache(const CQueryCache& Other);
+		CQueryCache& operator =(const CQueryCache& Other);
+
+		enum tFindResult
+		{
+			eFind_Miss=0,
+			eFind_Fresh,
+			eFind_Stale,
+			eFind_Expired
+		};
+
+		tFindResult Find(const std::string& Key, std::vector<unsigned char>& Data, CMetadata& Metadata, std::string& ETag, std::string& LastModified);
+		void Store(const std::string& Key, const std::string& Entity, const unsigned char *Data, size_t Length, const CMetadata& Metadata, const std::string& ETag, const std::string& LastModified);
+		void Refresh(const std::string& Key, const std::string& Entity);
+
+		CQueryCachePrivate * const m_d;
+	};
+}
+
+#endif
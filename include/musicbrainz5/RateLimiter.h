@@ -0,0 +1,155 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_RATE_LIMITER_
+#define _MUSICBRAINZ5_RATE_LIMITER_
+
+#include <string>
+
+namespace MusicBrainz5
+{
+	class CRateLimiterPrivate;
+
+	/**
+	 * @brief Limit the rate of requests to web servers
+	 *
+	 * Token bucket rate limiter, configured per host. Each host has a rate (the number
+	 * of requests per second) and a burst size (the number of requests that may be
+	 * made without waiting after a period of inactivity).
+	 *
+	 * A request is assigned the next free slot as soon as it asks for one, and the
+	 * calling thread sleeps until exactly that time, so requests are served in order
+	 * and without polling.
+	 *
+	 * A limiter may be shared by several MusicBrainz5::CQuery objects, and may be used
+	 * from multiple threads. A limiter created with a shared memory name keeps its
+	 * state in a POSIX shared memory segment, so that all processes on a machine that
+	 * use the same name share a single budget.
+	 */
+	class CRateLimiter
+	{
+	public:
+		CRateLimiter();
+
+		/**
+		 * @brief Constructor for a limiter shared between processes
+		 *
+		 * Create a limiter whose state is kept in the named POSIX shared memory segment,
+		 * which is created if it does not exist. Limits set through any limiter attached
+		 * to the segment apply to all of them. If the segment cannot be used, the limiter
+		 * only applies to the current process (see MusicBrainz5::CRateLimiter::Shared).
+		 *
+		 * @param SharedName Name of the shared memory segment (for example "/musicbrainz5")
+		 */
+
+		explicit CRateLimiter(const std::string& SharedName);
+		~CRateLimiter();
+
+		/**
+		 * @brief Return the default rate limiter
+		 *
+		 * Return the rate limiter used by all MusicBrainz5::CQuery objects unless
+		 * another one is set. It limits requests to musicbrainz.org (and its sub-domains)
+		 * to one every two seconds.
+		 *
+		 * @return Default rate limiter
+		 */
+
+		static CRateLimiter& Default();
+
+		/**
+		 * @brief Check whether the limiter is shared between processes
+		 *
+		 * A shared limiter carries on with a private copy of its state if the lock on
+		 * the shared memory segment becomes unusable.
+		 *
+		 * @return true if the limiter state is kept in shared memory
+		 */
+
+		bool Shared() const;
+
+		/**
+		 * @brief Set the rate for a host
+		 *
+		 * Set the rate limit for requests to a host. The limit also applies to all
+		 * sub-domains of the host, unless they have a limit of their own.
+		 *
+		 * @param Host Host to limit
+		 * @param Rate Maximum number of requests per second
+		 * @param Burst Number of requests that may be made without waiting
+		 *
+		 * @return true if the rate was set, false if no more hosts can be stored in
+		 * the shared memory segment
+		 */
+
+		bool SetRate(const std::string& Host, double Rate, int Burst=1);
+
+		/**
+		 * @brief Remove the rate limit for a host
+		 *
+		 * Remove the rate limit for requests to a host
+		 *
+		 * @param Host Host to remove the limit for
+		 */
+
+		void RemoveRate(const std::string& Host);
+
+		/**
+		 * @brief Wait until a request may be made
+		 *
+		 * Wait until a request to the host is allowed by its rate limit. Returns
+		 * immediately if the host is not limited.
+		 *
+		 * @param Host Host the request will be sent to
+		 *
+		 * @return Number of seconds waited
+		 */
+
+		double Wait(const std::string& Host);
+
+		/**
+		 * @brief Return statistics for a host
+		 *
+		 * Return the current state of the rate limit that applies to a host
+		 *
+		 * @param Host Host to return the statistics for
+		 * @param Tokens Number of requests that could currently be made without waiting
+		 * @param WaitTime Total number of seconds requests have spent waiting
+		 * @param Requests Total number of requests made
+		 *
+		 * @return true if the host is rate limited, false otherwise
+		 */
+
+		bool Stats(const std::string& Host, double& Tokens, double& WaitTime, unsigned long& Requests) const;
+
+	private:
+		CRateLimiter(const CRateLimiter& Other);
+		CRateLimiter& operator =(const CRateLimiter& Other);
+
+		CRateLimiterPrivate * const m_d;
+	};
+}
+
+#endif
@@ -42,6 +42,10 @@ namespace MusicBrainz5
 		CRating(const XMLNode& Node=XMLNode::emptyNode());
 		CRating(const CRating& Other);
 		CRating& operator =(const CRating& Other);
+#if __cplusplus >= 201103L
+		CRating(CRating&& Other);
+		CRating& operator =(CRating&& Other);
+#endif
 		virtual ~CRating();
 
 		virtual CRating *Clone();
@@ -53,11 +57,11 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CRatingPrivate * const m_d;
+		CRatingPrivate *m_d;
 	};
 }
 
@@ -58,6 +58,10 @@ namespace MusicBrainz5
 		CRecording(const XMLNode& Node=XMLNode::emptyNode());
 		CRecording(const CRecording& Other);
 		CRecording& operator =(const CRecording& Other);
+#if __cplusplus >= 201103L
+		CRecording(CRecording&& Other);
+		CRecording& operator =(CRecording&& Other);
+#endif
 		virtual ~CRecording();
 
 		virtual CRecording *Clone();
@@ -80,13 +84,13 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
 		void Cleanup();
 
-		CRecordingPrivate * const m_d;
+		CRecordingPrivate *m_d;
 	};
 }
 
@@ -51,6 +51,10 @@ namespace MusicBrainz5
 		CRelation(const XMLNode& Node=XMLNode::emptyNode());
 		CRelation(const CRelation& Other);
 		CRelation& operator =(const CRelation& Other);
+#if __cplusplus >= 201103L
+		CRelation(CRelation&& Other);
+		CRelation& operator =(CRelation&& Other);
+#endif
 		virtual ~CRelation();
 
 		virtual CRelation *Clone();
@@ -69,17 +73,28 @@ namespace MusicBrainz5
 		CLabel *Label() const;
 		CWork *Work() const;
 
+		/**
+		 * @brief Pooled field values
+		 *
+		 * The same values as the accessors of the same name, as the pooled strings held by
+		 * the entity. These can be compared by address with MusicBrainz5::CStringPool::Intern,
+		 * instead of comparing the strings.
+		 */
+
+		const std::string *InternedType() const;
+		const std::string *InternedDirection() const;
+
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
 		void Cleanup();
 
-		CRelationPrivate * const m_d;
+		CRelationPrivate *m_d;
 	};
 }
 
@@ -44,21 +44,35 @@ namespace MusicBrainz5
 		CRelationList(const XMLNode& Node);
 		CRelationList(const CRelationList& Other);
 		CRelationList& operator =(const CRelationList& Other);
+#if __cplusplus >= 201103L
+		CRelationList(CRelationList&& Other);
+		CRelationList& operator =(CRelationList&& Other);
+#endif
 		virtual ~CRelationList();
 
 		virtual CRelationList *Clone();
 
 		std::string TargetType() const;
 
+		/**
+		 * @brief Pooled target type
+		 *
+		 * The same value as MusicBrainz5::CRelationList::TargetType, as the pooled string held by the
+		 * entity. It can be compared by address with MusicBrainz5::CStringPool::Intern,
+		 * instead of comparing the strings.
+		 */
+
+		const std::string *InternedTargetType() const;
+
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CRelationListPrivate * const m_d;
+		CRelationListPrivate *m_d;
 	};
 }
 
@@ -42,6 +42,10 @@ namespace MusicBrainz5
 		CRelationListList();
 		CRelationListList(const CRelationListList& Other);
 		CRelationListList& operator =(const CRelationListList& Other);
+#if __cplusplus >= 201103L
+		CRelationListList(CRelationListList&& Other);
+		CRelationListList& operator =(CRelationListList&& Other);
+#endif
 		virtual ~CRelationListList();
 
 		void Add(CRelationList *RelationList);
@@ -55,7 +59,7 @@ namespace MusicBrainz5
 	private:
 		void Cleanup();
 
-		CRelationListListPrivate * const m_d;
+		CRelationListListPrivate *m_d;
 	};
 }
 
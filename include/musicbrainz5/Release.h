@@ -52,6 +52,10 @@ namespace MusicBrainz5
 		CRelease(const XMLNode& Node=XMLNode::emptyNode());
 		CRelease(const CRelease& Other);
 		CRelease& operator =(const CRelease& Other);
+#if __cplusplus >= 201103L
+		CRelease(CRelease&& Other);
+		CRelease& operator =(CRelease&& Other);
+#endif
 		virtual ~CRelease();
 
 		virtual CRelease *Clone();
@@ -76,17 +80,30 @@ namespace MusicBrainz5
 
 		CMediumList MediaMatchingDiscID(const std::string& DiscID) const;
 
+		/**
+		 * @brief Pooled field values
+		 *
+		 * The same values as the accessors of the same name, as the pooled strings held by
+		 * the entity. These can be compared by address with MusicBrainz5::CStringPool::Intern,
+		 * instead of comparing the strings.
+		 */
+
+		const std::string *InternedStatus() const;
+		const std::string *InternedQuality() const;
+		const std::string *InternedPackaging() const;
+		const std::string *InternedCountry() const;
+
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
 		void Cleanup();
 
-		CReleasePrivate * const m_d;
+		CReleasePrivate *m_d;
 	};
 }
 
@@ -53,6 +53,10 @@ namespace MusicBrainz5
 		CReleaseGroup(const XMLNode& Node=XMLNode::emptyNode());
 		CReleaseGroup(const CReleaseGroup& Other);
 		CReleaseGroup& operator =(const CReleaseGroup& Other);
+#if __cplusplus >= 201103L
+		CReleaseGroup(CReleaseGroup&& Other);
+		CReleaseGroup& operator =(CReleaseGroup&& Other);
+#endif
 		virtual ~CReleaseGroup();
 
 		virtual CReleaseGroup *Clone();
@@ -75,13 +79,13 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
 		void Cleanup();
 
-		CReleaseGroupPrivate * const m_d;
+		CReleaseGroupPrivate *m_d;
 	};
 }
 
@@ -0,0 +1,217 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_SEARCH_RESULTS_
+#define _MUSICBRAINZ5_SEARCH_RESULTS_
+
+#include <string>
+
+#include "musicbrainz5/Query.h"
+#include "musicbrainz5/Metadata.h"
+#include "musicbrainz5/ListImpl.h"
+
+namespace MusicBrainz5
+{
+	class CSearchResultsBasePrivate;
+
+	/**
+	 * @brief Pages of search or browse results
+	 *
+	 * Fetches the pages of a search or browse query in turn, requesting the following
+	 * pages in the background while the current one is being used. Use
+	 * MusicBrainz5::CSearchResults rather than this class directly.
+	 */
+	class CSearchResultsBase
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * Constructor. No request is made until the first page is needed.
+		 *
+		 * @param Query Query object used to make the requests. The pages are fetched by its
+		 *	asynchronous workers, so it must outlive this object.
+		 * @param Entity Entity to search or browse
+		 * @param Params Parameters for the query, not including limit and offset
+		 * @param PageSize Number of results to request per page (at most 100)
+		 * @param Prefetch Number of pages to request ahead of the one being used
+		 */
+
+		CSearchResultsBase(CQuery& Query, const std::string& Entity, const CQuery::tParamMap& Params, int PageSize, int Prefetch);
+		virtual ~CSearchResultsBase();
+
+		/**
+		 * @brief Total number of results
+		 *
+		 * Return the total number of results reported by the server. This is only known once
+		 * the first page has been fetched.
+		 *
+		 * @return Total number of results, or -1 if not yet known
+		 */
+
+		int Count() const;
+
+		int PageSize() const;
+		int Prefetch() const;
+
+	protected:
+		/**
+		 * @brief Fetch the next page
+		 *
+		 * Return the next page of results, waiting for it to arrive if necessary. The
+		 * previous page is freed. If the page could not be fetched, the next call
+		 * requests it again.
+		 *
+		 * @throw CConnectionError An error occurred connecting to the web service
+		 * @throw CTimeoutError A timeout occurred when connecting to the web service
+		 * @throw CAuthenticationError An authentication error occurred
+		 * @throw CFetchError An error occurred fetching data
+		 * @throw CRequestError The request was invalid
+		 * @throw CResourceNotFoundError The requested resource was not found
+		 *
+		 * @return List in the next page of results, or 0 if there are no more results
+		 */
+
+		CList *NextPage();
+
+	private:
+		CSearchResultsBase(const CSearchResultsBase& Other);
+		CSearchResultsBase& operator =(const CSearchResultsBase& Other);
+
+		void RequestPages();
+		void RequestPage(int PageNum);
+		CList *PageList(const CMetadata& Metadata) const;
+		static void PageCompleted(const CMetadata& Metadata, CQuery::tQueryResult Result, const std::string& ErrorMessage, void *UserData);
+
+		CSearchResultsBasePrivate * const m_d;
+	};
+
+	/**
+	 * @brief Iterator over search or browse results
+	 *
+	 * Returns each result of a search or browse query in turn, across as many pages as
+	 * needed. For example:
+	 *
+	 * @code
+	 * MusicBrainz5::CSearchResults<MusicBrainz5::CRelease> Results(Query,"release:Bleach");
+	 *
+	 * while (MusicBrainz5::CRelease *Release=Results.Next())
+	 *	std::cout << Release->Title() << std::endl;
+	 * @endcode
+	 *
+	 * T may be any entity that can be searched or browsed, such as MusicBrainz5::CArtist,
+	 * MusicBrainz5::CRelease, MusicBrainz5::CReleaseGroup, MusicBrainz5::CRecording,
+	 * MusicBrainz5::CLabel or MusicBrainz5::CWork.
+	 */
+	template <class T>
+	class CSearchResults: public CSearchResultsBase
+	{
+	public:
+		/**
+		 * @brief Constructor for a search
+		 *
+		 * Constructor for a search
+		 *
+		 * @param Query Query object used to make the requests
+		 * @param Search Lucene search query
+		 * @param PageSize Number of results to request per page (at most 100)
+		 * @param Prefetch Number of pages to request ahead of the one being used
+		 */
+
+		CSearchResults(CQuery& Query, const std::string& Search, int PageSize=100, int Prefetch=2)
+		:	CSearchResultsBase(Query,T::GetElementName(),SearchParams(Search),PageSize,Prefetch),
+			m_List(0),
+			m_Item(0)
+		{
+		}
+
+		/**
+		 * @brief Constructor for a search or browse
+		 *
+		 * Constructor for a search or browse with arbitrary parameters, for example
+		 * "artist" and "inc" to browse the releases of an artist
+		 *
+		 * @param Query Query object used to make the requests
+		 * @param Params Parameters for the query, not including limit and offset
+		 * @param PageSize Number of results to request per page (at most 100)
+		 * @param Prefetch Number of pages to request ahead of the one being used
+		 */
+
+		CSearchResults(CQuery& Query, const CQuery::tParamMap& Params, int PageSize=100, int Prefetch=2)
+		:	CSearchResultsBase(Query,T::GetElementName(),Params,PageSize,Prefetch),
+			m_List(0),
+			m_Item(0)
+		{
+		}
+
+		/**
+		 * @brief Return the next result
+		 *
+		 * Return the next result, fetching the next page if necessary. The result remains
+		 * valid until the first call to Next that moves on to a new page. If the page
+		 * could not be fetched, the next call requests it again.
+		 *
+		 * @throw CConnectionError An error occurred connecting to the web service
+		 * @throw CTimeoutError A timeout occurred when connecting to the web service
+		 * @throw CAuthenticationError An authentication error occurred
+		 * @throw CFetchError An error occurred fetching data
+		 * @throw CRequestError The request was invalid
+		 * @throw CResourceNotFoundError The requested resource was not found
+		 *
+		 * @return Next result, or 0 if there are no more results
+		 */
+
+		T *Next()
+		{
+			while (!m_List || m_Item>=m_List->NumItems())
+			{
+				// The current list is freed by NextPage, even if it throws
+
+				m_List=0;
+				m_List=dynamic_cast<CListImpl<T> *>(NextPage());
+				m_Item=0;
+
+				if (!m_List)
+					return 0;
+			}
+
+			return m_List->Item(m_Item++);
+		}
+
+	private:
+		static CQuery::tParamMap SearchParams(const std::string& Search)
+		{
+			CQuery::tParamMap Params;
+			Params["query"]=Search;
+
+			return Params;
+		}
+
+		CListImpl<T> *m_List;
+		int m_Item;
+	};
+}
+
+#endif
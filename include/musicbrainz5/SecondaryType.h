@@ -43,6 +43,10 @@ namespace MusicBrainz5
 		CSecondaryType(const XMLNode& Node=XMLNode::emptyNode());
 		CSecondaryType(const CSecondaryType& Other);
 		CSecondaryType& operator =(const CSecondaryType& Other);
+#if __cplusplus >= 201103L
+		CSecondaryType(CSecondaryType&& Other);
+		CSecondaryType& operator =(CSecondaryType&& Other);
+#endif
 		virtual ~CSecondaryType();
 
 		virtual CSecondaryType *Clone();
@@ -53,13 +57,13 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
 		void Cleanup();
 
-		CSecondaryTypePrivate * const m_d;
+		CSecondaryTypePrivate *m_d;
 	};
 }
 
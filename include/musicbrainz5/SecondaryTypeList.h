@@ -44,6 +44,10 @@ namespace MusicBrainz5
 		CSecondaryTypeList(const XMLNode& Node=XMLNode::emptyNode());
 		CSecondaryTypeList(const CSecondaryTypeList& Other);
 		CSecondaryTypeList& operator =(const CSecondaryTypeList& Other);
+#if __cplusplus >= 201103L
+		CSecondaryTypeList(CSecondaryTypeList&& Other);
+		CSecondaryTypeList& operator =(CSecondaryTypeList&& Other);
+#endif
 		virtual ~CSecondaryTypeList();
 
 		virtual CSecondaryTypeList *Clone();
@@ -52,11 +56,11 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CSecondaryTypeListPrivate * const m_d;
+		CSecondaryTypeListPrivate *m_d;
 	};
 }
 
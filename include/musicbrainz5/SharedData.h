@@ -0,0 +1,197 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_SHARED_DATA_
+#define _MUSICBRAINZ5_SHARED_DATA_
+
+#include "musicbrainz5/Arena.h"
+
+namespace MusicBrainz5
+{
+	/**
+	 * @brief Reference counted entity data
+	 *
+	 * Base class for the private data of entities. Data created while a
+	 * MusicBrainz5::CImmutableScope is active on the calling thread is immutable, and
+	 * copying an entity that holds immutable data takes another reference to it instead
+	 * of copying it and everything below it. The data is freed when the last entity
+	 * referring to it is destroyed.
+	 *
+	 * Reference counts are updated atomically, so entities sharing data may be copied
+	 * and destroyed from different threads. Immutable data must not be modified once it
+	 * has been parsed.
+	 */
+	class CSharedData: public CArenaObject
+	{
+	public:
+		CSharedData();
+
+		/**
+		 * @brief Whether the data is immutable
+		 *
+		 * @return true if copies of the entity share this data
+		 */
+
+		bool Immutable() const;
+
+		/**
+		 * @brief Whether the data is shared
+		 *
+		 * @return true if more than one entity refers to this data
+		 */
+
+		bool Shared() const;
+
+		void SetImmutable(bool Immutable);
+		void AddReference();
+
+		/**
+		 * @brief Remove a reference
+		 *
+		 * @return true if this was the last reference, and the data should be freed
+		 */
+
+		bool RemoveReference();
+
+		/**
+		 * @brief Share data with another entity
+		 *
+		 * If OtherData is immutable, free Data and replace it with a reference to OtherData.
+		 * Data must not be shared, and must not refer to any other entities. Data from an
+		 * arena is only shared with entities allocated from the same arena.
+		 *
+		 * @param Data Data to replace
+		 * @param OtherData Data to share
+		 *
+		 * @return true if the data is now shared, false if it must be copied
+		 */
+
+		template <class T>
+		static bool Share(T*& Data, T *OtherData)
+		{
+			bool Ret=false;
+
+			if (OtherData->Immutable() && CArena::Owner(Data)==CArena::Owner(OtherData))
+			{
+				OtherData->AddReference();
+
+				delete Data;
+				Data=OtherData;
+
+				Ret=true;
+			}
+
+			return Ret;
+		}
+
+		/**
+		 * @brief Whether data may be taken over by a move
+		 *
+		 * Immutable data may be referred to by other entities, either directly or through
+		 * the data of an entity that contains it, so moving from it would change their
+		 * contents too. It is shared (or copied) instead. Data from an arena is only taken
+		 * over by entities allocated from the same arena.
+		 *
+		 * @param Data Data of the entity being moved to
+		 * @param OtherData Data of the entity being moved from
+		 *
+		 * @return true if Data and OtherData may be swapped
+		 */
+
+		template <class T>
+		static bool CanMove(T *Data, T *OtherData)
+		{
+			return !OtherData->Immutable() && CArena::Owner(Data)==CArena::Owner(OtherData);
+		}
+
+		/**
+		 * @brief Stop sharing data
+		 *
+		 * If Data is shared with other entities, remove a reference to it and replace it with
+		 * new data that can be modified.
+		 *
+		 * @param Data Data to replace
+		 *
+		 * @return true if Data was replaced, false if it was not shared and may still refer
+		 * to other entities
+		 */
+
+		template <class T>
+		static bool Unshare(T*& Data)
+		{
+			bool Ret=false;
+
+			if (Data->Shared())
+			{
+				if (Data->RemoveReference())
+				{
+					// The other references went away in the meantime
+
+					Data->AddReference();
+				}
+				else
+				{
+					Data=new T;
+					Ret=true;
+				}
+			}
+
+			return Ret;
+		}
+
+	private:
+		friend class CImmutableScope;
+
+		CSharedData(const CSharedData& Other);
+		CSharedData& operator =(const CSharedData& Other);
+
+		static bool CreateImmutable();
+		static void SetCreateImmutable(bool Immutable);
+
+		int m_References;
+		bool m_Immutable;
+	};
+
+	/**
+	 * @brief Create immutable entity data
+	 *
+	 * Makes entity data created on the calling thread immutable (or not) for the lifetime
+	 * of the scope object, restoring the previous setting afterwards.
+	 */
+	class CImmutableScope
+	{
+	public:
+		CImmutableScope(bool Immutable);
+		~CImmutableScope();
+
+	private:
+		CImmutableScope(const CImmutableScope& Other);
+		CImmutableScope& operator =(const CImmutableScope& Other);
+
+		bool m_Previous;
+	};
+}
+
+#endif
@@ -0,0 +1,81 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_STRING_POOL_
+#define _MUSICBRAINZ5_STRING_POOL_
+
+#include <string>
+#include <cstddef>
+
+namespace MusicBrainz5
+{
+	/**
+	 * @brief Process-wide pool of interned strings
+	 *
+	 * Entity fields that only ever hold one of a small set of values (such as a release's
+	 * status or a medium's format) store a pointer to a single shared copy of each value
+	 * instead of a string of their own. Interning the same value twice returns the same
+	 * pointer, so interned strings can be compared by address. The entities return their
+	 * pooled values from accessors such as MusicBrainz5::CRelease::InternedStatus, so that
+	 * for example official releases can be picked out with
+	 * Release->InternedStatus()==CStringPool::Intern("Official").
+	 *
+	 * Interned strings are never freed. The pool may be used from multiple threads.
+	 */
+	class CStringPool
+	{
+	public:
+		/**
+		 * @brief Intern a string
+		 *
+		 * @param String String to intern
+		 *
+		 * @return Pooled copy of the string
+		 */
+
+		static const std::string *Intern(const std::string& String);
+
+		/**
+		 * @brief Pooled empty string
+		 *
+		 * @return Pooled copy of the empty string
+		 */
+
+		static const std::string *Empty();
+
+		/**
+		 * @brief Number of interned strings
+		 *
+		 * @return Number of distinct strings in the pool
+		 */
+
+		static size_t Size();
+
+	private:
+		CStringPool();
+	};
+}
+
+#endif
@@ -43,6 +43,10 @@ namespace MusicBrainz5
 		CTag(const XMLNode& Node);
 		CTag(const CTag& Other);
 		CTag& operator =(const CTag& Other);
+#if __cplusplus >= 201103L
+		CTag(CTag&& Other);
+		CTag& operator =(CTag&& Other);
+#endif
 		virtual ~CTag();
 
 		virtual CTag *Clone();
@@ -54,11 +58,11 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CTagPrivate * const m_d;
+		CTagPrivate *m_d;
 	};
 }
 
@@ -43,6 +43,10 @@ namespace MusicBrainz5
 		CTextRepresentation(const XMLNode& Node=XMLNode::emptyNode());
 		CTextRepresentation(const CTextRepresentation& Other);
 		CTextRepresentation& operator =(const CTextRepresentation& Other);
+#if __cplusplus >= 201103L
+		CTextRepresentation(CTextRepresentation&& Other);
+		CTextRepresentation& operator =(CTextRepresentation&& Other);
+#endif
 		virtual ~CTextRepresentation();
 
 		virtual CTextRepresentation *Clone();
@@ -54,11 +58,11 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CTextRepresentationPrivate * const m_d;
+		CTextRepresentationPrivate *m_d;
 	};
 }
 
@@ -46,6 +46,10 @@ namespace MusicBrainz5
 		CTrack(const XMLNode& Node=XMLNode::emptyNode());
 		CTrack(const CTrack& Other);
 		CTrack& operator =(const CTrack& Other);
+#if __cplusplus >= 201103L
+		CTrack(CTrack&& Other);
+		CTrack& operator =(CTrack&& Other);
+#endif
 		virtual ~CTrack();
 
 		virtual CTrack *Clone();
@@ -61,13 +65,13 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
 		void Cleanup();
 
-		CTrackPrivate * const m_d;
+		CTrackPrivate *m_d;
 	};
 }
 
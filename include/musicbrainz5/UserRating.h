@@ -42,6 +42,10 @@ namespace MusicBrainz5
 		CUserRating(const XMLNode& Node);
 		CUserRating(const CUserRating& Other);
 		CUserRating& operator =(const CUserRating& Other);
+#if __cplusplus >= 201103L
+		CUserRating(CUserRating&& Other);
+		CUserRating& operator =(CUserRating&& Other);
+#endif
 		virtual ~CUserRating();
 
 		virtual CUserRating *Clone();
@@ -52,11 +56,11 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CUserRatingPrivate * const m_d;
+		CUserRatingPrivate *m_d;
 	};
 }
 
@@ -43,6 +43,10 @@ namespace MusicBrainz5
 		CUserTag(const XMLNode& Node);
 		CUserTag(const CUserTag& Other);
 		CUserTag& operator =(const CUserTag& Other);
+#if __cplusplus >= 201103L
+		CUserTag(CUserTag&& Other);
+		CUserTag& operator =(CUserTag&& Other);
+#endif
 		virtual ~CUserTag();
 
 		virtual CUserTag *Clone();
@@ -53,11 +57,11 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CUserTagPrivate * const m_d;
+		CUserTagPrivate *m_d;
 	};
 }
 
@@ -52,6 +52,10 @@ namespace MusicBrainz5
 		CWork(const XMLNode& Node=XMLNode::emptyNode());
 		CWork(const CWork& Other);
 		CWork& operator =(const CWork& Other);
+#if __cplusplus >= 201103L
+		CWork(CWork&& Other);
+		CWork& operator =(CWork&& Other);
+#endif
 		virtual ~CWork();
 
 		virtual CWork *Clone();
@@ -74,13 +78,13 @@ namespace MusicBrainz5
 		static std::string GetElementName();
 
 	protected:
-		virtual void ParseAttribute(const std::string& Name, const std::string& Value);
+		virtual void ParseAttribute(const char *Name, const char *Value);
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
 		void Cleanup();
 
-		CWorkPrivate * const m_d;
+		CWorkPrivate *m_d;
 	};
 }
 
@@ -26,6 +26,7 @@
 #define _MUSICBRAINZ5_XMLPARSER_H
 
 #include <string>
+#include <vector>
 
 struct _xmlNode;
 typedef _xmlNode* xmlNodePtr;
@@ -36,6 +37,9 @@ typedef _xmlDoc* xmlDocPtr;
 struct _xmlAttr;
 typedef _xmlAttr* xmlAttrPtr;
 
+struct _xmlParserCtxt;
+typedef _xmlParserCtxt* xmlParserCtxtPtr;
+
 struct XMLResults
 {
     std::string message;
@@ -64,11 +68,19 @@ class XMLNode
         const char *getName() const;
         const char *getText() const;
 
+        /* Namespace prefix of the element, or NULL if it has none */
+        const char *getPrefix() const;
+
         bool operator ==(const XMLNode &rhs) const;
 
+        void *getUserData() const;
+        void setUserData(void *data) const;
+
     protected:
         XMLNode(xmlNodePtr node);
 
+        friend class XMLStreamParser;
+
         xmlNodePtr mNode;
 
     private:
@@ -82,6 +94,11 @@ class XMLRootNode: public XMLNode
     public:
         static XMLNode* parseString(const std::string &xml, XMLResults *results);
         static XMLNode* parseFile(const std::string &filename, XMLResults *results);
+        static XMLNode* parseBuffer(const char *buffer, int length, XMLResults *results);
+
+        /* Wrap a document built by other means. The document is freed
+         * with the returned node. */
+        static XMLNode* fromDocument(xmlDocPtr doc);
 
         virtual ~XMLRootNode();
 
@@ -91,6 +108,55 @@ class XMLRootNode: public XMLNode
         xmlDocPtr mDoc;
 };
 
+class XMLStreamHandler
+{
+    public:
+        virtual ~XMLStreamHandler();
+
+        /* Called with the element's attributes only, before any of its
+         * children have been read. Return true to have each child
+         * reported separately, false to have the whole element
+         * reported through element() once it is complete. */
+        virtual bool startElement(const XMLNode &node, int depth) = 0;
+
+        /* A complete element, freed as soon as this returns */
+        virtual void element(const XMLNode &node, int depth) = 0;
+
+        /* End of an element for which startElement() returned true */
+        virtual void endElement(const XMLNode &node, int depth) = 0;
+};
+
+class XMLStreamParser
+{
+    public:
+        XMLStreamParser(XMLStreamHandler *handler);
+        ~XMLStreamParser();
+
+        bool parseChunk(const char *data, int length, bool terminate);
+        const XMLResults &results() const;
+
+    private:
+        XMLStreamParser(const XMLStreamParser &other);
+        XMLStreamParser &operator =(const XMLStreamParser &other);
+
+        static void onStartElement(void *ctx, const unsigned char *localname,
+                                   const unsigned char *prefix, const unsigned char *URI,
+                                   int nb_namespaces, const unsigned char **namespaces,
+                                   int nb_attributes, int nb_defaulted,
+                                   const unsigned char **attributes);
+        static void onEndElement(void *ctx, const unsigned char *localname,
+                                 const unsigned char *prefix, const unsigned char *URI);
+        static void onCharacters(void *ctx, const unsigned char *ch, int len);
+
+        XMLStreamHandler *mHandler;
+        xmlParserCtxtPtr mContext;
+        XMLResults mResults;
+        std::vector<xmlNodePtr> mOpen;
+        xmlNodePtr mCurrent;
+        int mDepth;
+        int mCollectDepth;
+};
+
 class XMLAttribute
 {
     public:
@@ -99,6 +165,12 @@ class XMLAttribute
         std::string value() const;
         const XMLAttribute next() const;
 
+        /* Unqualified name, value and namespace prefix (or NULL if the
+         * attribute has none) without copying them */
+        const char *getName() const;
+        const char *getValue() const;
+        const char *getPrefix() const;
+
         friend const XMLAttribute XMLNode::getAttribute(const char *name) const;
 
     private:
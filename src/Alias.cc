@@ -28,7 +28,9 @@
 
 #include "musicbrainz5/Alias.h"
 
-class MusicBrainz5::CAliasPrivate
+#include "musicbrainz5/NameTable.h"
+
+class MusicBrainz5::CAliasPrivate: public CSharedData
 {
 public:
 		std::string m_Locale;
@@ -40,6 +42,30 @@ public:
 		std::string m_EndDate;
 };
 
+// Attributes handled by ParseAttribute
+
+enum
+{
+	eAttribute_Locale,
+	eAttribute_SortName,
+	eAttribute_Type,
+	eAttribute_Primary,
+	eAttribute_BeginDate,
+	eAttribute_EndDate
+};
+
+static const MusicBrainz5::CNameTable::CEntry AttributeEntries[]=
+{
+	{ "locale", eAttribute_Locale },
+	{ "sort-name", eAttribute_SortName },
+	{ "type", eAttribute_Type },
+	{ "primary", eAttribute_Primary },
+	{ "begin-date", eAttribute_BeginDate },
+	{ "end-date", eAttribute_EndDate }
+};
+
+static const MusicBrainz5::CNameTable Attributes(AttributeEntries,sizeof(AttributeEntries)/sizeof(AttributeEntries[0]));
+
 MusicBrainz5::CAlias::CAlias(const XMLNode& Node)
 :	CEntity(),
 	m_d(new CAliasPrivate)
@@ -66,23 +92,54 @@ MusicBrainz5::CAlias& MusicBrainz5::CAlias::operator =(const CAlias& Other)
 {
 	if (this!=&Other)
 	{
+		CSharedData::Unshare(m_d);
+
 		CEntity::operator =(Other);
 
-		m_d->m_Locale=Other.m_d->m_Locale;
-		m_d->m_Text=Other.m_d->m_Text;
-		m_d->m_SortName=Other.m_d->m_SortName;
-		m_d->m_Type=Other.m_d->m_Type;
-		m_d->m_Primary=Other.m_d->m_Primary;
-		m_d->m_BeginDate=Other.m_d->m_BeginDate;
-		m_d->m_EndDate=Other.m_d->m_EndDate;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_Locale=Other.m_d->m_Locale;
+			m_d->m_Text=Other.m_d->m_Text;
+			m_d->m_SortName=Other.m_d->m_SortName;
+			m_d->m_Type=Other.m_d->m_Type;
+			m_d->m_Primary=Other.m_d->m_Primary;
+			m_d->m_BeginDate=Other.m_d->m_BeginDate;
+			m_d->m_EndDate=Other.m_d->m_EndDate;
+		}
 	}
 
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+MusicBrainz5::CAlias::CAlias(CAlias&& Other)
+:	CEntity(),
+	m_d(new CAliasPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CAlias& MusicBrainz5::CAlias::operator =(CAlias&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CAlias::~CAlias()
 {
-	delete m_d;
+	if (m_d->RemoveReference())
+		delete m_d;
 }
 
 MusicBrainz5::CAlias *MusicBrainz5::CAlias::Clone()
@@ -90,25 +147,39 @@ MusicBrainz5::CAlias *MusicBrainz5::CAlias::Clone()
 	return new CAlias(*this);
 }
 
-void MusicBrainz5::CAlias::ParseAttribute(const std::string& Name, const std::string& Value)
-{
-	if ("locale"==Name)
-		m_d->m_Locale=Value;
-	else if ("sort-name"==Name)
-		m_d->m_SortName=Value;
-	else if ("type"==Name)
-		m_d->m_Type=Value;
-	else if ("primary"==Name)
-		m_d->m_Primary=Value;
-	else if ("begin-date"==Name)
-		m_d->m_BeginDate=Value;
-	else if ("end-date"==Name)
-		m_d->m_EndDate=Value;
-	else
+void MusicBrainz5::CAlias::ParseAttribute(const char *Name, const char *Value)
+{
+	switch (Attributes.Find(Name))
 	{
+		case eAttribute_Locale:
+			m_d->m_Locale=Value;
+			break;
+
+		case eAttribute_SortName:
+			m_d->m_SortName=Value;
+			break;
+
+		case eAttribute_Type:
+			m_d->m_Type=Value;
+			break;
+
+		case eAttribute_Primary:
+			m_d->m_Primary=Value;
+			break;
+
+		case eAttribute_BeginDate:
+			m_d->m_BeginDate=Value;
+			break;
+
+		case eAttribute_EndDate:
+			m_d->m_EndDate=Value;
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised alias attribute: '" << Name << "'" << std::endl;
+			std::cerr << "Unrecognised alias attribute: '" << Name << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
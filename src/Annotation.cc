@@ -28,7 +28,9 @@
 
 #include "musicbrainz5/Annotation.h"
 
-class MusicBrainz5::CAnnotationPrivate
+#include <string.h>
+
+class MusicBrainz5::CAnnotationPrivate: public CSharedData
 {
 public:
 		std::string m_Type;
@@ -60,20 +62,51 @@ MusicBrainz5::CAnnotation& MusicBrainz5::CAnnotation::operator =(const CAnnotati
 {
 	if (this!=&Other)
 	{
+		CSharedData::Unshare(m_d);
+
 		CEntity::operator =(Other);
 
-		m_d->m_Type=Other.m_d->m_Type;
-		m_d->m_Entity=Other.m_d->m_Entity;
-		m_d->m_Name=Other.m_d->m_Name;
-		m_d->m_Text=Other.m_d->m_Text;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_Type=Other.m_d->m_Type;
+			m_d->m_Entity=Other.m_d->m_Entity;
+			m_d->m_Name=Other.m_d->m_Name;
+			m_d->m_Text=Other.m_d->m_Text;
+		}
+	}
+
+	return *this;
+}
+
+#if __cplusplus >= 201103L
+MusicBrainz5::CAnnotation::CAnnotation(CAnnotation&& Other)
+:	CEntity(),
+	m_d(new CAnnotationPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CAnnotation& MusicBrainz5::CAnnotation::operator =(CAnnotation&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CAnnotation::~CAnnotation()
 {
-	delete m_d;
+	if (m_d->RemoveReference())
+		delete m_d;
 }
 
 MusicBrainz5::CAnnotation *MusicBrainz5::CAnnotation::Clone()
@@ -81,9 +114,9 @@ MusicBrainz5::CAnnotation *MusicBrainz5::CAnnotation::Clone()
 	return new CAnnotation(*this);
 }
 
-void MusicBrainz5::CAnnotation::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CAnnotation::ParseAttribute(const char *Name, const char *Value)
 {
-	if ("type"==Name)
+	if (0==strcmp(Name,"type"))
 		m_d->m_Type=Value;
 	else
 	{
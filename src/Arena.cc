@@ -0,0 +1,274 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/Arena.h"
+
+#include <map>
+#include <new>
+#include <cstdlib>
+
+#include <pthread.h>
+
+#define ALIGNMENT	16
+
+// The blocks of every live arena, keyed on their start, so that Owner can tell arena
+// allocations from heap ones without a header in front of each of them. While there are
+// no arenas, allocations go straight to the heap and nothing here is looked at.
+
+struct CBlock
+{
+	const char *m_End;
+	MusicBrainz5::CArena *m_Arena;
+};
+
+typedef std::map<const char *,CBlock> tBlockMap;
+
+static pthread_rwlock_t BlockLock=PTHREAD_RWLOCK_INITIALIZER;
+static tBlockMap Blocks;
+static int Arenas=0;
+
+class MusicBrainz5::CArenaPrivate
+{
+	public:
+		CArenaPrivate(CArena *Arena)
+		:	m_Arena(Arena),
+			m_BlockSize(65536),
+			m_Block(0),
+			m_Used(0),
+			m_Size(0),
+			m_Allocated(0),
+			m_Reserved(0)
+		{
+		}
+
+		~CArenaPrivate()
+		{
+			pthread_rwlock_wrlock(&BlockLock);
+
+			while (m_Block)
+			{
+				char *Previous=*reinterpret_cast<char **>(m_Block);
+				Blocks.erase(m_Block);
+				free(m_Block);
+				m_Block=Previous;
+			}
+
+			pthread_rwlock_unlock(&BlockLock);
+		}
+
+		char *NewBlock(size_t Size)
+		{
+			char *Block=static_cast<char *>(malloc(Size));
+			if (!Block)
+				throw std::bad_alloc();
+
+			CBlock ThisBlock;
+			ThisBlock.m_End=Block+Size;
+			ThisBlock.m_Arena=m_Arena;
+
+			pthread_rwlock_wrlock(&BlockLock);
+
+			try
+			{
+				Blocks[Block]=ThisBlock;
+			}
+
+			catch (...)
+			{
+				pthread_rwlock_unlock(&BlockLock);
+				free(Block);
+				throw;
+			}
+
+			pthread_rwlock_unlock(&BlockLock);
+
+			m_Reserved+=Size;
+
+			return Block;
+		}
+
+		void *Allocate(size_t Size)
+		{
+			// Each block starts with a pointer to the previous one
+
+			if (Size+ALIGNMENT>m_BlockSize/4)
+			{
+				// Large allocations get a block of their own, linked in behind the current
+				// one so that it can still be used
+
+				char *Block=NewBlock(Size+ALIGNMENT);
+
+				if (m_Block)
+				{
+					*reinterpret_cast<char **>(Block)=*reinterpret_cast<char **>(m_Block);
+					*reinterpret_cast<char **>(m_Block)=Block;
+				}
+				else
+				{
+					*reinterpret_cast<char **>(Block)=0;
+					m_Block=Block;
+					m_Used=Size+ALIGNMENT;
+					m_Size=Size+ALIGNMENT;
+				}
+
+				m_Allocated+=Size;
+
+				return Block+ALIGNMENT;
+			}
+
+			if (m_Used+Size>m_Size)
+			{
+				char *Block=NewBlock(m_BlockSize);
+
+				*reinterpret_cast<char **>(Block)=m_Block;
+				m_Block=Block;
+				m_Used=ALIGNMENT;
+				m_Size=m_BlockSize;
+			}
+
+			void *Ret=m_Block+m_Used;
+
+			m_Used+=Size;
+			m_Allocated+=Size;
+
+			return Ret;
+		}
+
+		CArena *m_Arena;
+		size_t m_BlockSize;
+		char *m_Block;
+		size_t m_Used;
+		size_t m_Size;
+		size_t m_Allocated;
+		size_t m_Reserved;
+};
+
+static pthread_once_t CurrentOnce=PTHREAD_ONCE_INIT;
+static pthread_key_t CurrentKey;
+
+static void CreateCurrentKey()
+{
+	pthread_key_create(&CurrentKey,0);
+}
+
+MusicBrainz5::CArena::CArena(size_t BlockSize)
+:	m_d(new CArenaPrivate(this))
+{
+	if (BlockSize>=4*ALIGNMENT)
+		m_d->m_BlockSize=BlockSize;
+
+	__sync_add_and_fetch(&Arenas,1);
+}
+
+MusicBrainz5::CArena::~CArena()
+{
+	delete m_d;
+
+	__sync_sub_and_fetch(&Arenas,1);
+}
+
+size_t MusicBrainz5::CArena::Allocated() const
+{
+	return m_d->m_Allocated;
+}
+
+size_t MusicBrainz5::CArena::Reserved() const
+{
+	return m_d->m_Reserved;
+}
+
+void *MusicBrainz5::CArena::Allocate(size_t Size)
+{
+	CArena *Arena=Current();
+
+	if (Arena)
+		return Arena->m_d->Allocate((Size+ALIGNMENT-1)/ALIGNMENT*ALIGNMENT);
+
+	return ::operator new(Size);
+}
+
+void MusicBrainz5::CArena::Free(void *Ptr)
+{
+	if (Ptr && !Owner(Ptr))
+		::operator delete(Ptr);
+}
+
+MusicBrainz5::CArena *MusicBrainz5::CArena::Owner(const void *Ptr)
+{
+	CArena *Ret=0;
+
+	if (Ptr && __sync_add_and_fetch(&Arenas,0))
+	{
+		const char *Address=static_cast<const char *>(Ptr);
+
+		pthread_rwlock_rdlock(&BlockLock);
+
+		tBlockMap::const_iterator ThisBlock=Blocks.upper_bound(Address);
+		if (ThisBlock!=Blocks.begin())
+		{
+			--ThisBlock;
+
+			if (Address<(*ThisBlock).second.m_End)
+				Ret=(*ThisBlock).second.m_Arena;
+		}
+
+		pthread_rwlock_unlock(&BlockLock);
+	}
+
+	return Ret;
+}
+
+MusicBrainz5::CArena *MusicBrainz5::CArena::Current()
+{
+	// The current arena is always a live one, so there is nothing to look up without any
+
+	if (0==__sync_add_and_fetch(&Arenas,0))
+		return 0;
+
+	pthread_once(&CurrentOnce,CreateCurrentKey);
+
+	return static_cast<CArena *>(pthread_getspecific(CurrentKey));
+}
+
+void MusicBrainz5::CArena::SetCurrent(CArena *Arena)
+{
+	pthread_once(&CurrentOnce,CreateCurrentKey);
+
+	pthread_setspecific(CurrentKey,Arena);
+}
+
+MusicBrainz5::CArenaScope::CArenaScope(CArena *Arena)
+:	m_Previous(CArena::Current())
+{
+	CArena::SetCurrent(Arena);
+}
+
+MusicBrainz5::CArenaScope::~CArenaScope()
+{
+	CArena::SetCurrent(m_Previous);
+}
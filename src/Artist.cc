@@ -28,6 +28,10 @@
 
 #include "musicbrainz5/Artist.h"
 
+#include "musicbrainz5/NameTable.h"
+
+#include <string.h>
+
 #include "musicbrainz5/Lifespan.h"
 #include "musicbrainz5/IPI.h"
 #include "musicbrainz5/Rating.h"
@@ -52,11 +56,14 @@
 #include "musicbrainz5/UserTagList.h"
 #include "musicbrainz5/UserTag.h"
 
-class MusicBrainz5::CArtistPrivate
+class MusicBrainz5::CArtistPrivate: public CSharedData
 {
 	public:
 		CArtistPrivate()
-		:	m_IPIList(0),
+		:	m_Type(CStringPool::Empty()),
+			m_Gender(CStringPool::Empty()),
+			m_Country(CStringPool::Empty()),
+			m_IPIList(0),
 			m_Lifespan(0),
 			m_AliasList(0),
 			m_RecordingList(0),
@@ -73,11 +80,11 @@ class MusicBrainz5::CArtistPrivate
 		}
 
 		std::string m_ID;
-		std::string m_Type;
+		const std::string *m_Type;
 		std::string m_Name;
 		std::string m_SortName;
-		std::string m_Gender;
-		std::string m_Country;
+		const std::string *m_Gender;
+		const std::string *m_Country;
 		std::string m_Disambiguation;
 		CIPIList *m_IPIList;
 		CLifespan *m_Lifespan;
@@ -94,6 +101,56 @@ class MusicBrainz5::CArtistPrivate
 		CUserRating *m_UserRating;
 };
 
+// Child elements handled by ParseElement
+
+enum
+{
+	eElement_Name,
+	eElement_SortName,
+	eElement_Gender,
+	eElement_Country,
+	eElement_Disambiguation,
+	eElement_IPI,
+	eElement_IPIList,
+	eElement_LifeSpan,
+	eElement_AliasList,
+	eElement_RecordingList,
+	eElement_ReleaseList,
+	eElement_ReleaseGroupList,
+	eElement_LabelList,
+	eElement_WorkList,
+	eElement_RelationList,
+	eElement_TagList,
+	eElement_UserTagList,
+	eElement_Rating,
+	eElement_UserRating
+};
+
+static const MusicBrainz5::CNameTable::CEntry ElementEntries[]=
+{
+	{ "name", eElement_Name },
+	{ "sort-name", eElement_SortName },
+	{ "gender", eElement_Gender },
+	{ "country", eElement_Country },
+	{ "disambiguation", eElement_Disambiguation },
+	{ "ipi", eElement_IPI },
+	{ "ipi-list", eElement_IPIList },
+	{ "life-span", eElement_LifeSpan },
+	{ "alias-list", eElement_AliasList },
+	{ "recording-list", eElement_RecordingList },
+	{ "release-list", eElement_ReleaseList },
+	{ "release-group-list", eElement_ReleaseGroupList },
+	{ "label-list", eElement_LabelList },
+	{ "work-list", eElement_WorkList },
+	{ "relation-list", eElement_RelationList },
+	{ "tag-list", eElement_TagList },
+	{ "user-tag-list", eElement_UserTagList },
+	{ "rating", eElement_Rating },
+	{ "user-rating", eElement_UserRating }
+};
+
+static const MusicBrainz5::CNameTable Elements(ElementEntries,sizeof(ElementEntries)/sizeof(ElementEntries[0]));
+
 MusicBrainz5::CArtist::CArtist(const XMLNode& Node)
 :	CEntity(),
 	m_d(new CArtistPrivate)
@@ -117,66 +174,98 @@ MusicBrainz5::CArtist& MusicBrainz5::CArtist::operator =(const CArtist& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
-		m_d->m_Type=Other.m_d->m_Type;
-		m_d->m_Name=Other.m_d->m_Name;
-		m_d->m_SortName=Other.m_d->m_SortName;
-		m_d->m_Gender=Other.m_d->m_Gender;
-		m_d->m_Country=Other.m_d->m_Country;
-		m_d->m_Disambiguation=Other.m_d->m_Disambiguation;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_ID=Other.m_d->m_ID;
+			m_d->m_Type=Other.m_d->m_Type;
+			m_d->m_Name=Other.m_d->m_Name;
+			m_d->m_SortName=Other.m_d->m_SortName;
+			m_d->m_Gender=Other.m_d->m_Gender;
+			m_d->m_Country=Other.m_d->m_Country;
+			m_d->m_Disambiguation=Other.m_d->m_Disambiguation;
 
-		if (Other.m_d->m_IPIList)
-			m_d->m_IPIList=new CIPIList(*Other.m_d->m_IPIList);
+			if (Other.m_d->m_IPIList)
+				m_d->m_IPIList=new CIPIList(*Other.m_d->m_IPIList);
 
-		if (Other.m_d->m_Lifespan)
-			m_d->m_Lifespan=new CLifespan(*Other.m_d->m_Lifespan);
+			if (Other.m_d->m_Lifespan)
+				m_d->m_Lifespan=new CLifespan(*Other.m_d->m_Lifespan);
 
-		if (Other.m_d->m_AliasList)
-			m_d->m_AliasList=new CAliasList(*Other.m_d->m_AliasList);
+			if (Other.m_d->m_AliasList)
+				m_d->m_AliasList=new CAliasList(*Other.m_d->m_AliasList);
 
-		if (Other.m_d->m_RecordingList)
-			m_d->m_RecordingList=new CRecordingList(*Other.m_d->m_RecordingList);
+			if (Other.m_d->m_RecordingList)
+				m_d->m_RecordingList=new CRecordingList(*Other.m_d->m_RecordingList);
 
-		if (Other.m_d->m_ReleaseList)
-			m_d->m_ReleaseList=new CReleaseList(*Other.m_d->m_ReleaseList);
+			if (Other.m_d->m_ReleaseList)
+				m_d->m_ReleaseList=new CReleaseList(*Other.m_d->m_ReleaseList);
 
-		if (Other.m_d->m_ReleaseGroupList)
-			m_d->m_ReleaseGroupList=new CReleaseGroupList(*Other.m_d->m_ReleaseGroupList);
+			if (Other.m_d->m_ReleaseGroupList)
+				m_d->m_ReleaseGroupList=new CReleaseGroupList(*Other.m_d->m_ReleaseGroupList);
 
-		if (Other.m_d->m_LabelList)
-			m_d->m_LabelList=new CLabelList(*Other.m_d->m_LabelList);
+			if (Other.m_d->m_LabelList)
+				m_d->m_LabelList=new CLabelList(*Other.m_d->m_LabelList);
 
-		if (Other.m_d->m_WorkList)
-			m_d->m_WorkList=new CWorkList(*Other.m_d->m_WorkList);
+			if (Other.m_d->m_WorkList)
+				m_d->m_WorkList=new CWorkList(*Other.m_d->m_WorkList);
 
-		if (Other.m_d->m_RelationListList)
-			m_d->m_RelationListList=new CRelationListList(*Other.m_d->m_RelationListList);
+			if (Other.m_d->m_RelationListList)
+				m_d->m_RelationListList=new CRelationListList(*Other.m_d->m_RelationListList);
 
-		if (Other.m_d->m_TagList)
-			m_d->m_TagList=new CTagList(*Other.m_d->m_TagList);
+			if (Other.m_d->m_TagList)
+				m_d->m_TagList=new CTagList(*Other.m_d->m_TagList);
 
-		if (Other.m_d->m_UserTagList)
-			m_d->m_UserTagList=new CUserTagList(*Other.m_d->m_UserTagList);
+			if (Other.m_d->m_UserTagList)
+				m_d->m_UserTagList=new CUserTagList(*Other.m_d->m_UserTagList);
 
-		if (Other.m_d->m_Rating)
-			m_d->m_Rating=new CRating(*Other.m_d->m_Rating);
+			if (Other.m_d->m_Rating)
+				m_d->m_Rating=new CRating(*Other.m_d->m_Rating);
 
-		if (Other.m_d->m_UserRating)
-			m_d->m_UserRating=new CUserRating(*Other.m_d->m_UserRating);
+			if (Other.m_d->m_UserRating)
+				m_d->m_UserRating=new CUserRating(*Other.m_d->m_UserRating);
+		}
+	}
+
+	return *this;
+}
+
+#if __cplusplus >= 201103L
+MusicBrainz5::CArtist::CArtist(CArtist&& Other)
+:	CEntity(),
+	m_d(new CArtistPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CArtist& MusicBrainz5::CArtist::operator =(CArtist&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CArtist::~CArtist()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::CArtist::Cleanup()
@@ -226,12 +315,12 @@ MusicBrainz5::CArtist *MusicBrainz5::CArtist::Clone()
 	return new CArtist(*this);
 }
 
-void MusicBrainz5::CArtist::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CArtist::ParseAttribute(const char *Name, const char *Value)
 {
-	if ("id"==Name)
+	if (0==strcmp(Name,"id"))
 		m_d->m_ID=Value;
-	else if ("type"==Name)
-		m_d->m_Type=Value;
+	else if (0==strcmp(Name,"type"))
+		m_d->m_Type=CStringPool::Intern(Value);
 	else
 	{
 #ifdef _MB5_DEBUG_
@@ -242,89 +331,89 @@ void MusicBrainz5::CArtist::ParseAttribute(const std::string& Name, const std::s
 
 void MusicBrainz5::CArtist::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
-
-	if ("name"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Name);
-	}
-	else if ("sort-name"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_SortName);
-	}
-	else if ("gender"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Gender);
-	}
-	else if ("country"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Country);
-	}
-	else if ("disambiguation"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Disambiguation);
-	}
-	else if ("ipi"==NodeName)
-	{
-		//Ignore IPI
-	}
-	else if ("ipi-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_IPIList);
-	}
-	else if ("life-span"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Lifespan);
-	}
-	else if ("alias-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_AliasList);
-	}
-	else if ("recording-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_RecordingList);
-	}
-	else if ("release-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ReleaseList);
-	}
-	else if ("release-group-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ReleaseGroupList);
-	}
-	else if ("label-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_LabelList);
-	}
-	else if ("work-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_WorkList);
-	}
-	else if ("relation-list"==NodeName)
-	{
-		ProcessRelationList(Node,m_d->m_RelationListList);
-	}
-	else if ("tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_TagList);
-	}
-	else if ("user-tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserTagList);
-	}
-	else if ("rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Rating);
-	}
-	else if ("user-rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserRating);
-	}
-	else
+	switch (Elements.Find(Node.getName()))
 	{
+		case eElement_Name:
+			ProcessItem(Node,m_d->m_Name);
+			break;
+
+		case eElement_SortName:
+			ProcessItem(Node,m_d->m_SortName);
+			break;
+
+		case eElement_Gender:
+			ProcessItem(Node,m_d->m_Gender);
+			break;
+
+		case eElement_Country:
+			ProcessItem(Node,m_d->m_Country);
+			break;
+
+		case eElement_Disambiguation:
+			ProcessItem(Node,m_d->m_Disambiguation);
+			break;
+
+		case eElement_IPI:
+			//Ignore IPI
+			break;
+
+		case eElement_IPIList:
+			ProcessItem(Node,m_d->m_IPIList);
+			break;
+
+		case eElement_LifeSpan:
+			ProcessItem(Node,m_d->m_Lifespan);
+			break;
+
+		case eElement_AliasList:
+			ProcessItem(Node,m_d->m_AliasList);
+			break;
+
+		case eElement_RecordingList:
+			ProcessItem(Node,m_d->m_RecordingList);
+			break;
+
+		case eElement_ReleaseList:
+			ProcessItem(Node,m_d->m_ReleaseList);
+			break;
+
+		case eElement_ReleaseGroupList:
+			ProcessItem(Node,m_d->m_ReleaseGroupList);
+			break;
+
+		case eElement_LabelList:
+			ProcessItem(Node,m_d->m_LabelList);
+			break;
+
+		case eElement_WorkList:
+			ProcessItem(Node,m_d->m_WorkList);
+			break;
+
+		case eElement_RelationList:
+			ProcessRelationList(Node,m_d->m_RelationListList);
+			break;
+
+		case eElement_TagList:
+			ProcessItem(Node,m_d->m_TagList);
+			break;
+
+		case eElement_UserTagList:
+			ProcessItem(Node,m_d->m_UserTagList);
+			break;
+
+		case eElement_Rating:
+			ProcessItem(Node,m_d->m_Rating);
+			break;
+
+		case eElement_UserRating:
+			ProcessItem(Node,m_d->m_UserRating);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised artist element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised artist element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -339,6 +428,11 @@ std::string MusicBrainz5::CArtist::ID() const
 }
 
 std::string MusicBrainz5::CArtist::Type() const
+{
+	return *m_d->m_Type;
+}
+
+const std::string *MusicBrainz5::CArtist::InternedType() const
 {
 	return m_d->m_Type;
 }
@@ -354,11 +448,21 @@ std::string MusicBrainz5::CArtist::SortName() const
 }
 
 std::string MusicBrainz5::CArtist::Gender() const
+{
+	return *m_d->m_Gender;
+}
+
+const std::string *MusicBrainz5::CArtist::InternedGender() const
 {
 	return m_d->m_Gender;
 }
 
 std::string MusicBrainz5::CArtist::Country() const
+{
+	return *m_d->m_Country;
+}
+
+const std::string *MusicBrainz5::CArtist::InternedCountry() const
 {
 	return m_d->m_Country;
 }
@@ -31,7 +31,7 @@
 #include "musicbrainz5/NameCreditList.h"
 #include "musicbrainz5/NameCredit.h"
 
-class MusicBrainz5::CArtistCreditPrivate
+class MusicBrainz5::CArtistCreditPrivate: public CSharedData
 {
 	public:
 		CArtistCreditPrivate()
@@ -67,22 +67,54 @@ MusicBrainz5::CArtistCredit& MusicBrainz5::CArtistCredit::operator =(const CArti
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		if (Other.m_d->m_NameCreditList)
-			m_d->m_NameCreditList=new CNameCreditList(*Other.m_d->m_NameCreditList);
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			if (Other.m_d->m_NameCreditList)
+				m_d->m_NameCreditList=new CNameCreditList(*Other.m_d->m_NameCreditList);
+		}
+	}
+
+	return *this;
+}
+
+#if __cplusplus >= 201103L
+MusicBrainz5::CArtistCredit::CArtistCredit(CArtistCredit&& Other)
+:	CEntity(),
+	m_d(new CArtistCreditPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CArtistCredit& MusicBrainz5::CArtistCredit::operator =(CArtistCredit&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CArtistCredit::~CArtistCredit()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::CArtistCredit::Cleanup()
@@ -96,7 +128,7 @@ MusicBrainz5::CArtistCredit *MusicBrainz5::CArtistCredit::Clone()
 	return new CArtistCredit(*this);
 }
 
-void MusicBrainz5::CArtistCredit::ParseAttribute(const std::string& Name, const std::string& /*Value*/)
+void MusicBrainz5::CArtistCredit::ParseAttribute(const char *Name, const char * /*Value*/)
 {
 #ifdef _MB5_DEBUG_
 	std::cerr << "Unrecognised artistcredit attribute: '" << Name << "'" << std::endl;
@@ -28,7 +28,7 @@
 
 #include "musicbrainz5/Attribute.h"
 
-class MusicBrainz5::CAttributePrivate
+class MusicBrainz5::CAttributePrivate: public CSharedData
 {
 	public:
 		std::string m_Text;
@@ -60,17 +60,46 @@ MusicBrainz5::CAttribute& MusicBrainz5::CAttribute::operator =(const CAttribute&
 {
 	if (this!=&Other)
 	{
+		CSharedData::Unshare(m_d);
+
 		CEntity::operator =(Other);
 
-		m_d->m_Text=Other.m_d->m_Text;
+		if (!CSharedData::Share(m_d,Other.m_d))
+			m_d->m_Text=Other.m_d->m_Text;
 	}
 
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+MusicBrainz5::CAttribute::CAttribute(CAttribute&& Other)
+:	CEntity(),
+	m_d(new CAttributePrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CAttribute& MusicBrainz5::CAttribute::operator =(CAttribute&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CAttribute::~CAttribute()
 {
-	delete m_d;
+	if (m_d->RemoveReference())
+		delete m_d;
 }
 
 MusicBrainz5::CAttribute *MusicBrainz5::CAttribute::Clone()
@@ -78,7 +107,7 @@ MusicBrainz5::CAttribute *MusicBrainz5::CAttribute::Clone()
 	return new CAttribute(*this);
 }
 
-void MusicBrainz5::CAttribute::ParseAttribute(const std::string& Name, const std::string& /*Value*/)
+void MusicBrainz5::CAttribute::ParseAttribute(const char *Name, const char * /*Value*/)
 {
 #ifdef _MB5_DEBUG_
 	std::cerr << "Unrecognised attribute attribute: '" << Name << "'" << std::endl;
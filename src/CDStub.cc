@@ -28,10 +28,14 @@
 
 #include "musicbrainz5/CDStub.h"
 
+#include "musicbrainz5/NameTable.h"
+
+#include <string.h>
+
 #include "musicbrainz5/NonMBTrackList.h"
 #include "musicbrainz5/NonMBTrack.h"
 
-class MusicBrainz5::CCDStubPrivate
+class MusicBrainz5::CCDStubPrivate: public CSharedData
 {
 	public:
 		CCDStubPrivate()
@@ -47,6 +51,28 @@ class MusicBrainz5::CCDStubPrivate
 		CNonMBTrackList *m_NonMBTrackList;
 };
 
+// Child elements handled by ParseElement
+
+enum
+{
+	eElement_Title,
+	eElement_Artist,
+	eElement_Barcode,
+	eElement_Comment,
+	eElement_TrackList
+};
+
+static const MusicBrainz5::CNameTable::CEntry ElementEntries[]=
+{
+	{ "title", eElement_Title },
+	{ "artist", eElement_Artist },
+	{ "barcode", eElement_Barcode },
+	{ "comment", eElement_Comment },
+	{ "track-list", eElement_TrackList }
+};
+
+static const MusicBrainz5::CNameTable Elements(ElementEntries,sizeof(ElementEntries)/sizeof(ElementEntries[0]));
+
 MusicBrainz5::CCDStub::CCDStub(const XMLNode& Node)
 :	CEntity(),
 	m_d(new CCDStubPrivate)
@@ -70,28 +96,60 @@ MusicBrainz5::CCDStub& MusicBrainz5::CCDStub::operator =(const CCDStub& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
-		m_d->m_Title=Other.m_d->m_Title;
-		m_d->m_Artist=Other.m_d->m_Artist;
-		m_d->m_Barcode=Other.m_d->m_Barcode;
-		m_d->m_Comment=Other.m_d->m_Comment;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_ID=Other.m_d->m_ID;
+			m_d->m_Title=Other.m_d->m_Title;
+			m_d->m_Artist=Other.m_d->m_Artist;
+			m_d->m_Barcode=Other.m_d->m_Barcode;
+			m_d->m_Comment=Other.m_d->m_Comment;
+
+			if (Other.m_d->m_NonMBTrackList)
+				m_d->m_NonMBTrackList=new CNonMBTrackList(*Other.m_d->m_NonMBTrackList);
+		}
+	}
+
+	return *this;
+}
+
+#if __cplusplus >= 201103L
+MusicBrainz5::CCDStub::CCDStub(CCDStub&& Other)
+:	CEntity(),
+	m_d(new CCDStubPrivate)
+{
+	*this=std::move(Other);
+}
 
-		if (Other.m_d->m_NonMBTrackList)
-			m_d->m_NonMBTrackList=new CNonMBTrackList(*Other.m_d->m_NonMBTrackList);
+MusicBrainz5::CCDStub& MusicBrainz5::CCDStub::operator =(CCDStub&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CCDStub::~CCDStub()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::CCDStub::Cleanup()
@@ -105,9 +163,9 @@ MusicBrainz5::CCDStub *MusicBrainz5::CCDStub::Clone()
 	return new CCDStub(*this);
 }
 
-void MusicBrainz5::CCDStub::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CCDStub::ParseAttribute(const char *Name, const char *Value)
 {
-	if ("id"==Name)
+	if (0==strcmp(Name,"id"))
 		m_d->m_ID=Value;
 	else
 	{
@@ -119,33 +177,33 @@ void MusicBrainz5::CCDStub::ParseAttribute(const std::string& Name, const std::s
 
 void MusicBrainz5::CCDStub::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
-
-	if ("title"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Title);
-	}
-	else if ("artist"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Artist);
-	}
-	else if ("barcode"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Barcode);
-	}
-	else if ("comment"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Comment);
-	}
-	else if ("track-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_NonMBTrackList);
-	}
-	else
+	switch (Elements.Find(Node.getName()))
 	{
+		case eElement_Title:
+			ProcessItem(Node,m_d->m_Title);
+			break;
+
+		case eElement_Artist:
+			ProcessItem(Node,m_d->m_Artist);
+			break;
+
+		case eElement_Barcode:
+			ProcessItem(Node,m_d->m_Barcode);
+			break;
+
+		case eElement_Comment:
+			ProcessItem(Node,m_d->m_Comment);
+			break;
+
+		case eElement_TrackList:
+			ProcessItem(Node,m_d->m_NonMBTrackList);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised cd stub element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised cd stub element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
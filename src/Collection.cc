@@ -28,10 +28,12 @@
 
 #include "musicbrainz5/Collection.h"
 
+#include <string.h>
+
 #include "musicbrainz5/ReleaseList.h"
 #include "musicbrainz5/Release.h"
 
-class MusicBrainz5::CCollectionPrivate
+class MusicBrainz5::CCollectionPrivate: public CSharedData
 {
 	public:
 		CCollectionPrivate()
@@ -67,26 +69,58 @@ MusicBrainz5::CCollection& MusicBrainz5::CCollection::operator =(const CCollecti
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
-		m_d->m_Name=Other.m_d->m_Name;
-		m_d->m_Editor=Other.m_d->m_Editor;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_ID=Other.m_d->m_ID;
+			m_d->m_Name=Other.m_d->m_Name;
+			m_d->m_Editor=Other.m_d->m_Editor;
 
-		if (Other.m_d->m_ReleaseList)
-			m_d->m_ReleaseList=new CReleaseList(*Other.m_d->m_ReleaseList);
+			if (Other.m_d->m_ReleaseList)
+				m_d->m_ReleaseList=new CReleaseList(*Other.m_d->m_ReleaseList);
+		}
 	}
 
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+MusicBrainz5::CCollection::CCollection(CCollection&& Other)
+:	CEntity(),
+	m_d(new CCollectionPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CCollection& MusicBrainz5::CCollection::operator =(CCollection&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CCollection::~CCollection()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::CCollection::Cleanup()
@@ -100,9 +134,9 @@ MusicBrainz5::CCollection *MusicBrainz5::CCollection::Clone()
 	return new CCollection(*this);
 }
 
-void MusicBrainz5::CCollection::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CCollection::ParseAttribute(const char *Name, const char *Value)
 {
-	if ("id"==Name)
+	if (0==strcmp(Name,"id"))
 		m_d->m_ID=Value;
 	else
 	{
@@ -28,12 +28,14 @@
 
 #include "musicbrainz5/Disc.h"
 
+#include <string.h>
+
 #include "musicbrainz5/OffsetList.h"
 #include "musicbrainz5/Offset.h"
 #include "musicbrainz5/ReleaseList.h"
 #include "musicbrainz5/Release.h"
 
-class MusicBrainz5::CDiscPrivate
+class MusicBrainz5::CDiscPrivate: public CSharedData
 {
 	public:
 		CDiscPrivate()
@@ -72,27 +74,59 @@ MusicBrainz5::CDisc& MusicBrainz5::CDisc::operator =(const CDisc& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
-		m_d->m_Sectors=Other.m_d->m_Sectors;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_ID=Other.m_d->m_ID;
+			m_d->m_Sectors=Other.m_d->m_Sectors;
 
-		if (Other.m_d->m_OffsetList)
-			m_d->m_OffsetList=new COffsetList(*Other.m_d->m_OffsetList);
-		if (Other.m_d->m_ReleaseList)
-			m_d->m_ReleaseList=new CReleaseList(*Other.m_d->m_ReleaseList);
+			if (Other.m_d->m_OffsetList)
+				m_d->m_OffsetList=new COffsetList(*Other.m_d->m_OffsetList);
+			if (Other.m_d->m_ReleaseList)
+				m_d->m_ReleaseList=new CReleaseList(*Other.m_d->m_ReleaseList);
+		}
 	}
 
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+MusicBrainz5::CDisc::CDisc(CDisc&& Other)
+:	CEntity(),
+	m_d(new CDiscPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CDisc& MusicBrainz5::CDisc::operator =(CDisc&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CDisc::~CDisc()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::CDisc::Cleanup()
@@ -108,9 +142,9 @@ MusicBrainz5::CDisc *MusicBrainz5::CDisc::Clone()
 	return new CDisc(*this);
 }
 
-void MusicBrainz5::CDisc::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CDisc::ParseAttribute(const char *Name, const char *Value)
 {
-	if ("id"==Name)
+	if (0==strcmp(Name,"id"))
 		ProcessItem(Value,m_d->m_ID);
 	else
 	{
@@ -0,0 +1,803 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/DiskCache.h"
+
+#include <map>
+#include <algorithm>
+#include <sstream>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <zlib.h>
+
+#ifdef _MB5_DEBUG_
+#include <iostream>
+#endif
+
+#define INDEX_MAGIC	0x4d424449
+#define INDEX_VERSION	2
+#define RECORD_MAGIC	0x4d424452
+
+// Each segment is mapped at this size up front, so appending to it never requires
+// it to be mapped again
+
+#define SEGMENT_SIZE	(64*1024*1024)
+
+class MusicBrainz5::CDiskCachePrivate
+{
+	public:
+		CDiskCachePrivate()
+		:	m_MaxSize(0),
+			m_MaxAge(0),
+			m_StaleWhileRevalidate(0),
+			m_IndexFD(-1),
+			m_Index(0),
+			m_IndexLength(0),
+			m_Header(0),
+			m_Slots(0),
+			m_DiskSize(0),
+			m_Hits(0),
+			m_Misses(0)
+		{
+			pthread_mutex_init(&m_Lock,0);
+		}
+
+		~CDiskCachePrivate()
+		{
+			Close();
+
+			pthread_mutex_destroy(&m_Lock);
+		}
+
+		struct CIndexHeader
+		{
+			uint32_t m_Magic;
+			uint32_t m_Version;
+			uint32_t m_NumSlots;
+			uint32_t m_Dirty;
+			uint32_t m_Count;
+			uint32_t m_FirstSegment;
+			uint32_t m_LastSegment;
+			uint32_t m_Reserved;
+		};
+
+		// A slot with a segment number of 0 is empty
+
+		struct CSlot
+		{
+			uint64_t m_Hash;
+			uint64_t m_Offset;
+			int64_t m_Stored;
+			uint32_t m_Segment;
+			uint32_t m_Length;
+		};
+
+		struct CRecordHeader
+		{
+			uint32_t m_Magic;
+			uint32_t m_KeyLength;
+			uint32_t m_DataLength;
+			uint32_t m_CompressedLength;
+			uint32_t m_ETagLength;
+			uint32_t m_LastModifiedLength;
+		};
+
+		class CSegment
+		{
+			public:
+				int m_FD;
+				unsigned char *m_Map;
+				size_t m_Size;
+		};
+
+		class CLiveEntry
+		{
+			public:
+				bool operator <(const CLiveEntry& Other) const
+				{
+					// Newest first
+
+					return m_Stored>Other.m_Stored;
+				}
+
+				uint32_t m_Slot;
+				int64_t m_Stored;
+		};
+
+		typedef std::map<uint32_t,CSegment> tSegmentMap;
+
+		static uint64_t Hash(const std::string& Key)
+		{
+			// FNV-1a
+
+			uint64_t Ret=14695981039346656037ULL;
+
+			for (std::string::size_type count=0;count<Key.length();count++)
+			{
+				Ret^=(unsigned char)Key[count];
+				Ret*=1099511628211ULL;
+			}
+
+			return Ret;
+		}
+
+		std::string SegmentName(uint32_t Segment) const
+		{
+			std::stringstream os;
+
+			os << m_Path << "/segment." << Segment;
+
+			return os.str();
+		}
+
+		bool Open(int IndexSize)
+		{
+			if (0!=mkdir(m_Path.c_str(),0700) && EEXIST!=errno)
+				return false;
+
+			std::string IndexName=m_Path+"/index";
+
+			m_IndexFD=open(IndexName.c_str(),O_RDWR|O_CREAT,0600);
+			if (-1==m_IndexFD)
+				return false;
+
+			if (0!=flock(m_IndexFD,LOCK_EX|LOCK_NB))
+			{
+				Close();
+				return false;
+			}
+
+			struct stat Stat;
+			if (0!=fstat(m_IndexFD,&Stat))
+			{
+				Close();
+				return false;
+			}
+
+			// Use the size of an existing index if it looks valid, otherwise start again
+
+			CIndexHeader Header;
+			memset(&Header,0,sizeof(Header));
+
+			bool Valid=Stat.st_size>=(off_t)sizeof(Header) &&
+						sizeof(Header)==pread(m_IndexFD,&Header,sizeof(Header),0) &&
+						INDEX_MAGIC==Header.m_Magic && INDEX_VERSION==Header.m_Version &&
+						Stat.st_size==(off_t)(sizeof(CIndexHeader)+Header.m_NumSlots*sizeof(CSlot));
+
+			uint32_t NumSlots=Valid ? Header.m_NumSlots : (uint32_t)IndexSize;
+			if (NumSlots<16)
+				NumSlots=16;
+
+			m_IndexLength=sizeof(CIndexHeader)+NumSlots*sizeof(CSlot);
+
+			if (!Valid && 0!=ftruncate(m_IndexFD,0))
+			{
+				Close();
+				return false;
+			}
+
+			if (0!=ftruncate(m_IndexFD,m_IndexLength))
+			{
+				Close();
+				return false;
+			}
+
+			void *Map=mmap(0,m_IndexLength,PROT_READ|PROT_WRITE,MAP_SHARED,m_IndexFD,0);
+			if (MAP_FAILED==Map)
+			{
+				Close();
+				return false;
+			}
+
+			m_Index=reinterpret_cast<unsigned char *>(Map);
+			m_Header=reinterpret_cast<CIndexHeader *>(m_Index);
+			m_Slots=reinterpret_cast<CSlot *>(m_Index+sizeof(CIndexHeader));
+
+			if (!Valid)
+			{
+				m_Header->m_Magic=INDEX_MAGIC;
+				m_Header->m_Version=INDEX_VERSION;
+				m_Header->m_NumSlots=NumSlots;
+				m_Header->m_Dirty=1;
+			}
+
+			// A cache left dirty by a process that did not finish updating it can not be trusted
+
+			if (m_Header->m_Dirty)
+			{
+				Reset();
+				return true;
+			}
+
+			for (uint32_t Segment=m_Header->m_FirstSegment;Segment<=m_Header->m_LastSegment;Segment++)
+			{
+				if (!OpenSegment(Segment,false))
+				{
+					Reset();
+					return true;
+				}
+			}
+
+			return true;
+		}
+
+		void Close()
+		{
+			while (!m_Segments.empty())
+				CloseSegment(m_Segments.begin(),false);
+
+			if (m_Index)
+			{
+				munmap(m_Index,m_IndexLength);
+				m_Index=0;
+				m_Header=0;
+				m_Slots=0;
+			}
+
+			if (-1!=m_IndexFD)
+			{
+				close(m_IndexFD);
+				m_IndexFD=-1;
+			}
+		}
+
+		bool OpenSegment(uint32_t Segment, bool Create)
+		{
+			std::string Name=SegmentName(Segment);
+
+			int FD=open(Name.c_str(),O_RDWR|(Create ? O_CREAT|O_TRUNC : 0),0600);
+			if (-1==FD)
+				return false;
+
+			struct stat Stat;
+			if (0!=fstat(FD,&Stat))
+			{
+				close(FD);
+				return false;
+			}
+
+			void *Map=mmap(0,SEGMENT_SIZE,PROT_READ,MAP_SHARED,FD,0);
+			if (MAP_FAILED==Map)
+			{
+				close(FD);
+				return false;
+			}
+
+			CSegment& NewSegment=m_Segments[Segment];
+			NewSegment.m_FD=FD;
+			NewSegment.m_Map=reinterpret_cast<unsigned char *>(Map);
+			NewSegment.m_Size=Stat.st_size;
+
+			m_DiskSize+=NewSegment.m_Size;
+
+			return true;
+		}
+
+		void CloseSegment(tSegmentMap::iterator ThisSegment, bool Remove)
+		{
+			CSegment& Segment=(*ThisSegment).second;
+
+			munmap(Segment.m_Map,SEGMENT_SIZE);
+			close(Segment.m_FD);
+
+			if (Remove)
+				unlink(SegmentName((*ThisSegment).first).c_str());
+
+			m_DiskSize-=Segment.m_Size;
+			m_Segments.erase(ThisSegment);
+		}
+
+		void Reset()
+		{
+			while (!m_Segments.empty())
+				CloseSegment(m_Segments.begin(),true);
+
+			// Remove any segments the index no longer knows about
+
+			DIR *Dir=opendir(m_Path.c_str());
+			if (Dir)
+			{
+				struct dirent *Entry;
+				while (0!=(Entry=readdir(Dir)))
+				{
+					if (0==strncmp(Entry->d_name,"segment.",8))
+						unlink((m_Path+"/"+Entry->d_name).c_str());
+				}
+
+				closedir(Dir);
+			}
+
+			memset(m_Slots,0,m_Header->m_NumSlots*sizeof(CSlot));
+			m_Header->m_Count=0;
+			m_Header->m_FirstSegment=1;
+			m_Header->m_LastSegment=0;
+			m_Header->m_Dirty=0;
+		}
+
+		const unsigned char *Record(const CSlot& Slot) const
+		{
+			tSegmentMap::const_iterator ThisSegment=m_Segments.find(Slot.m_Segment);
+			if (ThisSegment==m_Segments.end() || Slot.m_Offset+Slot.m_Length>(*ThisSegment).second.m_Size)
+				return 0;
+
+			return (*ThisSegment).second.m_Map+Slot.m_Offset;
+		}
+
+		bool RecordMatches(const CSlot& Slot, const std::string& Key) const
+		{
+			const unsigned char *Data=Record(Slot);
+			if (!Data)
+				return false;
+
+			CRecordHeader Header;
+			memcpy(&Header,Data,sizeof(Header));
+
+			return RECORD_MAGIC==Header.m_Magic && Key.length()==Header.m_KeyLength &&
+						0==memcmp(Data+sizeof(Header),Key.c_str(),Key.length());
+		}
+
+		CSlot *Probe(const std::string& Key, uint64_t KeyHash, bool& Found)
+		{
+			// Linear probing. The index is never allowed to fill up, so this always finds a slot
+
+			uint32_t NumSlots=m_Header->m_NumSlots;
+			uint32_t Slot=KeyHash%NumSlots;
+
+			while (0!=m_Slots[Slot].m_Segment)
+			{
+				if (m_Slots[Slot].m_Hash==KeyHash && RecordMatches(m_Slots[Slot],Key))
+				{
+					Found=true;
+					return &m_Slots[Slot];
+				}
+
+				Slot=(Slot+1)%NumSlots;
+			}
+
+			Found=false;
+			return &m_Slots[Slot];
+		}
+
+		bool Append(const unsigned char *Data, size_t Length, bool NewSegment, uint32_t& Segment, uint64_t& Offset)
+		{
+			tSegmentMap::iterator ThisSegment=m_Segments.find(m_Header->m_LastSegment);
+
+			if (NewSegment || ThisSegment==m_Segments.end() || (*ThisSegment).second.m_Size+Length>SEGMENT_SIZE)
+			{
+				if (!OpenSegment(m_Header->m_LastSegment+1,true))
+					return false;
+
+				m_Header->m_LastSegment++;
+				ThisSegment=m_Segments.find(m_Header->m_LastSegment);
+			}
+
+			CSegment& Current=(*ThisSegment).second;
+
+			if ((ssize_t)Length!=pwrite(Current.m_FD,Data,Length,Current.m_Size))
+				return false;
+
+			Segment=(*ThisSegment).first;
+			Offset=Current.m_Size;
+
+			Current.m_Size+=Length;
+			m_DiskSize+=Length;
+
+			return true;
+		}
+
+		bool Expired(const CSlot& Slot, time_t TimeNow) const
+		{
+			return m_MaxAge>0 && TimeNow-Slot.m_Stored>m_MaxAge;
+		}
+
+		bool Stale(const CSlot& Slot, time_t TimeNow) const
+		{
+			return TimeNow-Slot.m_Stored<=m_MaxAge+m_StaleWhileRevalidate;
+		}
+
+		bool HasValidators(const CSlot& Slot) const
+		{
+			CRecordHeader Header;
+			memcpy(&Header,Record(Slot),sizeof(Header));
+
+			return 0!=Header.m_ETagLength || 0!=Header.m_LastModifiedLength;
+		}
+
+		void Compact(size_t TargetSize, uint32_t TargetCount)
+		{
+			time_t TimeNow=time(0);
+			uint32_t NumSlots=m_Header->m_NumSlots;
+
+			std::vector<CLiveEntry> Live;
+
+			for (uint32_t Slot=0;Slot<NumSlots;Slot++)
+			{
+				// Expired responses are only worth keeping if they can be revalidated
+
+				if (0!=m_Slots[Slot].m_Segment && Record(m_Slots[Slot]) &&
+						(!Expired(m_Slots[Slot],TimeNow) || HasValidators(m_Slots[Slot])))
+				{
+					CLiveEntry Entry;
+					Entry.m_Slot=Slot;
+					Entry.m_Stored=m_Slots[Slot].m_Stored;
+					Live.push_back(Entry);
+				}
+			}
+
+			std::sort(Live.begin(),Live.end());
+
+			m_Header->m_Dirty=1;
+
+			// Copy the newest entries into new segments, then drop all the old ones
+
+			uint32_t OldLastSegment=m_Header->m_LastSegment;
+			std::vector<CSlot> NewSlots(NumSlots);
+			memset(&NewSlots[0],0,NumSlots*sizeof(CSlot));
+
+			size_t NewSize=0;
+			uint32_t NewCount=0;
+			bool NewSegment=true;
+
+			for (std::vector<CLiveEntry>::const_iterator ThisEntry=Live.begin();ThisEntry!=Live.end();++ThisEntry)
+			{
+				const CSlot& OldSlot=m_Slots[(*ThisEntry).m_Slot];
+
+				if (NewSize+OldSlot.m_Length>TargetSize || NewCount>=TargetCount)
+					break;
+
+				CSlot NewSlot=OldSlot;
+				if (!Append(Record(OldSlot),OldSlot.m_Length,NewSegment,NewSlot.m_Segment,NewSlot.m_Offset))
+				{
+#ifdef _MB5_DEBUG_
+					std::cerr << "Error compacting disk cache: " << strerror(errno) << std::endl;
+#endif
+
+					Reset();
+					return;
+				}
+
+				NewSegment=false;
+
+				uint32_t Slot=NewSlot.m_Hash%NumSlots;
+				while (0!=NewSlots[Slot].m_Segment)
+					Slot=(Slot+1)%NumSlots;
+
+				NewSlots[Slot]=NewSlot;
+
+				NewSize+=OldSlot.m_Length;
+				NewCount++;
+			}
+
+			memcpy(m_Slots,&NewSlots[0],NumSlots*sizeof(CSlot));
+			m_Header->m_Count=NewCount;
+
+			tSegmentMap::iterator ThisSegment=m_Segments.begin();
+			while (ThisSegment!=m_Segments.end() && (*ThisSegment).first<=OldLastSegment)
+			{
+				CloseSegment(ThisSegment,true);
+				ThisSegment=m_Segments.begin();
+			}
+
+			m_Header->m_FirstSegment=OldLastSegment+1;
+			if (m_Header->m_LastSegment<OldLastSegment)
+				m_Header->m_LastSegment=OldLastSegment;
+
+			m_Header->m_Dirty=0;
+		}
+
+		std::string m_Path;
+		size_t m_MaxSize;
+		int m_MaxAge;
+		int m_StaleWhileRevalidate;
+		int m_IndexFD;
+		unsigned char *m_Index;
+		size_t m_IndexLength;
+		CIndexHeader *m_Header;
+		CSlot *m_Slots;
+		tSegmentMap m_Segments;
+		size_t m_DiskSize;
+		unsigned long m_Hits;
+		unsigned long m_Misses;
+		pthread_mutex_t m_Lock;
+};
+
+MusicBrainz5::CDiskCache::CDiskCache(const std::string& Path, size_t MaxSize, int IndexSize)
+:	m_d(new CDiskCachePrivate)
+{
+	m_d->m_Path=Path;
+	m_d->m_MaxSize=MaxSize;
+
+	if (!m_d->Open(IndexSize))
+	{
+#ifdef _MB5_DEBUG_
+		std::cerr << "Unable to open disk cache '" << Path << "': " << strerror(errno) << std::endl;
+#endif
+	}
+}
+
+MusicBrainz5::CDiskCache::~CDiskCache()
+{
+	delete m_d;
+}
+
+bool MusicBrainz5::CDiskCache::IsOpen() const
+{
+	return 0!=m_d->m_Header;
+}
+
+void MusicBrainz5::CDiskCache::SetMaxAge(int MaxAge)
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	m_d->m_MaxAge=MaxAge;
+	pthread_mutex_unlock(&m_d->m_Lock);
+}
+
+void MusicBrainz5::CDiskCache::SetMaxSize(size_t MaxSize)
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	m_d->m_MaxSize=MaxSize;
+	pthread_mutex_unlock(&m_d->m_Lock);
+}
+
+void MusicBrainz5::CDiskCache::SetStaleWhileRevalidate(int StaleWhileRevalidate)
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	m_d->m_StaleWhileRevalidate=StaleWhileRevalidate;
+	pthread_mutex_unlock(&m_d->m_Lock);
+}
+
+int MusicBrainz5::CDiskCache::MaxAge() const
+{
+	return m_d->m_MaxAge;
+}
+
+int MusicBrainz5::CDiskCache::StaleWhileRevalidate() const
+{
+	return m_d->m_StaleWhileRevalidate;
+}
+
+size_t MusicBrainz5::CDiskCache::MaxSize() const
+{
+	return m_d->m_MaxSize;
+}
+
+size_t MusicBrainz5::CDiskCache::Size() const
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	size_t Ret=m_d->m_DiskSize;
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+size_t MusicBrainz5::CDiskCache::Count() const
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	size_t Ret=m_d->m_Header ? m_d->m_Header->m_Count : 0;
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+unsigned long MusicBrainz5::CDiskCache::Hits() const
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	unsigned long Ret=m_d->m_Hits;
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+unsigned long MusicBrainz5::CDiskCache::Misses() const
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	unsigned long Ret=m_d->m_Misses;
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+void MusicBrainz5::CDiskCache::Compact()
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+
+	if (m_d->m_Header)
+		m_d->Compact(m_d->m_MaxSize,m_d->m_Header->m_NumSlots*3/4);
+
+	pthread_mutex_unlock(&m_d->m_Lock);
+}
+
+void MusicBrainz5::CDiskCache::Clear()
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+
+	if (m_d->m_Header)
+		m_d->Reset();
+
+	pthread_mutex_unlock(&m_d->m_Lock);
+}
+
+MusicBrainz5::CDiskCache::tFindResult MusicBrainz5::CDiskCache::Find(const std::string& Key, std::vector<unsigned char>& Data, std::string& ETag, std::string& LastModified)
+{
+	tFindResult Ret=eFind_Miss;
+
+	pthread_mutex_lock(&m_d->m_Lock);
+
+	if (m_d->m_Header)
+	{
+		bool Found;
+		CDiskCachePrivate::CSlot *Slot=m_d->Probe(Key,CDiskCachePrivate::Hash(Key),Found);
+
+		if (Found)
+		{
+			time_t TimeNow=time(0);
+
+			if (!m_d->Expired(*Slot,TimeNow))
+				Ret=eFind_Fresh;
+			else if (m_d->Stale(*Slot,TimeNow))
+				Ret=eFind_Stale;
+			else if (m_d->HasValidators(*Slot))
+				Ret=eFind_Expired;
+		}
+
+		if (eFind_Miss!=Ret)
+		{
+			const unsigned char *Record=m_d->Record(*Slot);
+
+			CDiskCachePrivate::CRecordHeader Header;
+			memcpy(&Header,Record,sizeof(Header));
+
+			const unsigned char *Validators=Record+sizeof(Header)+Header.m_KeyLength;
+			const unsigned char *Compressed=Validators+Header.m_ETagLength+Header.m_LastModifiedLength;
+
+			Data.resize(Header.m_DataLength);
+			uLongf DataLength=Header.m_DataLength;
+
+			if (sizeof(Header)+Header.m_KeyLength+Header.m_ETagLength+Header.m_LastModifiedLength+Header.m_CompressedLength<=Slot->m_Length &&
+						Z_OK==uncompress(&Data[0],&DataLength,Compressed,Header.m_CompressedLength) &&
+						DataLength==Header.m_DataLength)
+			{
+				ETag.assign(reinterpret_cast<const char *>(Validators),Header.m_ETagLength);
+				LastModified.assign(reinterpret_cast<const char *>(Validators)+Header.m_ETagLength,Header.m_LastModifiedLength);
+			}
+			else
+			{
+				Data.clear();
+				Ret=eFind_Miss;
+			}
+		}
+	}
+
+	if (eFind_Fresh==Ret || eFind_Stale==Ret)
+		m_d->m_Hits++;
+	else
+		m_d->m_Misses++;
+
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+void MusicBrainz5::CDiskCache::Refresh(const std::string& Key)
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+
+	if (m_d->m_Header)
+	{
+		bool Found;
+		CDiskCachePrivate::CSlot *Slot=m_d->Probe(Key,CDiskCachePrivate::Hash(Key),Found);
+
+		if (Found)
+			Slot->m_Stored=time(0);
+	}
+
+	pthread_mutex_unlock(&m_d->m_Lock);
+}
+
+void MusicBrainz5::CDiskCache::Store(const std::string& Key, const unsigned char *Data, size_t Length, const std::string& ETag, const std::string& LastModified)
+{
+	if (!Data || 0==Length)
+		return;
+
+	// Compress outside the lock
+
+	size_t HeaderLength=sizeof(CDiskCachePrivate::CRecordHeader)+Key.length()+ETag.length()+LastModified.length();
+	uLongf CompressedLength=compressBound(Length);
+	std::vector<unsigned char> Record(HeaderLength+CompressedLength);
+
+	if (Z_OK!=compress(&Record[HeaderLength],&CompressedLength,Data,Length))
+		return;
+
+	CDiskCachePrivate::CRecordHeader Header;
+	Header.m_Magic=RECORD_MAGIC;
+	Header.m_KeyLength=Key.length();
+	Header.m_DataLength=Length;
+	Header.m_CompressedLength=CompressedLength;
+	Header.m_ETagLength=ETag.length();
+	Header.m_LastModifiedLength=LastModified.length();
+
+	unsigned char *Pos=&Record[0];
+	memcpy(Pos,&Header,sizeof(Header));
+	Pos+=sizeof(Header);
+	memcpy(Pos,Key.c_str(),Key.length());
+	Pos+=Key.length();
+	memcpy(Pos,ETag.c_str(),ETag.length());
+	Pos+=ETag.length();
+	memcpy(Pos,LastModified.c_str(),LastModified.length());
+
+	Record.resize(HeaderLength+CompressedLength);
+
+	if (Record.size()>SEGMENT_SIZE)
+		return;
+
+	pthread_mutex_lock(&m_d->m_Lock);
+
+	if (m_d->m_Header)
+	{
+		CDiskCachePrivate::CIndexHeader *IndexHeader=m_d->m_Header;
+
+		if (m_d->m_DiskSize+Record.size()>m_d->m_MaxSize || IndexHeader->m_Count+1>IndexHeader->m_NumSlots*3/4)
+			m_d->Compact(m_d->m_MaxSize/2,IndexHeader->m_NumSlots/2);
+
+		uint64_t KeyHash=CDiskCachePrivate::Hash(Key);
+		uint32_t Segment;
+		uint64_t Offset;
+
+		IndexHeader->m_Dirty=1;
+
+		if (m_d->Append(&Record[0],Record.size(),false,Segment,Offset))
+		{
+			bool Found;
+			CDiskCachePrivate::CSlot *Slot=m_d->Probe(Key,KeyHash,Found);
+
+			Slot->m_Hash=KeyHash;
+			Slot->m_Offset=Offset;
+			Slot->m_Stored=time(0);
+			Slot->m_Segment=Segment;
+			Slot->m_Length=Record.size();
+
+			if (!Found)
+				IndexHeader->m_Count++;
+		}
+
+		IndexHeader->m_Dirty=0;
+	}
+
+	pthread_mutex_unlock(&m_d->m_Lock);
+}
@@ -31,17 +31,168 @@
 #include "musicbrainz5/RelationList.h"
 #include "musicbrainz5/RelationListList.h"
 
-class MusicBrainz5::CEntityPrivate
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <limits.h>
+#include <ctype.h>
+
+#ifdef HAVE_STRTOD_L
+#include <locale.h>
+#include <pthread.h>
+#ifdef HAVE_XLOCALE_H
+#include <xlocale.h>
+#endif
+#endif
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+class MusicBrainz5::CEntityPrivate: public CSharedData
 {
 	public:
 		CEntityPrivate()
+		:	m_Extensions(0)
 		{
 		}
 
-		std::map<std::string,std::string> m_ExtAttributes;
-		std::map<std::string,std::string> m_ExtElements;
+		~CEntityPrivate()
+		{
+			delete m_Extensions;
+		}
+
+		// Only allocated once an extension attribute or element is found, which most
+		// entities never have
+
+		class CExtensions
+		{
+			public:
+				std::map<std::string,std::string> m_Attributes;
+				std::map<std::string,std::string> m_Elements;
+		};
+
+		CExtensions *Extensions()
+		{
+			if (!m_Extensions)
+				m_Extensions=new CExtensions;
+
+			return m_Extensions;
+		}
+
+		static bool IsExtension(const char *Prefix)
+		{
+			return Prefix && 0==strcmp(Prefix,"ext");
+		}
+
+		CExtensions *m_Extensions;
 };
 
+// Numbers are parsed in place, without the locale handling and allocations of a
+// stringstream. As with one, leading white space and trailing text are skipped, and the
+// value is 0 if no number could be read.
+
+static bool ParseNumber(const char *Text, int& RetVal)
+{
+	RetVal=0;
+
+	if (!Text)
+		return false;
+
+	char *End;
+	errno=0;
+	long Value=strtol(Text,&End,10);
+
+	if (End==Text)
+		return false;
+
+	// Out of range values are clamped, as a stream would
+
+	if (ERANGE==errno || Value<INT_MIN || Value>INT_MAX)
+	{
+		RetVal=Value<0 ? INT_MIN : INT_MAX;
+		return false;
+	}
+
+	RetVal=static_cast<int>(Value);
+
+	return true;
+}
+
+#if !defined(__cpp_lib_to_chars) && defined(HAVE_STRTOD_L)
+static locale_t CLocale()
+{
+	static locale_t Locale=0;
+	static pthread_once_t Once=PTHREAD_ONCE_INIT;
+
+	struct CInit
+	{
+		static void Init()
+		{
+			Locale=newlocale(LC_ALL_MASK,"C",0);
+		}
+	};
+
+	pthread_once(&Once,CInit::Init);
+
+	return Locale;
+}
+#endif
+
+static bool ParseNumber(const char *Text, double& RetVal)
+{
+	RetVal=0;
+
+	if (!Text)
+		return false;
+
+	while (isspace(static_cast<unsigned char>(*Text)))
+		Text++;
+
+#ifdef __cpp_lib_to_chars
+	// from_chars only takes a minus sign
+
+	if ('+'==*Text && '-'!=Text[1])
+		Text++;
+
+	std::from_chars_result Result=std::from_chars(Text,Text+strlen(Text),RetVal);
+
+	if (Result.ec!=std::errc())
+	{
+		RetVal=0;
+		return false;
+	}
+#else
+	// Plain strtod would follow the decimal point of the application's locale, so the
+	// number is read in the "C" locale, or failing that by a stream in the classic one
+
+#ifdef HAVE_STRTOD_L
+	locale_t Locale=CLocale();
+	if (Locale)
+	{
+		char *End;
+		RetVal=strtod_l(Text,&End,Locale);
+
+		return End!=Text;
+	}
+#endif
+
+	std::istringstream Stream(Text);
+	Stream.imbue(std::locale::classic());
+
+	Stream >> RetVal;
+	if (Stream.fail())
+	{
+		RetVal=0;
+		return false;
+	}
+#endif
+
+	return true;
+}
+
 MusicBrainz5::CEntity::CEntity()
 :	m_d(new CEntityPrivate)
 {
@@ -57,41 +208,80 @@ MusicBrainz5::CEntity& MusicBrainz5::CEntity::operator =(const CEntity& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
-		m_d->m_ExtAttributes=Other.m_d->m_ExtAttributes;
-		m_d->m_ExtElements=Other.m_d->m_ExtElements;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			if (Other.m_d->m_Extensions)
+				m_d->m_Extensions=new CEntityPrivate::CExtensions(*Other.m_d->m_Extensions);
+		}
+	}
+
+	return *this;
+}
+
+#if __cplusplus >= 201103L
+MusicBrainz5::CEntity::CEntity(CEntity&& Other)
+:	m_d(new CEntityPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CEntity& MusicBrainz5::CEntity::operator =(CEntity&& Other)
+{
+	if (this!=&Other)
+	{
+		// Entities only take over each other's data if it was allocated from the same arena
+		// (or both from the heap), and is not immutable. Otherwise it could be freed along
+		// with the wrong arena, or be emptied under the other entities that share it, so it
+		// is shared or copied instead.
+
+		if (CSharedData::CanMove(m_d,Other.m_d))
+			std::swap(m_d,Other.m_d);
+		else
+			*this=Other;
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CEntity::~CEntity()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::CEntity::Cleanup()
 {
+	delete m_d->m_Extensions;
+	m_d->m_Extensions=0;
 }
 
 void MusicBrainz5::CEntity::Parse(const XMLNode& Node)
 {
 	if (!Node.isEmpty())
 	{
+		// Lets a streaming parser find the entity created for a node
+
+		Node.setUserData(this);
+
 		for (XMLAttribute Attr = Node.getAttribute();
 		    !Attr.isEmpty();
 		    Attr = Attr.next())
 		{
-			std::string Name=Attr.name();
-			std::string Value=Attr.value();
+			// Extension attributes are in the "ext" namespace, and are named without
+			// their prefix
 
-			if ("ext:"==Name.substr(0,4))
-				m_d->m_ExtAttributes[Name.substr(4)]=Value;
+			if (CEntityPrivate::IsExtension(Attr.getPrefix()))
+				m_d->Extensions()->m_Attributes[Attr.getName()]=Attr.getValue();
 			else
-				ParseAttribute(Name,Value);
+				ParseAttribute(Attr.getName(),Attr.getValue());
 		}
 
 		//std::cout << "Node: " << std::endl << Node.createXMLString(true) << std::endl;
@@ -100,27 +290,93 @@ void MusicBrainz5::CEntity::Parse(const XMLNode& Node)
 		     !ChildNode.isEmpty();
 		     ChildNode = ChildNode.next())
 		{
-			std::string Name=ChildNode.getName();
-			std::string Value;
-			if (ChildNode.getText())
-				Value=ChildNode.getText();
-
-			if ("ext:"==Name.substr(0,4))
-				m_d->m_ExtElements[Name.substr(4)]=Value;
-			else
-				ParseElement(ChildNode);
+			ParseChild(ChildNode);
 		}
 	}
 }
 
+void MusicBrainz5::CEntity::ParseChild(const XMLNode& Node)
+{
+	if (CEntityPrivate::IsExtension(Node.getPrefix()))
+	{
+		std::string Value;
+		if (Node.getText())
+			Value=Node.getText();
+
+		m_d->Extensions()->m_Elements[Node.getName()]=Value;
+	}
+	else
+		ParseElement(Node);
+}
+
 std::map<std::string,std::string> MusicBrainz5::CEntity::ExtAttributes() const
 {
-	return m_d->m_ExtAttributes;
+	std::map<std::string,std::string> Ret;
+
+	if (m_d->m_Extensions)
+		Ret=m_d->m_Extensions->m_Attributes;
+
+	return Ret;
 }
 
 std::map<std::string,std::string> MusicBrainz5::CEntity::ExtElements() const
 {
-	return m_d->m_ExtElements;
+	std::map<std::string,std::string> Ret;
+
+	if (m_d->m_Extensions)
+		Ret=m_d->m_Extensions->m_Elements;
+
+	return Ret;
+}
+
+void MusicBrainz5::CEntity::ProcessItem(const XMLNode& Node, int& RetVal)
+{
+	if (!ParseNumber(Node.getText(),RetVal))
+	{
+#ifdef _MB5_DEBUG_
+		std::cerr << "Error parsing value '" << (Node.getText() ? Node.getText() : "") << "'" << std::endl;
+#endif
+	}
+}
+
+void MusicBrainz5::CEntity::ProcessItem(const XMLNode& Node, double& RetVal)
+{
+	if (!ParseNumber(Node.getText(),RetVal))
+	{
+#ifdef _MB5_DEBUG_
+		std::cerr << "Error parsing value '" << (Node.getText() ? Node.getText() : "") << "'" << std::endl;
+#endif
+	}
+}
+
+void MusicBrainz5::CEntity::ProcessItem(const std::string& Text, int& RetVal)
+{
+	ProcessItem(Text.c_str(),RetVal);
+}
+
+void MusicBrainz5::CEntity::ProcessItem(const std::string& Text, double& RetVal)
+{
+	ProcessItem(Text.c_str(),RetVal);
+}
+
+void MusicBrainz5::CEntity::ProcessItem(const char *Text, int& RetVal)
+{
+	if (!ParseNumber(Text,RetVal))
+	{
+#ifdef _MB5_DEBUG_
+		std::cerr << "Error parsing value '" << Text << "'" << std::endl;
+#endif
+	}
+}
+
+void MusicBrainz5::CEntity::ProcessItem(const char *Text, double& RetVal)
+{
+	if (!ParseNumber(Text,RetVal))
+	{
+#ifdef _MB5_DEBUG_
+		std::cerr << "Error parsing value '" << Text << "'" << std::endl;
+#endif
+	}
 }
 
 void MusicBrainz5::CEntity::ProcessRelationList(const XMLNode& Node, CRelationListList* & RetVal)
@@ -136,10 +392,10 @@ void MusicBrainz5::CEntity::ProcessRelationList(const XMLNode& Node, CRelationLi
 
 std::ostream& MusicBrainz5::CEntity::Serialise(std::ostream& os) const
 {
-	if (!ExtAttributes().empty())
+	if (m_d->m_Extensions && !m_d->m_Extensions->m_Attributes.empty())
 	{
 		os << "Ext attrs: " << std::endl;
-		std::map<std::string,std::string> ExtAttrs=ExtAttributes();
+		const std::map<std::string,std::string>& ExtAttrs=m_d->m_Extensions->m_Attributes;
 		std::map<std::string,std::string>::const_iterator ThisExtAttr=ExtAttrs.begin();
 		while (ThisExtAttr!=ExtAttrs.end())
 		{
@@ -149,10 +405,10 @@ std::ostream& MusicBrainz5::CEntity::Serialise(std::ostream& os) const
 		}
 	}
 
-	if (!ExtElements().empty())
+	if (m_d->m_Extensions && !m_d->m_Extensions->m_Elements.empty())
 	{
 		os << "Ext elements: " << std::endl;
-		std::map<std::string,std::string> ExtElems=ExtElements();
+		const std::map<std::string,std::string>& ExtElems=m_d->m_Extensions->m_Elements;
 		std::map<std::string,std::string>::const_iterator ThisExtElement=ExtElems.begin();
 		while (ThisExtElement!=ExtElems.end())
 		{
@@ -28,10 +28,14 @@
 
 #include "musicbrainz5/FreeDBDisc.h"
 
+#include "musicbrainz5/NameTable.h"
+
+#include <string.h>
+
 #include "musicbrainz5/NonMBTrackList.h"
 #include "musicbrainz5/NonMBTrack.h"
 
-class MusicBrainz5::CFreeDBDiscPrivate
+class MusicBrainz5::CFreeDBDiscPrivate: public CSharedData
 {
 	public:
 		CFreeDBDiscPrivate()
@@ -47,6 +51,28 @@ class MusicBrainz5::CFreeDBDiscPrivate
 		CNonMBTrackList *m_NonMBTrackList;
 };
 
+// Child elements handled by ParseElement
+
+enum
+{
+	eElement_Title,
+	eElement_Artist,
+	eElement_Category,
+	eElement_Year,
+	eElement_NonmbTrackList
+};
+
+static const MusicBrainz5::CNameTable::CEntry ElementEntries[]=
+{
+	{ "title", eElement_Title },
+	{ "artist", eElement_Artist },
+	{ "category", eElement_Category },
+	{ "year", eElement_Year },
+	{ "nonmb-track-list", eElement_NonmbTrackList }
+};
+
+static const MusicBrainz5::CNameTable Elements(ElementEntries,sizeof(ElementEntries)/sizeof(ElementEntries[0]));
+
 MusicBrainz5::CFreeDBDisc::CFreeDBDisc(const XMLNode& Node)
 :	CEntity(),
 	m_d(new CFreeDBDiscPrivate)
@@ -70,28 +96,60 @@ MusicBrainz5::CFreeDBDisc& MusicBrainz5::CFreeDBDisc::operator =(const CFreeDBDi
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
-		m_d->m_Title=Other.m_d->m_Title;
-		m_d->m_Artist=Other.m_d->m_Artist;
-		m_d->m_Category=Other.m_d->m_Category;
-		m_d->m_Year=Other.m_d->m_Year;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_ID=Other.m_d->m_ID;
+			m_d->m_Title=Other.m_d->m_Title;
+			m_d->m_Artist=Other.m_d->m_Artist;
+			m_d->m_Category=Other.m_d->m_Category;
+			m_d->m_Year=Other.m_d->m_Year;
+
+			if (Other.m_d->m_NonMBTrackList)
+				m_d->m_NonMBTrackList=new CNonMBTrackList(*Other.m_d->m_NonMBTrackList);
+		}
+	}
+
+	return *this;
+}
+
+#if __cplusplus >= 201103L
+MusicBrainz5::CFreeDBDisc::CFreeDBDisc(CFreeDBDisc&& Other)
+:	CEntity(),
+	m_d(new CFreeDBDiscPrivate)
+{
+	*this=std::move(Other);
+}
 
-		if (Other.m_d->m_NonMBTrackList)
-			m_d->m_NonMBTrackList=new CNonMBTrackList(*Other.m_d->m_NonMBTrackList);
+MusicBrainz5::CFreeDBDisc& MusicBrainz5::CFreeDBDisc::operator =(CFreeDBDisc&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CFreeDBDisc::~CFreeDBDisc()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::CFreeDBDisc::Cleanup()
@@ -105,9 +163,9 @@ MusicBrainz5::CFreeDBDisc *MusicBrainz5::CFreeDBDisc::Clone()
 	return new CFreeDBDisc(*this);
 }
 
-void MusicBrainz5::CFreeDBDisc::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CFreeDBDisc::ParseAttribute(const char *Name, const char *Value)
 {
-	if ("id"==Name)
+	if (0==strcmp(Name,"id"))
 		m_d->m_ID=Value;
 	else
 	{
@@ -119,33 +177,33 @@ void MusicBrainz5::CFreeDBDisc::ParseAttribute(const std::string& Name, const st
 
 void MusicBrainz5::CFreeDBDisc::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
-
-	if ("title"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Title);
-	}
-	else if ("artist"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Artist);
-	}
-	else if ("category"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Category);
-	}
-	else if ("year"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Year);
-	}
-	else if ("nonmb-track-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_NonMBTrackList);
-	}
-	else
+	switch (Elements.Find(Node.getName()))
 	{
+		case eElement_Title:
+			ProcessItem(Node,m_d->m_Title);
+			break;
+
+		case eElement_Artist:
+			ProcessItem(Node,m_d->m_Artist);
+			break;
+
+		case eElement_Category:
+			ProcessItem(Node,m_d->m_Category);
+			break;
+
+		case eElement_Year:
+			ProcessItem(Node,m_d->m_Year);
+			break;
+
+		case eElement_NonmbTrackList:
+			ProcessItem(Node,m_d->m_NonMBTrackList);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised freedb disc element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised freedb disc element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -0,0 +1,263 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/HTTPConnectionPool.h"
+
+#include <map>
+#include <list>
+
+#include <time.h>
+#include <pthread.h>
+
+#include "ne_session.h"
+
+class MusicBrainz5::CHTTPConnectionPoolPrivate
+{
+	public:
+		CHTTPConnectionPoolPrivate()
+		:	m_MaxIdle(4),
+			m_IdleTimeout(30),
+			m_CheckLiveness(true),
+			m_Reused(0),
+			m_Created(0)
+		{
+			pthread_mutex_init(&m_Lock,0);
+		}
+
+		~CHTTPConnectionPoolPrivate()
+		{
+			pthread_mutex_destroy(&m_Lock);
+		}
+
+		class CIdleSession
+		{
+			public:
+				ne_session *m_Session;
+				time_t m_LastUsed;
+		};
+
+		typedef std::list<CIdleSession> tIdleList;
+		typedef std::map<std::string,tIdleList> tIdleMap;
+
+		static time_t Now()
+		{
+			struct timespec TimeNow;
+			clock_gettime(CLOCK_MONOTONIC,&TimeNow);
+
+			return TimeNow.tv_sec;
+		}
+
+		void Expire(tIdleList& IdleList, time_t TimeNow)
+		{
+			while (!IdleList.empty() && TimeNow-IdleList.front().m_LastUsed>=m_IdleTimeout)
+			{
+				ne_session_destroy(IdleList.front().m_Session);
+				IdleList.pop_front();
+			}
+		}
+
+		pthread_mutex_t m_Lock;
+		int m_MaxIdle;
+		int m_IdleTimeout;
+		bool m_CheckLiveness;
+		unsigned long m_Reused;
+		unsigned long m_Created;
+		tIdleMap m_Idle;
+};
+
+MusicBrainz5::CHTTPConnectionPool::CHTTPConnectionPool(int MaxIdle, int IdleTimeout)
+:	m_d(new CHTTPConnectionPoolPrivate)
+{
+	m_d->m_MaxIdle=MaxIdle;
+	m_d->m_IdleTimeout=IdleTimeout;
+}
+
+MusicBrainz5::CHTTPConnectionPool::~CHTTPConnectionPool()
+{
+	Clear();
+
+	delete m_d;
+}
+
+void MusicBrainz5::CHTTPConnectionPool::SetMaxIdle(int MaxIdle)
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	m_d->m_MaxIdle=MaxIdle;
+	pthread_mutex_unlock(&m_d->m_Lock);
+}
+
+void MusicBrainz5::CHTTPConnectionPool::SetIdleTimeout(int IdleTimeout)
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	m_d->m_IdleTimeout=IdleTimeout;
+	pthread_mutex_unlock(&m_d->m_Lock);
+}
+
+void MusicBrainz5::CHTTPConnectionPool::SetCheckLiveness(bool CheckLiveness)
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	m_d->m_CheckLiveness=CheckLiveness;
+	pthread_mutex_unlock(&m_d->m_Lock);
+}
+
+int MusicBrainz5::CHTTPConnectionPool::MaxIdle() const
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	int Ret=m_d->m_MaxIdle;
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+int MusicBrainz5::CHTTPConnectionPool::IdleTimeout() const
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	int Ret=m_d->m_IdleTimeout;
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+bool MusicBrainz5::CHTTPConnectionPool::CheckLiveness() const
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	bool Ret=m_d->m_CheckLiveness;
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+unsigned long MusicBrainz5::CHTTPConnectionPool::Reused() const
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	unsigned long Ret=m_d->m_Reused;
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+unsigned long MusicBrainz5::CHTTPConnectionPool::Created() const
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	unsigned long Ret=m_d->m_Created;
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+void MusicBrainz5::CHTTPConnectionPool::Clear()
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+
+	CHTTPConnectionPoolPrivate::tIdleMap::iterator ThisHost=m_d->m_Idle.begin();
+	while (ThisHost!=m_d->m_Idle.end())
+	{
+		CHTTPConnectionPoolPrivate::tIdleList& IdleList=(*ThisHost).second;
+
+		while (!IdleList.empty())
+		{
+			ne_session_destroy(IdleList.front().m_Session);
+			IdleList.pop_front();
+		}
+
+		++ThisHost;
+	}
+
+	m_d->m_Idle.clear();
+
+	pthread_mutex_unlock(&m_d->m_Lock);
+}
+
+ne_session *MusicBrainz5::CHTTPConnectionPool::Acquire(const std::string& Key)
+{
+	ne_session *Session=0;
+
+	pthread_mutex_lock(&m_d->m_Lock);
+
+	CHTTPConnectionPoolPrivate::tIdleMap::iterator ThisHost=m_d->m_Idle.find(Key);
+	if (ThisHost!=m_d->m_Idle.end())
+	{
+		CHTTPConnectionPoolPrivate::tIdleList& IdleList=(*ThisHost).second;
+
+		m_d->Expire(IdleList,CHTTPConnectionPoolPrivate::Now());
+
+		// Most recently used first, it is the most likely to still be open
+
+		if (!IdleList.empty())
+		{
+			Session=IdleList.back().m_Session;
+			IdleList.pop_back();
+
+			m_d->m_Reused++;
+		}
+	}
+
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Session;
+}
+
+void MusicBrainz5::CHTTPConnectionPool::SessionCreated()
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	m_d->m_Created++;
+	pthread_mutex_unlock(&m_d->m_Lock);
+}
+
+void MusicBrainz5::CHTTPConnectionPool::Release(const std::string& Key, ne_session *Session, bool Reusable)
+{
+	ne_session *Destroy=Session;
+
+	pthread_mutex_lock(&m_d->m_Lock);
+
+	if (Reusable && m_d->m_MaxIdle>0)
+	{
+		CHTTPConnectionPoolPrivate::tIdleList& IdleList=m_d->m_Idle[Key];
+		time_t TimeNow=CHTTPConnectionPoolPrivate::Now();
+
+		m_d->Expire(IdleList,TimeNow);
+
+		CHTTPConnectionPoolPrivate::CIdleSession Idle;
+		Idle.m_Session=Session;
+		Idle.m_LastUsed=TimeNow;
+		IdleList.push_back(Idle);
+
+		if ((int)IdleList.size()>m_d->m_MaxIdle)
+		{
+			Destroy=IdleList.front().m_Session;
+			IdleList.pop_front();
+		}
+		else
+			Destroy=0;
+	}
+
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	if (Destroy)
+		ne_session_destroy(Destroy);
+}
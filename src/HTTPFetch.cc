@@ -27,14 +27,22 @@
 #include "musicbrainz5/defines.h"
 
 #include "musicbrainz5/HTTPFetch.h"
+#include "musicbrainz5/HTTPConnectionPool.h"
 
+#include <sstream>
+#include <list>
+
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 
 #include "ne_session.h"
 #include "ne_auth.h"
 #include "ne_string.h"
 #include "ne_request.h"
+#include "ne_compress.h"
+#include "ne_utils.h"
 
 #if defined(__GNUC__)
 __attribute__((constructor))
@@ -56,6 +64,47 @@ static void destroy_neon()
 	ne_sock_exit();
 }
 
+// Response buffers are kept once a fetch is destroyed, so the storage grown for
+// one response can be reused by the next one instead of being reallocated
+
+#define MAX_POOLED_BUFFERS	8
+#define MAX_POOLED_BUFFER_SIZE	(4*1024*1024)
+#define MAX_RESERVE_SIZE	(16*1024*1024)
+
+static pthread_mutex_t BufferPoolLock=PTHREAD_MUTEX_INITIALIZER;
+static std::list<std::vector<unsigned char> > BufferPool;
+
+static void AcquireBuffer(std::vector<unsigned char>& Buffer)
+{
+	pthread_mutex_lock(&BufferPoolLock);
+
+	if (!BufferPool.empty())
+	{
+		Buffer.swap(BufferPool.back());
+		BufferPool.pop_back();
+	}
+
+	pthread_mutex_unlock(&BufferPoolLock);
+}
+
+static void ReleaseBuffer(std::vector<unsigned char>& Buffer)
+{
+	if (0==Buffer.capacity() || Buffer.capacity()>MAX_POOLED_BUFFER_SIZE)
+		return;
+
+	Buffer.clear();
+
+	pthread_mutex_lock(&BufferPoolLock);
+
+	if (BufferPool.size()<MAX_POOLED_BUFFERS)
+	{
+		BufferPool.push_back(std::vector<unsigned char>());
+		BufferPool.back().swap(Buffer);
+	}
+
+	pthread_mutex_unlock(&BufferPoolLock);
+}
+
 class MusicBrainz5::CHTTPFetchPrivate
 {
 	public:
@@ -63,8 +112,84 @@ class MusicBrainz5::CHTTPFetchPrivate
 		:	m_Port(80),
 			m_Result(0),
 			m_Status(0),
-			m_ProxyPort(0)
+			m_ProxyPort(0),
+			m_ConnectionPool(0),
+			m_Compression(false),
+			m_ResponseReader(0),
+			m_ResponseReaderData(0),
+			m_Received(0),
+			m_WireBytes(0)
+		{
+			AcquireBuffer(m_Data);
+		}
+
+		~CHTTPFetchPrivate()
+		{
+			ReleaseBuffer(m_Data);
+		}
+
+		static void Notify(void *userdata, ne_session_status status, const ne_session_status_info *info)
 		{
+			CHTTPFetchPrivate *Private=reinterpret_cast<CHTTPFetchPrivate *>(userdata);
+
+			// Progress counts the bytes of the body as they come off the wire, before any decoding
+
+			if (ne_status_recving==status)
+				Private->m_WireBytes=info->sr.progress;
+		}
+
+		static void PostHeaders(ne_request *req, void *userdata, const ne_status *status)
+		{
+			CHTTPFetchPrivate *Private=reinterpret_cast<CHTTPFetchPrivate *>(userdata);
+
+			const char *ETag=ne_get_response_header(req,"ETag");
+			if (ETag)
+				Private->m_ETag=ETag;
+
+			const char *LastModified=ne_get_response_header(req,"Last-Modified");
+			if (LastModified)
+				Private->m_LastModified=LastModified;
+
+			// Size the buffer for the whole response up front if the server says how big it is
+
+			if (2==status->klass && !Private->m_ResponseReader)
+			{
+				const char *ContentLength=ne_get_response_header(req,"Content-Length");
+				if (ContentLength)
+				{
+					unsigned long Length=strtoul(ContentLength,0,10);
+					if (Length>0 && Length<=MAX_RESERVE_SIZE)
+						Private->m_Data.reserve(Length);
+				}
+			}
+		}
+
+		static uint64_t Hash(const std::string& Value)
+		{
+			// FNV-1a
+
+			uint64_t Ret=14695981039346656037ULL;
+
+			for (std::string::size_type count=0;count<Value.length();count++)
+			{
+				Ret^=(unsigned char)Value[count];
+				Ret*=1099511628211ULL;
+			}
+
+			return Ret;
+		}
+
+		std::string SessionKey() const
+		{
+			// neon keeps the credentials that succeeded on the session, so a session may only be
+			// reused by a fetch with the same passwords. Only a hash of them goes into the key
+
+			std::stringstream os;
+
+			os << m_Host << ":" << m_Port << "|" << m_ProxyHost << ":" << m_ProxyPort << "|" << m_UserName << "|" << m_ProxyUserName;
+			os << "|" << std::hex << Hash(m_Password+'\0'+m_ProxyPassword);
+
+			return os.str();
 		}
 
 		std::string m_UserAgent;
@@ -80,6 +205,16 @@ class MusicBrainz5::CHTTPFetchPrivate
 		int m_ProxyPort;
 		std::string m_ProxyUserName;
 		std::string m_ProxyPassword;
+		CHTTPConnectionPool *m_ConnectionPool;
+		std::string m_IfNoneMatch;
+		std::string m_IfModifiedSince;
+		std::string m_ETag;
+		std::string m_LastModified;
+		bool m_Compression;
+		CHTTPFetch::tResponseReader m_ResponseReader;
+		void *m_ResponseReaderData;
+		size_t m_Received;
+		size_t m_WireBytes;
 };
 
 MusicBrainz5::CHTTPFetch::CHTTPFetch(const std::string& UserAgent, const std::string& Host, int Port)
@@ -161,26 +296,84 @@ void MusicBrainz5::CHTTPFetch::SetProxyPassword(const std::string& ProxyPassword
 	m_d->m_ProxyPassword=ProxyPassword;
 }
 
+void MusicBrainz5::CHTTPFetch::SetConnectionPool(CHTTPConnectionPool *ConnectionPool)
+{
+	m_d->m_ConnectionPool=ConnectionPool;
+}
+
+void MusicBrainz5::CHTTPFetch::SetIfNoneMatch(const std::string& ETag)
+{
+	m_d->m_IfNoneMatch=ETag;
+}
+
+void MusicBrainz5::CHTTPFetch::SetIfModifiedSince(const std::string& LastModified)
+{
+	m_d->m_IfModifiedSince=LastModified;
+}
+
+void MusicBrainz5::CHTTPFetch::SetCompression(bool Compression)
+{
+	m_d->m_Compression=Compression;
+}
+
+void MusicBrainz5::CHTTPFetch::SetResponseReader(tResponseReader ResponseReader, void *UserData)
+{
+	m_d->m_ResponseReader=ResponseReader;
+	m_d->m_ResponseReaderData=UserData;
+}
+
 int MusicBrainz5::CHTTPFetch::Fetch(const std::string& URL, const std::string& Request)
 {
 	int Ret=0;
 
-	m_d->m_Data.clear();
+	std::string Key=m_d->SessionKey();
+	bool Retry=false;
 
-	ne_session *sess=ne_session_create("http", m_d->m_Host.c_str(), m_d->m_Port);
-	if (sess)
+	do
 	{
-		ne_set_useragent(sess, m_d->m_UserAgent.c_str());
+		m_d->m_Data.clear();
+		m_d->m_Received=0;
+		m_d->m_WireBytes=0;
+		m_d->m_ETag.clear();
+		m_d->m_LastModified.clear();
+
+		ne_session *sess=0;
+		bool Reused=false;
 
-		ne_set_server_auth(sess, httpAuth, this);
+		// Only a request that has not already failed on a pooled connection takes one from the pool
 
-		// Use proxy server
-		if (!m_d->m_ProxyHost.empty())
+		if (m_d->m_ConnectionPool && !Retry)
 		{
-			ne_session_proxy(sess, m_d->m_ProxyHost.c_str(), m_d->m_ProxyPort);
-			ne_set_proxy_auth(sess, proxyAuth, this);
+			sess=m_d->m_ConnectionPool->Acquire(Key);
+			Reused=(0!=sess);
+		}
+
+		if (!sess)
+		{
+			sess=ne_session_create("http", m_d->m_Host.c_str(), m_d->m_Port);
+			if (!sess)
+				return Ret;
+
+			ne_set_server_auth(sess, httpAuth, sess);
+
+			// Use proxy server
+			if (!m_d->m_ProxyHost.empty())
+			{
+				ne_session_proxy(sess, m_d->m_ProxyHost.c_str(), m_d->m_ProxyPort);
+				ne_set_proxy_auth(sess, proxyAuth, sess);
+			}
+
+			if (m_d->m_ConnectionPool)
+				m_d->m_ConnectionPool->SessionCreated();
 		}
 
+		// The auth callbacks find the fetch currently using the session through this
+
+		ne_set_session_private(sess, "libmusicbrainz5", this);
+		ne_set_useragent(sess, m_d->m_UserAgent.c_str());
+		ne_hook_post_headers(sess, CHTTPFetchPrivate::PostHeaders, m_d);
+		ne_set_notifier(sess, CHTTPFetchPrivate::Notify, m_d);
+
 		ne_request *req = ne_request_create(sess, Request.c_str(), URL.c_str());
 		if (Request=="PUT")
 			ne_set_request_body_buffer(req,0,0);
@@ -188,64 +381,96 @@ int MusicBrainz5::CHTTPFetch::Fetch(const std::string& URL, const std::string& R
 		if (Request!="GET")
 			ne_set_request_flag(req, NE_REQFLAG_IDEMPOTENT, 0);
 
-		ne_add_response_body_reader(req, ne_accept_2xx, httpResponseReader, &m_d->m_Data);
+		if (!m_d->m_IfNoneMatch.empty())
+			ne_add_request_header(req, "If-None-Match", m_d->m_IfNoneMatch.c_str());
+
+		if (!m_d->m_IfModifiedSince.empty())
+			ne_add_request_header(req, "If-Modified-Since", m_d->m_IfModifiedSince.c_str());
+
+		// The decompressing reader adds the Accept-Encoding header, and inflates the body
+		// as it is received
+
+		ne_decompress *Decompress=0;
+
+		if (m_d->m_Compression && ne_has_support(NE_FEATURE_ZLIB))
+			Decompress=ne_decompress_reader(req, ne_accept_2xx, httpResponseReader, this);
+		else
+			ne_add_response_body_reader(req, ne_accept_2xx, httpResponseReader, this);
 
 		m_d->m_Result = ne_request_dispatch(req);
 		m_d->m_Status = ne_get_status(req)->code;
 
-		Ret=m_d->m_Data.size();
+		Ret=m_d->m_Received;
+
+		if (Decompress)
+			ne_decompress_destroy(Decompress);
 
 		ne_request_destroy(req);
 
 		m_d->m_ErrorMessage = ne_get_error(sess);
 
-		ne_session_destroy(sess);
+		ne_set_notifier(sess, 0, 0);
+		ne_unhook_post_headers(sess, CHTTPFetchPrivate::PostHeaders, m_d);
+		ne_set_session_private(sess, "libmusicbrainz5", 0);
 
-		switch (m_d->m_Result)
-		{
-			case NE_OK:
-				break;
-
-			case NE_CONNECT:
-			case NE_LOOKUP:
-				throw CConnectionError(m_d->m_ErrorMessage);
-				break;
-
-			case NE_TIMEOUT:
-				throw CTimeoutError(m_d->m_ErrorMessage);
-				break;
-
-			case NE_AUTH:
-			case NE_PROXYAUTH:
-				throw CAuthenticationError(m_d->m_ErrorMessage);
-				break;
-
-			default:
-				throw CFetchError(m_d->m_ErrorMessage);
-				break;
-		}
+		// A pooled connection may have been closed by the server while it was idle. Only
+		// a GET is sent again, as the server may have acted on a PUT or DELETE before the
+		// connection failed.
 
-		switch (m_d->m_Status)
-		{
-			case 200:
-				break;
+		Retry=Reused && "GET"==Request && m_d->m_ConnectionPool->CheckLiveness() &&
+					NE_ERROR==m_d->m_Result && 0==m_d->m_Received;
+
+		if (m_d->m_ConnectionPool)
+			m_d->m_ConnectionPool->Release(Key,sess,NE_OK==m_d->m_Result);
+		else
+			ne_session_destroy(sess);
+	} while (Retry);
 
-			case 400:
-				throw CRequestError(m_d->m_ErrorMessage);
-				break;
+	switch (m_d->m_Result)
+	{
+		case NE_OK:
+			break;
+
+		case NE_CONNECT:
+		case NE_LOOKUP:
+			throw CConnectionError(m_d->m_ErrorMessage);
+			break;
+
+		case NE_TIMEOUT:
+			throw CTimeoutError(m_d->m_ErrorMessage);
+			break;
+
+		case NE_AUTH:
+		case NE_PROXYAUTH:
+			throw CAuthenticationError(m_d->m_ErrorMessage);
+			break;
+
+		default:
+			throw CFetchError(m_d->m_ErrorMessage);
+			break;
+	}
 
-			case 401:
-				throw CAuthenticationError(m_d->m_ErrorMessage);
-				break;
+	switch (m_d->m_Status)
+	{
+		case 200:
+		case 304:
+			break;
 
-			case 404:
-				throw CResourceNotFoundError(m_d->m_ErrorMessage);
-				break;
+		case 400:
+			throw CRequestError(m_d->m_ErrorMessage);
+			break;
 
-			default:
-				throw CFetchError(m_d->m_ErrorMessage);
-				break;
-		}
+		case 401:
+			throw CAuthenticationError(m_d->m_ErrorMessage);
+			break;
+
+		case 404:
+			throw CResourceNotFoundError(m_d->m_ErrorMessage);
+			break;
+
+		default:
+			throw CFetchError(m_d->m_ErrorMessage);
+			break;
 	}
 
 	return Ret;
@@ -256,7 +481,10 @@ int MusicBrainz5::CHTTPFetch::httpAuth(void *userdata, const char *realm, int at
 {
 	realm=realm;
 
-	MusicBrainz5::CHTTPFetch *Fetch = (MusicBrainz5::CHTTPFetch *)userdata;
+	MusicBrainz5::CHTTPFetch *Fetch = (MusicBrainz5::CHTTPFetch *)ne_get_session_private((ne_session *)userdata, "libmusicbrainz5");
+	if (!Fetch)
+		return -1;
+
 	strncpy(username, Fetch->m_d->m_UserName.c_str(), NE_ABUFSIZ);
 	strncpy(password, Fetch->m_d->m_Password.c_str(), NE_ABUFSIZ);
 	return attempts;
@@ -267,7 +495,10 @@ int MusicBrainz5::CHTTPFetch::proxyAuth(void *userdata, const char *realm, int a
 {
 	realm=realm;
 
-	MusicBrainz5::CHTTPFetch *Fetch = (MusicBrainz5::CHTTPFetch *)userdata;
+	MusicBrainz5::CHTTPFetch *Fetch = (MusicBrainz5::CHTTPFetch *)ne_get_session_private((ne_session *)userdata, "libmusicbrainz5");
+	if (!Fetch)
+		return -1;
+
 	strncpy(username, Fetch->m_d->m_ProxyUserName.c_str(), NE_ABUFSIZ);
 	strncpy(password, Fetch->m_d->m_ProxyPassword.c_str(), NE_ABUFSIZ);
 	return attempts;
@@ -275,9 +506,14 @@ int MusicBrainz5::CHTTPFetch::proxyAuth(void *userdata, const char *realm, int a
 
 int MusicBrainz5::CHTTPFetch::httpResponseReader(void *userdata, const char *buf, size_t len)
 {
-	std::vector<unsigned char> *buffer = reinterpret_cast<std::vector<unsigned char> *>(userdata);
+	MusicBrainz5::CHTTPFetch *Fetch = (MusicBrainz5::CHTTPFetch *)userdata;
+
+	Fetch->m_d->m_Received+=len;
 
-	buffer->insert(buffer->end(),buf,buf+len);
+	if (Fetch->m_d->m_ResponseReader)
+		return Fetch->m_d->m_ResponseReader(Fetch->m_d->m_ResponseReaderData,buf,len);
+
+	Fetch->m_d->m_Data.insert(Fetch->m_d->m_Data.end(),buf,buf+len);
 
 	return 0;
 }
@@ -287,6 +523,42 @@ std::vector<unsigned char> MusicBrainz5::CHTTPFetch::Data() const
 	return m_d->m_Data;
 }
 
+const unsigned char *MusicBrainz5::CHTTPFetch::DataBuffer() const
+{
+	return m_d->m_Data.empty() ? 0 : &m_d->m_Data[0];
+}
+
+size_t MusicBrainz5::CHTTPFetch::DataSize() const
+{
+	return m_d->m_Data.size();
+}
+
+void MusicBrainz5::CHTTPFetch::TakeData(std::vector<unsigned char>& Data)
+{
+	Data.swap(m_d->m_Data);
+	m_d->m_Data.clear();
+}
+
+size_t MusicBrainz5::CHTTPFetch::WireBytes() const
+{
+	return m_d->m_WireBytes;
+}
+
+size_t MusicBrainz5::CHTTPFetch::DecodedBytes() const
+{
+	return m_d->m_Received;
+}
+
+std::string MusicBrainz5::CHTTPFetch::ETag() const
+{
+	return m_d->m_ETag;
+}
+
+std::string MusicBrainz5::CHTTPFetch::LastModified() const
+{
+	return m_d->m_LastModified;
+}
+
 int MusicBrainz5::CHTTPFetch::Result() const
 {
 	return m_d->m_Result;
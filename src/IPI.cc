@@ -28,7 +28,7 @@
 
 #include "musicbrainz5/IPI.h"
 
-class MusicBrainz5::CIPIPrivate
+class MusicBrainz5::CIPIPrivate: public CSharedData
 {
 	public:
 		CIPIPrivate()
@@ -66,17 +66,46 @@ MusicBrainz5::CIPI& MusicBrainz5::CIPI::operator =(const CIPI& Other)
 {
 	if (this!=&Other)
 	{
+		CSharedData::Unshare(m_d);
+
 		CEntity::operator =(Other);
 
-		m_d->m_IPI=Other.m_d->m_IPI;
+		if (!CSharedData::Share(m_d,Other.m_d))
+			m_d->m_IPI=Other.m_d->m_IPI;
 	}
 
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+MusicBrainz5::CIPI::CIPI(CIPI&& Other)
+:	CEntity(),
+	m_d(new CIPIPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CIPI& MusicBrainz5::CIPI::operator =(CIPI&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CIPI::~CIPI()
 {
-	delete m_d;
+	if (m_d->RemoveReference())
+		delete m_d;
 }
 
 MusicBrainz5::CIPI *MusicBrainz5::CIPI::Clone()
@@ -84,7 +113,7 @@ MusicBrainz5::CIPI *MusicBrainz5::CIPI::Clone()
 	return new CIPI(*this);
 }
 
-void MusicBrainz5::CIPI::ParseAttribute(const std::string& Name, const std::string& /*Value*/)
+void MusicBrainz5::CIPI::ParseAttribute(const char *Name, const char * /*Value*/)
 {
 #ifdef _MB5_DEBUG_
 	std::cerr << "Unrecognised IPI attribute: '" << Name << "'" << std::endl;
@@ -28,10 +28,12 @@
 
 #include "musicbrainz5/ISRC.h"
 
+#include <string.h>
+
 #include "musicbrainz5/RecordingList.h"
 #include "musicbrainz5/Recording.h"
 
-class MusicBrainz5::CISRCPrivate
+class MusicBrainz5::CISRCPrivate: public CSharedData
 {
 	public:
 		CISRCPrivate()
@@ -66,24 +68,56 @@ MusicBrainz5::CISRC& MusicBrainz5::CISRC::operator =(const CISRC& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_ID=Other.m_d->m_ID;
 
-		if (Other.m_d->m_RecordingList)
-			m_d->m_RecordingList=new CRecordingList(*Other.m_d->m_RecordingList);
+			if (Other.m_d->m_RecordingList)
+				m_d->m_RecordingList=new CRecordingList(*Other.m_d->m_RecordingList);
+		}
 	}
 
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+MusicBrainz5::CISRC::CISRC(CISRC&& Other)
+:	CEntity(),
+	m_d(new CISRCPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CISRC& MusicBrainz5::CISRC::operator =(CISRC&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CISRC::~CISRC()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::CISRC::Cleanup()
@@ -97,9 +131,9 @@ MusicBrainz5::CISRC *MusicBrainz5::CISRC::Clone()
 	return new CISRC(*this);
 }
 
-void MusicBrainz5::CISRC::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CISRC::ParseAttribute(const char *Name, const char *Value)
 {
-	if ("id"==Name)
+	if (0==strcmp(Name,"id"))
 		m_d->m_ID=Value;
 	else
 	{
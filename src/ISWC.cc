@@ -28,7 +28,7 @@
 #include "musicbrainz5/ISWC.h"
 
 
-class MusicBrainz5::CISWCPrivate
+class MusicBrainz5::CISWCPrivate: public CSharedData
 {
 	public:
 		CISWCPrivate()
@@ -64,21 +64,51 @@ MusicBrainz5::CISWC& MusicBrainz5::CISWC::operator =(const CISWC& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		m_d->m_ISWC=Other.m_d->m_ISWC;
+		if (!CSharedData::Share(m_d,Other.m_d))
+			m_d->m_ISWC=Other.m_d->m_ISWC;
+	}
+
+	return *this;
+}
+
+#if __cplusplus >= 201103L
+MusicBrainz5::CISWC::CISWC(CISWC&& Other)
+:	CEntity(),
+	m_d(new CISWCPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CISWC& MusicBrainz5::CISWC::operator =(CISWC&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CISWC::~CISWC()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::CISWC::Cleanup()
@@ -90,7 +120,7 @@ MusicBrainz5::CISWC *MusicBrainz5::CISWC::Clone()
 	return new CISWC(*this);
 }
 
-void MusicBrainz5::CISWC::ParseAttribute(const std::string& Name, const std::string& /*Value*/)
+void MusicBrainz5::CISWC::ParseAttribute(const char *Name, const char * /*Value*/)
 {
 #ifdef _MB5_DEBUG_
 	std::cerr << "Unrecognised ISWC attribute: '" << Name << "'" << std::endl;
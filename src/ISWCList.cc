@@ -30,7 +30,7 @@
 
 #include "musicbrainz5/ISWC.h"
 
-class MusicBrainz5::CISWCListPrivate
+class MusicBrainz5::CISWCListPrivate: public CSharedData
 {
 	public:
 		CISWCListPrivate()
@@ -61,15 +61,45 @@ MusicBrainz5::CISWCList& MusicBrainz5::CISWCList::operator =(const CISWCList& Ot
 {
 	if (this!=&Other)
 	{
+		CSharedData::Unshare(m_d);
+
 		CListImpl<CISWC>::operator =(Other);
+
+		CSharedData::Share(m_d,Other.m_d);
+	}
+
+	return *this;
+}
+
+#if __cplusplus >= 201103L
+MusicBrainz5::CISWCList::CISWCList(CISWCList&& Other)
+:	CListImpl<CISWC>(),
+	m_d(new CISWCListPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CISWCList& MusicBrainz5::CISWCList::operator =(CISWCList&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CListImpl<CISWC>::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CISWCList::~CISWCList()
 {
-	delete m_d;
+	if (m_d->RemoveReference())
+		delete m_d;
 }
 
 MusicBrainz5::CISWCList *MusicBrainz5::CISWCList::Clone()
@@ -77,7 +107,7 @@ MusicBrainz5::CISWCList *MusicBrainz5::CISWCList::Clone()
 	return new CISWCList(*this);
 }
 
-void MusicBrainz5::CISWCList::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CISWCList::ParseAttribute(const char *Name, const char *Value)
 {
 	CListImpl<CISWC>::ParseAttribute(Name,Value);
 }
@@ -0,0 +1,1191 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/JSONParser.h"
+
+#include <vector>
+#include <utility>
+
+#include <string.h>
+#include <ctype.h>
+#include <stdio.h>
+
+#include <libxml/tree.h>
+#include <libxml/xmlerror.h>
+
+// Depth beyond which a response is rejected rather than risk running out of stack
+
+#define MAX_DEPTH 64
+
+// Longest text shared through the document's dictionary
+
+#define MAX_SHARED_TEXT 8
+
+// Number of names remembered when converting keys
+
+#define KEY_CACHE_SIZE 64
+
+// Number of element and attribute names remembered
+
+#define NAME_CACHE_SIZE 64
+
+class MusicBrainz5::CJSONParserPrivate
+{
+	public:
+		enum tType
+		{
+			eType_Null=0,
+			eType_False,
+			eType_True,
+			eType_Number,
+			eType_String,
+			eType_Array,
+			eType_Object
+		};
+
+		// How a key is converted, worked out once for each key in a response
+
+		enum tKey
+		{
+			eKey_Ignored=1,
+			eKey_Count=2,
+			eKey_Attribute=4,
+			eKey_Text=8,
+			eKey_Score=16,
+			eKey_Relations=32,
+			eKey_TargetType=64,
+			eKey_Name=128
+		};
+
+		// Values point into the response rather than holding copies. Members of
+		// objects and arrays are linked through m_Next
+
+		class CValue
+		{
+			public:
+				tType m_Type;
+				const char *m_Key;
+				int m_KeyLength;
+				const char *m_Text;
+				int m_TextLength;
+				bool m_Escaped;
+				int m_FirstChild;
+				int m_Next;
+				int m_Size;
+		};
+
+		class CList
+		{
+			public:
+				const char *m_Key;
+				const char *m_List;
+				const char *m_Item;
+				bool m_Counted;
+		};
+
+		class CKey
+		{
+			public:
+				const xmlChar *m_Name;
+				int m_Length;
+				int m_Flags;
+		};
+
+		class CName
+		{
+			public:
+				const char *m_Name;
+				const xmlChar *m_Interned;
+		};
+
+		CJSONParserPrivate(const char *Data, size_t Length)
+		:	m_Pos(Data),
+			m_End(Data+Length),
+			m_Line(1),
+			m_Depth(0),
+			m_Doc(0),
+			m_Ext(0)
+		{
+			memset(m_Keys,0,sizeof(m_Keys));
+			memset(m_Names,0,sizeof(m_Names));
+		}
+
+		bool ParseDocument();
+		int ParseValue();
+		bool ParseString(const char *&Text, int& Length, bool& Escaped);
+		void SkipSpace();
+		int Fail(const char *Message);
+
+		static bool Equals(const CValue& Value, const char *Key);
+		static bool EndsWith(const char *Name, const char *Suffix);
+		static bool IsAttribute(const char *Element, const char *Key);
+		static bool IsText(const char *Element, const char *Key);
+		static const CList *FindList(const char *Key);
+		static const CList *FindItem(const char *Item, int Length);
+		static xmlNodePtr FindChild(xmlNodePtr Node, const char *Name);
+
+		int Member(int Object, const char *Key) const;
+		bool SameName(int NameCredit, int Name) const;
+		bool IsForward(const char *Key, int Index) const;
+		void Text(int Index, const char *&Text, int& Length);
+		const char *Terminated(int Index);
+		static int Classify(const char *Key);
+		const xmlChar *Key(int Index, int& Flags);
+
+		xmlChar *Name(const char *Name);
+		static void AddChild(xmlNodePtr Parent, xmlNodePtr Node);
+		xmlNodePtr NewElement(xmlNodePtr Parent, const char *Name);
+		void NewAttribute(xmlNodePtr Node, xmlNsPtr Ns, const char *Name, const char *Value);
+		void AddText(xmlNodePtr Node, int Index);
+		xmlNodePtr NewTextElement(xmlNodePtr Parent, const char *Name, int Index);
+		void SetCount(xmlNodePtr Node, const char *Name, int Count);
+
+		xmlNodePtr ConvertObject(xmlNodePtr Parent, const char *Name, int Index, const char *Target=0);
+		void ConvertMembers(xmlNodePtr Node, const char *Name, int Index, const char *Target);
+		void ConvertList(xmlNodePtr Node, const CList& List, int Index);
+		void ConvertRelations(xmlNodePtr Node, int Index);
+		void ConvertCount(xmlNodePtr Node, const char *Name, const char *Key, int Index);
+		void ConvertTarget(xmlNodePtr Node, const char *Target, int Index);
+
+		static const char *s_Attributes[][2];
+		static const char *s_Text[][2];
+		static const CList s_Lists[];
+
+		const char *m_Pos;
+		const char *m_End;
+		int m_Line;
+		int m_Depth;
+		std::string m_Error;
+		std::vector<CValue> m_Values;
+		std::string m_Scratch;
+		xmlDocPtr m_Doc;
+		xmlNsPtr m_Ext;
+		CKey m_Keys[KEY_CACHE_SIZE];
+		CName m_Names[NAME_CACHE_SIZE];
+};
+
+// Keys that are attributes of the element they belong to. "id" is an attribute of every element
+
+const char *MusicBrainz5::CJSONParserPrivate::s_Attributes[][2]=
+{
+	{ "alias", "locale" },
+	{ "alias", "sort-name" },
+	{ "alias", "type" },
+	{ "alias", "primary" },
+	{ "alias", "begin-date" },
+	{ "alias", "end-date" },
+	{ "annotation", "type" },
+	{ "artist", "type" },
+	{ "label", "type" },
+	{ "metadata", "created" },
+	{ "name-credit", "joinphrase" },
+	{ "rating", "votes-count" },
+	{ "relation", "type" },
+	{ "release-group", "type" },
+	{ "tag", "count" },
+	{ "user-tag", "count" },
+	{ "work", "type" },
+	{ 0, 0 }
+};
+
+// Keys that hold the text of the element they belong to
+
+const char *MusicBrainz5::CJSONParserPrivate::s_Text[][2]=
+{
+	{ "alias", "name" },
+	{ "rating", "value" },
+	{ "user-rating", "value" },
+	{ 0, 0 }
+};
+
+// Arrays, and the lists they become
+
+const MusicBrainz5::CJSONParserPrivate::CList MusicBrainz5::CJSONParserPrivate::s_Lists[]=
+{
+	{ "aliases", "alias-list", "alias", true },
+	{ "annotations", "annotation-list", "annotation", true },
+	{ "artist-credit", "artist-credit", "name-credit", false },
+	{ "artists", "artist-list", "artist", true },
+	{ "attributes", "attribute-list", "attribute", false },
+	{ "cdstubs", "cdstub-list", "cdstub", true },
+	{ "collections", "collection-list", "collection", true },
+	{ "discs", "disc-list", "disc", true },
+	{ "ipis", "ipi-list", "ipi", false },
+	{ "isrcs", "isrc-list", "isrc", true },
+	{ "iswcs", "iswc-list", "iswc", false },
+	{ "label-info", "label-info-list", "label-info", true },
+	{ "labels", "label-list", "label", true },
+	{ "media", "medium-list", "medium", true },
+	{ "offsets", "offset-list", "offset", true },
+	{ "puids", "puid-list", "puid", true },
+	{ "recordings", "recording-list", "recording", true },
+	{ "release-groups", "release-group-list", "release-group", true },
+	{ "releases", "release-list", "release", true },
+	{ "secondary-types", "secondary-type-list", "secondary-type", false },
+	{ "tags", "tag-list", "tag", false },
+	{ "tracks", "track-list", "track", true },
+	{ "user-tags", "user-tag-list", "user-tag", false },
+	{ "works", "work-list", "work", true },
+	{ 0, 0, 0, false }
+};
+
+int MusicBrainz5::CJSONParserPrivate::Fail(const char *Message)
+{
+	if (m_Error.empty())
+		m_Error=Message;
+
+	return -1;
+}
+
+void MusicBrainz5::CJSONParserPrivate::SkipSpace()
+{
+	while (m_Pos<m_End && (' '==*m_Pos || '\t'==*m_Pos || '\n'==*m_Pos || '\r'==*m_Pos))
+	{
+		if ('\n'==*m_Pos)
+			m_Line++;
+
+		m_Pos++;
+	}
+}
+
+bool MusicBrainz5::CJSONParserPrivate::ParseDocument()
+{
+	// Responses average a value for every 10 to 20 bytes
+
+	m_Values.reserve((m_End-m_Pos)/16);
+
+	SkipSpace();
+
+	if (m_Pos==m_End || '{'!=*m_Pos)
+	{
+		Fail("Expected an object");
+		return false;
+	}
+
+	if (ParseValue()<0)
+		return false;
+
+	SkipSpace();
+
+	if (m_Pos!=m_End)
+	{
+		Fail("Unexpected data after the object");
+		return false;
+	}
+
+	return true;
+}
+
+bool MusicBrainz5::CJSONParserPrivate::ParseString(const char *&Text, int& Length, bool& Escaped)
+{
+	// Escapes are only checked here, and are decoded when the string is used
+
+	const char *Start=++m_Pos;
+
+	Escaped=false;
+
+	while (m_Pos<m_End && '"'!=*m_Pos)
+	{
+		unsigned char Char=*m_Pos;
+
+		if (Char<0x20)
+		{
+			Fail("Control character in string");
+			return false;
+		}
+
+		if ('\\'==Char)
+		{
+			Escaped=true;
+
+			m_Pos++;
+			if (m_Pos==m_End || !*m_Pos || !strchr("\"\\/bfnrtu",*m_Pos))
+			{
+				Fail("Invalid escape in string");
+				return false;
+			}
+
+			if ('u'==*m_Pos)
+			{
+				for (int count=1;count<=4;count++)
+				{
+					if (m_Pos+count>=m_End || !isxdigit(static_cast<unsigned char>(m_Pos[count])))
+					{
+						Fail("Invalid escape in string");
+						return false;
+					}
+				}
+			}
+		}
+
+		m_Pos++;
+	}
+
+	if (m_Pos==m_End)
+	{
+		Fail("Unterminated string");
+		return false;
+	}
+
+	Text=Start;
+	Length=m_Pos-Start;
+
+	m_Pos++;
+
+	return true;
+}
+
+int MusicBrainz5::CJSONParserPrivate::ParseValue()
+{
+	if (m_Pos==m_End)
+		return Fail("Unexpected end of data");
+
+	int Index=m_Values.size();
+
+	CValue Value;
+	Value.m_Type=eType_Null;
+	Value.m_Key=0;
+	Value.m_KeyLength=0;
+	Value.m_Text=m_Pos;
+	Value.m_TextLength=0;
+	Value.m_Escaped=false;
+	Value.m_FirstChild=-1;
+	Value.m_Next=-1;
+	Value.m_Size=0;
+
+	m_Values.push_back(Value);
+
+	char Char=*m_Pos;
+
+	if ('{'==Char || '['==Char)
+	{
+		bool Object='{'==Char;
+		char Close=Object ? '}' : ']';
+		int Last=-1;
+		int Size=0;
+
+		if (++m_Depth>MAX_DEPTH)
+			return Fail("Nesting too deep");
+
+		m_Pos++;
+		SkipSpace();
+
+		if (m_Pos<m_End && Close==*m_Pos)
+			m_Pos++;
+		else
+		{
+			for (;;)
+			{
+				const char *Key=0;
+				int KeyLength=0;
+
+				if (Object)
+				{
+					bool Escaped;
+
+					if (m_Pos==m_End || '"'!=*m_Pos)
+						return Fail("Expected a key");
+
+					if (!ParseString(Key,KeyLength,Escaped))
+						return -1;
+
+					SkipSpace();
+
+					if (m_Pos==m_End || ':'!=*m_Pos)
+						return Fail("Expected ':'");
+
+					m_Pos++;
+					SkipSpace();
+				}
+
+				int Child=ParseValue();
+				if (Child<0)
+					return -1;
+
+				m_Values[Child].m_Key=Key;
+				m_Values[Child].m_KeyLength=KeyLength;
+
+				if (Last<0)
+					m_Values[Index].m_FirstChild=Child;
+				else
+					m_Values[Last].m_Next=Child;
+
+				Last=Child;
+				Size++;
+
+				SkipSpace();
+
+				if (m_Pos<m_End && ','==*m_Pos)
+				{
+					m_Pos++;
+					SkipSpace();
+				}
+				else if (m_Pos<m_End && Close==*m_Pos)
+				{
+					m_Pos++;
+					break;
+				}
+				else
+					return Fail(Object ? "Expected ',' or '}'" : "Expected ',' or ']'");
+			}
+		}
+
+		m_Depth--;
+
+		m_Values[Index].m_Type=Object ? eType_Object : eType_Array;
+		m_Values[Index].m_Size=Size;
+	}
+	else if ('"'==Char)
+	{
+		const char *Text;
+		int Length;
+		bool Escaped;
+
+		if (!ParseString(Text,Length,Escaped))
+			return -1;
+
+		m_Values[Index].m_Type=eType_String;
+		m_Values[Index].m_Text=Text;
+		m_Values[Index].m_TextLength=Length;
+		m_Values[Index].m_Escaped=Escaped;
+	}
+	else if ('-'==Char || (Char>='0' && Char<='9'))
+	{
+		const char *Start=m_Pos;
+
+		while (m_Pos<m_End && ((*m_Pos>='0' && *m_Pos<='9') || '-'==*m_Pos || '+'==*m_Pos || '.'==*m_Pos || 'e'==*m_Pos || 'E'==*m_Pos))
+			m_Pos++;
+
+		m_Values[Index].m_Type=eType_Number;
+		m_Values[Index].m_TextLength=m_Pos-Start;
+	}
+	else
+	{
+		static const char *Literals[]={ "null", "false", "true" };
+		static const tType Types[]={ eType_Null, eType_False, eType_True };
+
+		for (int count=0;count<3;count++)
+		{
+			size_t Length=strlen(Literals[count]);
+
+			if (static_cast<size_t>(m_End-m_Pos)>=Length && 0==strncmp(m_Pos,Literals[count],Length))
+			{
+				m_Pos+=Length;
+				m_Values[Index].m_Type=Types[count];
+				m_Values[Index].m_TextLength=Length;
+
+				return Index;
+			}
+		}
+
+		return Fail("Unexpected character");
+	}
+
+	return Index;
+}
+
+bool MusicBrainz5::CJSONParserPrivate::Equals(const CValue& Value, const char *Key)
+{
+	return Value.m_Key && 0==strncmp(Value.m_Key,Key,Value.m_KeyLength) && 0==Key[Value.m_KeyLength];
+}
+
+bool MusicBrainz5::CJSONParserPrivate::EndsWith(const char *Name, const char *Suffix)
+{
+	size_t NameLength=strlen(Name);
+	size_t SuffixLength=strlen(Suffix);
+
+	return NameLength>SuffixLength && 0==strcmp(Name+NameLength-SuffixLength,Suffix);
+}
+
+bool MusicBrainz5::CJSONParserPrivate::IsAttribute(const char *Element, const char *Key)
+{
+	if (0==strcmp(Key,"id"))
+		return true;
+
+	for (int count=0;s_Attributes[count][0];count++)
+	{
+		if (0==strcmp(Key,s_Attributes[count][1]) && 0==strcmp(Element,s_Attributes[count][0]))
+			return true;
+	}
+
+	return false;
+}
+
+bool MusicBrainz5::CJSONParserPrivate::IsText(const char *Element, const char *Key)
+{
+	for (int count=0;s_Text[count][0];count++)
+	{
+		if (0==strcmp(Key,s_Text[count][1]) && 0==strcmp(Element,s_Text[count][0]))
+			return true;
+	}
+
+	return false;
+}
+
+const MusicBrainz5::CJSONParserPrivate::CList *MusicBrainz5::CJSONParserPrivate::FindList(const char *Key)
+{
+	for (int count=0;s_Lists[count].m_Key;count++)
+	{
+		if (0==strcmp(Key,s_Lists[count].m_Key))
+			return &s_Lists[count];
+	}
+
+	return 0;
+}
+
+const MusicBrainz5::CJSONParserPrivate::CList *MusicBrainz5::CJSONParserPrivate::FindItem(const char *Item, int Length)
+{
+	for (int count=0;s_Lists[count].m_Key;count++)
+	{
+		if (s_Lists[count].m_Counted && 0==strncmp(Item,s_Lists[count].m_Item,Length) && 0==s_Lists[count].m_Item[Length])
+			return &s_Lists[count];
+	}
+
+	return 0;
+}
+
+xmlNodePtr MusicBrainz5::CJSONParserPrivate::FindChild(xmlNodePtr Node, const char *Name)
+{
+	for (xmlNodePtr Child=Node->children;Child;Child=Child->next)
+	{
+		if (XML_ELEMENT_NODE==Child->type && 0==strcmp(reinterpret_cast<const char *>(Child->name),Name))
+			return Child;
+	}
+
+	return 0;
+}
+
+int MusicBrainz5::CJSONParserPrivate::Member(int Object, const char *Key) const
+{
+	for (int Child=m_Values[Object].m_FirstChild;Child>=0;Child=m_Values[Child].m_Next)
+	{
+		if (Equals(m_Values[Child],Key))
+			return Child;
+	}
+
+	return -1;
+}
+
+bool MusicBrainz5::CJSONParserPrivate::IsForward(const char *Key, int Index) const
+{
+	const CValue& Value=m_Values[Index];
+
+	return eType_String==Value.m_Type && 0==strcmp(Key,"direction") &&
+				7==Value.m_TextLength && 0==strncmp(Value.m_Text,"forward",7);
+}
+
+bool MusicBrainz5::CJSONParserPrivate::SameName(int NameCredit, int Name) const
+{
+	int Artist=Member(NameCredit,"artist");
+	if (Artist<0)
+		return false;
+
+	int ArtistName=Member(Artist,"name");
+	if (ArtistName<0)
+		return false;
+
+	const CValue& Credited=m_Values[Name];
+	const CValue& Own=m_Values[ArtistName];
+
+	return Credited.m_TextLength==Own.m_TextLength && 0==strncmp(Credited.m_Text,Own.m_Text,Own.m_TextLength);
+}
+
+void MusicBrainz5::CJSONParserPrivate::Text(int Index, const char *&Text, int& Length)
+{
+	const CValue& Value=m_Values[Index];
+
+	Text=Value.m_Text;
+	Length=Value.m_TextLength;
+
+	if (!Value.m_Escaped)
+		return;
+
+	m_Scratch.clear();
+
+	for (const char *Pos=Value.m_Text;Pos<Value.m_Text+Value.m_TextLength;Pos++)
+	{
+		if ('\\'!=*Pos)
+		{
+			m_Scratch+=*Pos;
+			continue;
+		}
+
+		switch (*++Pos)
+		{
+			case 'b':
+				m_Scratch+='\b';
+				break;
+
+			case 'f':
+				m_Scratch+='\f';
+				break;
+
+			case 'n':
+				m_Scratch+='\n';
+				break;
+
+			case 'r':
+				m_Scratch+='\r';
+				break;
+
+			case 't':
+				m_Scratch+='\t';
+				break;
+
+			case 'u':
+			{
+				unsigned long Code=0;
+				int Digits=0;
+				const char *End=Value.m_Text+Value.m_TextLength;
+
+				// \uXXXX, combining surrogate pairs into one code point
+
+				for (int Unit=0;Unit<2;Unit++)
+				{
+					unsigned long Part=0;
+
+					for (Digits=0;Digits<4 && Pos+1<End && isxdigit(static_cast<unsigned char>(Pos[1]));Digits++)
+					{
+						char Digit=*++Pos;
+						Part=Part*16+(Digit<='9' ? Digit-'0' : (Digit|0x20)-'a'+10);
+					}
+
+					if (0==Unit)
+						Code=Part;
+					else if (Part>=0xdc00 && Part<=0xdfff)
+						Code=0x10000+((Code-0xd800)<<10)+(Part-0xdc00);
+					else
+						Code=0xfffd;
+
+					if (Code<0xd800 || Code>0xdbff || Pos+6>=End || '\\'!=Pos[1] || 'u'!=Pos[2])
+						break;
+
+					Pos+=2;
+				}
+
+				if (4!=Digits || (Code>=0xd800 && Code<=0xdfff))
+					Code=0xfffd;
+
+				if (Code<0x80)
+					m_Scratch+=static_cast<char>(Code);
+				else if (Code<0x800)
+				{
+					m_Scratch+=static_cast<char>(0xc0|(Code>>6));
+					m_Scratch+=static_cast<char>(0x80|(Code&0x3f));
+				}
+				else if (Code<0x10000)
+				{
+					m_Scratch+=static_cast<char>(0xe0|(Code>>12));
+					m_Scratch+=static_cast<char>(0x80|((Code>>6)&0x3f));
+					m_Scratch+=static_cast<char>(0x80|(Code&0x3f));
+				}
+				else
+				{
+					m_Scratch+=static_cast<char>(0xf0|(Code>>18));
+					m_Scratch+=static_cast<char>(0x80|((Code>>12)&0x3f));
+					m_Scratch+=static_cast<char>(0x80|((Code>>6)&0x3f));
+					m_Scratch+=static_cast<char>(0x80|(Code&0x3f));
+				}
+
+				break;
+			}
+
+			default:
+				m_Scratch+=*Pos;
+				break;
+		}
+	}
+
+	Text=m_Scratch.c_str();
+	Length=m_Scratch.length();
+}
+
+const char *MusicBrainz5::CJSONParserPrivate::Terminated(int Index)
+{
+	const char *Value;
+	int Length;
+
+	Text(Index,Value,Length);
+
+	if (Value!=m_Scratch.c_str())
+		m_Scratch.assign(Value,Length);
+
+	return m_Scratch.c_str();
+}
+
+int MusicBrainz5::CJSONParserPrivate::Classify(const char *Key)
+{
+	int Flags=0;
+
+	// Links to the editable type and status of a field have no XML equivalent
+
+	if (EndsWith(Key,"-id"))
+		Flags|=eKey_Ignored;
+
+	if (EndsWith(Key,"-count") || EndsWith(Key,"-offset") || 0==strcmp(Key,"count") || 0==strcmp(Key,"offset"))
+		Flags|=eKey_Count;
+
+	if (0==strcmp(Key,"id"))
+		Flags|=eKey_Attribute;
+
+	for (int count=0;s_Attributes[count][0];count++)
+	{
+		if (0==strcmp(Key,s_Attributes[count][1]))
+			Flags|=eKey_Attribute;
+	}
+
+	for (int count=0;s_Text[count][0];count++)
+	{
+		if (0==strcmp(Key,s_Text[count][1]))
+			Flags|=eKey_Text;
+	}
+
+	if (0==strcmp(Key,"score"))
+		Flags|=eKey_Score;
+	else if (0==strcmp(Key,"relations"))
+		Flags|=eKey_Relations;
+	else if (0==strcmp(Key,"target-type"))
+		Flags|=eKey_TargetType;
+	else if (0==strcmp(Key,"name"))
+		Flags|=eKey_Name;
+
+	return Flags;
+}
+
+const xmlChar *MusicBrainz5::CJSONParserPrivate::Key(int Index, int& Flags)
+{
+	// Names are looked up in the document's dictionary, which gives the terminated
+	// copy that elements and attributes share. The same few keys are used throughout
+	// a response, so the last name found for each slot of a small cache is kept, along
+	// with how the key is converted
+
+	const CValue& Value=m_Values[Index];
+	const char *Key=Value.m_Key;
+	int Length=Value.m_KeyLength;
+	CKey& Cached=m_Keys[Length ? (Length*31+Key[0]+Key[Length-1]*7+Key[Length/2])%KEY_CACHE_SIZE : 0];
+
+	if (!Cached.m_Name || Cached.m_Length!=Length || 0!=memcmp(Cached.m_Name,Key,Length))
+	{
+		Cached.m_Name=xmlDictLookup(m_Doc->dict,reinterpret_cast<const xmlChar *>(Key ? Key : ""),Length);
+		Cached.m_Length=Length;
+		Cached.m_Flags=Classify(reinterpret_cast<const char *>(Cached.m_Name));
+	}
+
+	Flags=Cached.m_Flags;
+
+	return Cached.m_Name;
+}
+
+xmlChar *MusicBrainz5::CJSONParserPrivate::Name(const char *Name)
+{
+	// Names are either keys, which are already in the dictionary, or constants. Both
+	// come from a small set of addresses, so the name for each is remembered. Any other
+	// name must be interned first, as a buffer reused for a different name would find
+	// the old one.
+
+	CName& Cached=m_Names[(reinterpret_cast<size_t>(Name)/sizeof(void *))%NAME_CACHE_SIZE];
+
+	if (Cached.m_Name!=Name)
+	{
+		const xmlChar *Interned=reinterpret_cast<const xmlChar *>(Name);
+
+		if (!xmlDictOwns(m_Doc->dict,Interned))
+			Interned=xmlDictLookup(m_Doc->dict,Interned,-1);
+
+		Cached.m_Name=Name;
+		Cached.m_Interned=Interned;
+	}
+
+	return const_cast<xmlChar *>(Cached.m_Interned);
+}
+
+void MusicBrainz5::CJSONParserPrivate::AddChild(xmlNodePtr Parent, xmlNodePtr Node)
+{
+	// Nodes are always appended, so none of the merging xmlAddChild does is needed
+
+	Node->parent=Parent;
+
+	if (Parent->last)
+	{
+		Node->prev=Parent->last;
+		Parent->last->next=Node;
+	}
+	else
+		Parent->children=Node;
+
+	Parent->last=Node;
+}
+
+xmlNodePtr MusicBrainz5::CJSONParserPrivate::NewElement(xmlNodePtr Parent, const char *Name)
+{
+	// Element and attribute names are taken from the dictionary, rather than looking
+	// them up again for each node
+
+	xmlNodePtr Node=xmlNewDocNodeEatName(m_Doc,0,this->Name(Name),0);
+	AddChild(Parent,Node);
+
+	return Node;
+}
+
+void MusicBrainz5::CJSONParserPrivate::NewAttribute(xmlNodePtr Node, xmlNsPtr Ns, const char *Name, const char *Value)
+{
+	xmlNewNsPropEatName(Node,Ns,this->Name(Name),reinterpret_cast<const xmlChar *>(Value));
+}
+
+void MusicBrainz5::CJSONParserPrivate::AddText(xmlNodePtr Node, int Index)
+{
+	const char *Value;
+	int Length;
+
+	Text(Index,Value,Length);
+
+	// Short values such as numbers and codes are mostly repeated, so are shared
+	// through the dictionary like names are
+
+	xmlNodePtr TextNode=xmlNewDocText(m_Doc,0);
+
+	if (Length<=MAX_SHARED_TEXT)
+		TextNode->content=const_cast<xmlChar *>(xmlDictLookup(m_Doc->dict,reinterpret_cast<const xmlChar *>(Value),Length));
+	else
+		TextNode->content=xmlStrndup(reinterpret_cast<const xmlChar *>(Value),Length);
+
+	AddChild(Node,TextNode);
+}
+
+xmlNodePtr MusicBrainz5::CJSONParserPrivate::NewTextElement(xmlNodePtr Parent, const char *Name, int Index)
+{
+	xmlNodePtr Node=NewElement(Parent,Name);
+
+	AddText(Node,Index);
+
+	return Node;
+}
+
+void MusicBrainz5::CJSONParserPrivate::SetCount(xmlNodePtr Node, const char *Name, int Count)
+{
+	char Value[16];
+
+	snprintf(Value,sizeof(Value),"%d",Count);
+	xmlSetProp(Node,reinterpret_cast<const xmlChar *>(Name),reinterpret_cast<const xmlChar *>(Value));
+}
+
+xmlNodePtr MusicBrainz5::CJSONParserPrivate::ConvertObject(xmlNodePtr Parent, const char *Name, int Index, const char *Target)
+{
+	xmlNodePtr Node=NewElement(Parent,Name);
+
+	ConvertMembers(Node,Name,Index,Target);
+
+	return Node;
+}
+
+void MusicBrainz5::CJSONParserPrivate::ConvertMembers(xmlNodePtr Node, const char *Name, int Index, const char *Target)
+{
+	bool Counts=false;
+
+	for (int Child=m_Values[Index].m_FirstChild;Child>=0;Child=m_Values[Child].m_Next)
+	{
+		const CValue& Value=m_Values[Child];
+
+		if (eType_Null==Value.m_Type || eType_False==Value.m_Type)
+			continue;
+
+		int Flags;
+		const char *Key=reinterpret_cast<const char *>(this->Key(Child,Flags));
+
+		if (Flags&eKey_Ignored)
+			continue;
+
+		// XML only gives the credited name of an artist if it differs from their own, and
+		// only gives the direction of a relation if it is backward
+
+		if ((Flags&eKey_Name) && 0==strcmp(Name,"name-credit") && SameName(Index,Child))
+			continue;
+
+		if (Target && IsForward(Key,Child))
+			continue;
+
+		if (eType_Array==Value.m_Type)
+		{
+			if (Flags&eKey_Relations)
+				ConvertRelations(Node,Child);
+			else
+			{
+				// Lists without a count are left out of XML when they are empty
+
+				const CList *List=FindList(Key);
+				if (List && (List->m_Counted || Value.m_Size>0))
+					ConvertList(Node,*List,Child);
+			}
+		}
+		else if (eType_Object==Value.m_Type)
+		{
+			if (Target && 0==strcmp(Key,Target))
+				ConvertTarget(Node,Target,Child);
+			else
+				ConvertObject(Node,Key,Child);
+		}
+		else if (Flags&eKey_Score)
+			NewAttribute(Node,m_Ext,Key,Terminated(Child));
+		else if ((Flags&eKey_Attribute) && IsAttribute(Name,Key))
+		{
+			// Flags are set in XML by repeating the attribute name
+
+			const char *Attribute=eType_True==Value.m_Type ? Key : Terminated(Child);
+			NewAttribute(Node,0,Key,Attribute);
+		}
+		else if ((Flags&eKey_Text) && IsText(Name,Key))
+			AddText(Node,Child);
+		else if ((Flags&eKey_TargetType) && Target)
+			continue;
+		else if (Flags&eKey_Count)
+			Counts=true;
+		else
+			NewTextElement(Node,Key,Child);
+	}
+
+	// Counts and offsets describe lists, which must all exist first
+
+	if (Counts)
+	{
+		for (int Child=m_Values[Index].m_FirstChild;Child>=0;Child=m_Values[Child].m_Next)
+		{
+			const CValue& Value=m_Values[Child];
+
+			if (eType_Number==Value.m_Type || eType_String==Value.m_Type)
+			{
+				int Flags;
+				const char *Key=reinterpret_cast<const char *>(this->Key(Child,Flags));
+
+				if (Flags&eKey_Count)
+					ConvertCount(Node,Name,Key,Child);
+			}
+		}
+	}
+}
+
+void MusicBrainz5::CJSONParserPrivate::ConvertCount(xmlNodePtr Node, const char *Name, const char *Key, int Index)
+{
+	const char *Separator=strrchr(Key,'-');
+	const char *Attribute=Separator ? Separator+1 : Key;
+	xmlNodePtr List=0;
+
+	if (!Separator)
+	{
+		// The count and offset of a search apply to the list of results
+
+		for (xmlNodePtr Child=Node->children;Child && !List;Child=Child->next)
+		{
+			if (XML_ELEMENT_NODE==Child->type && EndsWith(reinterpret_cast<const char *>(Child->name),"-list"))
+				List=Child;
+		}
+	}
+	else if (0==strcmp(Name,"release") && 0==strcmp(Key,"track-count"))
+	{
+		// A release's total number of tracks is kept with its media
+
+		List=FindChild(Node,"medium-list");
+		if (!List)
+			List=NewElement(Node,"medium-list");
+
+		NewTextElement(List,Key,Index);
+		return;
+	}
+	else
+	{
+		const CList *Entry=FindItem(Key,Separator-Key);
+		if (Entry)
+		{
+			List=FindChild(Node,Entry->m_List);
+			if (!List)
+				List=NewElement(Node,Entry->m_List);
+		}
+	}
+
+	if (List)
+		xmlSetProp(List,reinterpret_cast<const xmlChar *>(Attribute),reinterpret_cast<const xmlChar *>(Terminated(Index)));
+	else
+		NewTextElement(Node,Key,Index);
+}
+
+void MusicBrainz5::CJSONParserPrivate::ConvertList(xmlNodePtr Node, const CList& List, int Index)
+{
+	xmlNodePtr ListNode=NewElement(Node,List.m_List);
+
+	if (List.m_Counted)
+		SetCount(ListNode,"count",m_Values[Index].m_Size);
+
+	int Position=1;
+
+	for (int Child=m_Values[Index].m_FirstChild;Child>=0;Child=m_Values[Child].m_Next,Position++)
+	{
+		const CValue& Value=m_Values[Child];
+
+		if (eType_Object==Value.m_Type)
+			ConvertObject(ListNode,List.m_Item,Child);
+		else if (eType_Array!=Value.m_Type && eType_Null!=Value.m_Type)
+		{
+			// Lists of identifiers and of disc offsets are lists of plain values in JSON
+
+			if (0==strcmp(List.m_Item,"isrc") || 0==strcmp(List.m_Item,"puid"))
+			{
+				xmlNodePtr Item=NewElement(ListNode,List.m_Item);
+				NewAttribute(Item,0,"id",Terminated(Child));
+			}
+			else
+			{
+				xmlNodePtr Item=NewTextElement(ListNode,List.m_Item,Child);
+
+				if (0==strcmp(List.m_Item,"offset"))
+					SetCount(Item,"position",Position);
+			}
+		}
+	}
+}
+
+void MusicBrainz5::CJSONParserPrivate::ConvertRelations(xmlNodePtr Node, int Index)
+{
+	// XML has a separate list of relations for each type of target
+
+	std::vector<std::pair<std::string,xmlNodePtr> > Lists;
+
+	for (int Child=m_Values[Index].m_FirstChild;Child>=0;Child=m_Values[Child].m_Next)
+	{
+		if (eType_Object!=m_Values[Child].m_Type)
+			continue;
+
+		std::string TargetType;
+
+		int Type=Member(Child,"target-type");
+		if (Type>=0 && eType_String==m_Values[Type].m_Type)
+			TargetType=Terminated(Type);
+
+		xmlNodePtr List=0;
+
+		for (std::vector<std::pair<std::string,xmlNodePtr> >::size_type count=0;count<Lists.size() && !List;count++)
+		{
+			if (Lists[count].first==TargetType)
+				List=Lists[count].second;
+		}
+
+		if (!List)
+		{
+			List=NewElement(Node,"relation-list");
+			NewAttribute(List,0,"target-type",TargetType.c_str());
+			Lists.push_back(std::make_pair(TargetType,List));
+		}
+
+		ConvertObject(List,"relation",Child,TargetType.c_str());
+	}
+}
+
+void MusicBrainz5::CJSONParserPrivate::ConvertTarget(xmlNodePtr Node, const char *Target, int Index)
+{
+	int ID=Member(Index,"id");
+
+	if (0==strcmp(Target,"url"))
+	{
+		// URLs are given as the target itself
+
+		int Resource=Member(Index,"resource");
+		xmlNodePtr TargetNode=NewElement(Node,"target");
+
+		if (ID>=0)
+			NewAttribute(TargetNode,0,"id",Terminated(ID));
+
+		if (Resource>=0)
+			AddText(TargetNode,Resource);
+
+		return;
+	}
+
+	if (ID>=0)
+		NewTextElement(Node,"target",ID);
+
+	// Target types are spelt with underscores, where element names use hyphens
+
+	std::string Name(Target);
+	std::string::size_type Underscore;
+
+	while (std::string::npos!=(Underscore=Name.find('_')))
+		Name[Underscore]='-';
+
+	// The local string is at the same address for every target, so it is interned before
+	// Name() sees it
+
+	const xmlChar *Interned=xmlDictLookup(m_Doc->dict,reinterpret_cast<const xmlChar *>(Name.c_str()),Name.length());
+
+	ConvertObject(Node,reinterpret_cast<const char *>(Interned),Index);
+}
+
+bool MusicBrainz5::CJSONParser::IsJSON(const char *Data, size_t Length)
+{
+	for (size_t count=0;count<Length;count++)
+	{
+		if (' '!=Data[count] && '\t'!=Data[count] && '\n'!=Data[count] && '\r'!=Data[count])
+			return '{'==Data[count];
+	}
+
+	return false;
+}
+
+XMLNode *MusicBrainz5::CJSONParser::Parse(const char *Data, size_t Length, const std::string& Entity, XMLResults *Results)
+{
+	CJSONParserPrivate Parser(Data,Length);
+
+	if (!Parser.ParseDocument())
+	{
+		if (Results)
+		{
+			Results->code=XML_ERR_NOT_WELL_BALANCED;
+			Results->line=Parser.m_Line;
+			Results->message=Parser.m_Error;
+		}
+
+		return XMLRootNode::fromDocument(0);
+	}
+
+	xmlDocPtr Doc=xmlNewDoc(reinterpret_cast<const xmlChar *>("1.0"));
+	Doc->dict=xmlDictCreate();
+
+	Parser.m_Doc=Doc;
+
+	xmlNodePtr Root=xmlNewDocNode(Doc,0,reinterpret_cast<const xmlChar *>("metadata"),0);
+	xmlDocSetRootElement(Doc,Root);
+	xmlSetNs(Root,xmlNewNs(Root,reinterpret_cast<const xmlChar *>("http://musicbrainz.org/ns/mmd-2.0#"),0));
+	Parser.m_Ext=xmlNewNs(Root,reinterpret_cast<const xmlChar *>("http://musicbrainz.org/ns/ext#-2.0"),reinterpret_cast<const xmlChar *>("ext"));
+
+	// A lookup returns the entity itself, with its ID. Searches and browses return
+	// the list of results along with its count and offset
+
+	if (Parser.Member(0,"id")>=0)
+		Parser.ConvertObject(Root,"discid"==Entity ? "disc" : Entity.c_str(),0);
+	else
+		Parser.ConvertMembers(Root,"metadata",0,0);
+
+	return XMLRootNode::fromDocument(Doc);
+}
@@ -28,7 +28,10 @@
 
 #include "musicbrainz5/Label.h"
 
+#include "musicbrainz5/NameTable.h"
+
 #include <iostream>
+#include <string.h>
 
 #include "musicbrainz5/Lifespan.h"
 #include "musicbrainz5/IPI.h"
@@ -46,7 +49,7 @@
 #include "musicbrainz5/UserTag.h"
 #include "musicbrainz5/UserTagList.h"
 
-class MusicBrainz5::CLabelPrivate
+class MusicBrainz5::CLabelPrivate: public CSharedData
 {
 	public:
 		CLabelPrivate()
@@ -80,6 +83,48 @@ class MusicBrainz5::CLabelPrivate
 		CRating *m_Rating;
 		CUserRating *m_UserRating;
 };
+// Child elements handled by ParseElement
+
+enum
+{
+	eElement_Name,
+	eElement_SortName,
+	eElement_LabelCode,
+	eElement_IPI,
+	eElement_IPIList,
+	eElement_Disambiguation,
+	eElement_Country,
+	eElement_LifeSpan,
+	eElement_AliasList,
+	eElement_ReleaseList,
+	eElement_RelationList,
+	eElement_TagList,
+	eElement_UserTagList,
+	eElement_Rating,
+	eElement_UserRating
+};
+
+static const MusicBrainz5::CNameTable::CEntry ElementEntries[]=
+{
+	{ "name", eElement_Name },
+	{ "sort-name", eElement_SortName },
+	{ "label-code", eElement_LabelCode },
+	{ "ipi", eElement_IPI },
+	{ "ipi-list", eElement_IPIList },
+	{ "disambiguation", eElement_Disambiguation },
+	{ "country", eElement_Country },
+	{ "life-span", eElement_LifeSpan },
+	{ "alias-list", eElement_AliasList },
+	{ "release-list", eElement_ReleaseList },
+	{ "relation-list", eElement_RelationList },
+	{ "tag-list", eElement_TagList },
+	{ "user-tag-list", eElement_UserTagList },
+	{ "rating", eElement_Rating },
+	{ "user-rating", eElement_UserRating }
+};
+
+static const MusicBrainz5::CNameTable Elements(ElementEntries,sizeof(ElementEntries)/sizeof(ElementEntries[0]));
+
 MusicBrainz5::CLabel::CLabel(const XMLNode& Node)
 :	CEntity(),
 	m_d(new CLabelPrivate)
@@ -103,55 +148,87 @@ MusicBrainz5::CLabel& MusicBrainz5::CLabel::operator =(const CLabel& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
-		m_d->m_Type=Other.m_d->m_Type;
-		m_d->m_Name=Other.m_d->m_Name;
-		m_d->m_SortName=Other.m_d->m_SortName;
-		m_d->m_LabelCode=Other.m_d->m_LabelCode;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_ID=Other.m_d->m_ID;
+			m_d->m_Type=Other.m_d->m_Type;
+			m_d->m_Name=Other.m_d->m_Name;
+			m_d->m_SortName=Other.m_d->m_SortName;
+			m_d->m_LabelCode=Other.m_d->m_LabelCode;
 
-		if (Other.m_d->m_IPIList)
-			m_d->m_IPIList=new CIPIList(*Other.m_d->m_IPIList);
+			if (Other.m_d->m_IPIList)
+				m_d->m_IPIList=new CIPIList(*Other.m_d->m_IPIList);
 
-		m_d->m_Disambiguation=Other.m_d->m_Disambiguation;
-		m_d->m_Country=Other.m_d->m_Country;
+			m_d->m_Disambiguation=Other.m_d->m_Disambiguation;
+			m_d->m_Country=Other.m_d->m_Country;
 
-		if (Other.m_d->m_Lifespan)
-			m_d->m_Lifespan=new CLifespan(*Other.m_d->m_Lifespan);
+			if (Other.m_d->m_Lifespan)
+				m_d->m_Lifespan=new CLifespan(*Other.m_d->m_Lifespan);
 
-		if (Other.m_d->m_AliasList)
-			m_d->m_AliasList=new CAliasList(*Other.m_d->m_AliasList);
+			if (Other.m_d->m_AliasList)
+				m_d->m_AliasList=new CAliasList(*Other.m_d->m_AliasList);
 
-		if (Other.m_d->m_ReleaseList)
-			m_d->m_ReleaseList=new CReleaseList(*Other.m_d->m_ReleaseList);
+			if (Other.m_d->m_ReleaseList)
+				m_d->m_ReleaseList=new CReleaseList(*Other.m_d->m_ReleaseList);
 
-		if (Other.m_d->m_RelationListList)
-			m_d->m_RelationListList=new CRelationListList(*Other.m_d->m_RelationListList);
+			if (Other.m_d->m_RelationListList)
+				m_d->m_RelationListList=new CRelationListList(*Other.m_d->m_RelationListList);
 
-		if (Other.m_d->m_TagList)
-			m_d->m_TagList=new CTagList(*Other.m_d->m_TagList);
+			if (Other.m_d->m_TagList)
+				m_d->m_TagList=new CTagList(*Other.m_d->m_TagList);
 
-		if (Other.m_d->m_UserTagList)
-			m_d->m_UserTagList=new CUserTagList(*Other.m_d->m_UserTagList);
+			if (Other.m_d->m_UserTagList)
+				m_d->m_UserTagList=new CUserTagList(*Other.m_d->m_UserTagList);
 
-		if (Other.m_d->m_Rating)
-			m_d->m_Rating=new CRating(*Other.m_d->m_Rating);
+			if (Other.m_d->m_Rating)
+				m_d->m_Rating=new CRating(*Other.m_d->m_Rating);
 
-		if (Other.m_d->m_UserRating)
-			m_d->m_UserRating=new CUserRating(*Other.m_d->m_UserRating);
+			if (Other.m_d->m_UserRating)
+				m_d->m_UserRating=new CUserRating(*Other.m_d->m_UserRating);
+		}
 	}
 
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+MusicBrainz5::CLabel::CLabel(CLabel&& Other)
+:	CEntity(),
+	m_d(new CLabelPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CLabel& MusicBrainz5::CLabel::operator =(CLabel&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CLabel::~CLabel()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::CLabel::Cleanup()
@@ -189,11 +266,11 @@ MusicBrainz5::CLabel *MusicBrainz5::CLabel::Clone()
 	return new CLabel(*this);
 }
 
-void MusicBrainz5::CLabel::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CLabel::ParseAttribute(const char *Name, const char *Value)
 {
-	if ("id"==Name)
+	if (0==strcmp(Name,"id"))
 		m_d->m_ID=Value;
-	else if ("type"==Name)
+	else if (0==strcmp(Name,"type"))
 		m_d->m_Type=Value;
 	else
 	{
@@ -205,73 +282,73 @@ void MusicBrainz5::CLabel::ParseAttribute(const std::string& Name, const std::st
 
 void MusicBrainz5::CLabel::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
-
-	if ("name"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Name);
-	}
-	else if ("sort-name"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_SortName);
-	}
-	else if ("label-code"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_LabelCode);
-	}
-	else if ("ipi"==NodeName)
-	{
-		//Ignore IPI
-	}
-	else if ("ipi-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_IPIList);
-	}
-	else if ("disambiguation"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Disambiguation);
-	}
-	else if ("country"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Country);
-	}
-	else if ("life-span"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Lifespan);
-	}
-	else if ("alias-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_AliasList);
-	}
-	else if ("release-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ReleaseList);
-	}
-	else if ("relation-list"==NodeName)
-	{
-		ProcessRelationList(Node,m_d->m_RelationListList);
-	}
-	else if ("tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_TagList);
-	}
-	else if ("user-tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserTagList);
-	}
-	else if ("rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Rating);
-	}
-	else if ("user-rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserRating);
-	}
-	else
+	switch (Elements.Find(Node.getName()))
 	{
+		case eElement_Name:
+			ProcessItem(Node,m_d->m_Name);
+			break;
+
+		case eElement_SortName:
+			ProcessItem(Node,m_d->m_SortName);
+			break;
+
+		case eElement_LabelCode:
+			ProcessItem(Node,m_d->m_LabelCode);
+			break;
+
+		case eElement_IPI:
+			//Ignore IPI
+			break;
+
+		case eElement_IPIList:
+			ProcessItem(Node,m_d->m_IPIList);
+			break;
+
+		case eElement_Disambiguation:
+			ProcessItem(Node,m_d->m_Disambiguation);
+			break;
+
+		case eElement_Country:
+			ProcessItem(Node,m_d->m_Country);
+			break;
+
+		case eElement_LifeSpan:
+			ProcessItem(Node,m_d->m_Lifespan);
+			break;
+
+		case eElement_AliasList:
+			ProcessItem(Node,m_d->m_AliasList);
+			break;
+
+		case eElement_ReleaseList:
+			ProcessItem(Node,m_d->m_ReleaseList);
+			break;
+
+		case eElement_RelationList:
+			ProcessRelationList(Node,m_d->m_RelationListList);
+			break;
+
+		case eElement_TagList:
+			ProcessItem(Node,m_d->m_TagList);
+			break;
+
+		case eElement_UserTagList:
+			ProcessItem(Node,m_d->m_UserTagList);
+			break;
+
+		case eElement_Rating:
+			ProcessItem(Node,m_d->m_Rating);
+			break;
+
+		case eElement_UserRating:
+			ProcessItem(Node,m_d->m_UserRating);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised label element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised label element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -30,7 +30,7 @@
 
 #include "musicbrainz5/Label.h"
 
-class MusicBrainz5::CLabelInfoPrivate
+class MusicBrainz5::CLabelInfoPrivate: public CSharedData
 {
 	public:
 		CLabelInfoPrivate()
@@ -65,24 +65,56 @@ MusicBrainz5::CLabelInfo& MusicBrainz5::CLabelInfo::operator =(const CLabelInfo&
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		m_d->m_CatalogNumber=Other.m_d->m_CatalogNumber;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_CatalogNumber=Other.m_d->m_CatalogNumber;
+
+			if (Other.m_d->m_Label)
+				m_d->m_Label=new CLabel(*Other.m_d->m_Label);
+		}
+	}
+
+	return *this;
+}
+
+#if __cplusplus >= 201103L
+MusicBrainz5::CLabelInfo::CLabelInfo(CLabelInfo&& Other)
+:	CEntity(),
+	m_d(new CLabelInfoPrivate)
+{
+	*this=std::move(Other);
+}
 
-		if (Other.m_d->m_Label)
-			m_d->m_Label=new CLabel(*Other.m_d->m_Label);
+MusicBrainz5::CLabelInfo& MusicBrainz5::CLabelInfo::operator =(CLabelInfo&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CLabelInfo::~CLabelInfo()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::CLabelInfo::Cleanup()
@@ -96,7 +128,7 @@ MusicBrainz5::CLabelInfo *MusicBrainz5::CLabelInfo::Clone()
 	return new CLabelInfo(*this);
 }
 
-void MusicBrainz5::CLabelInfo::ParseAttribute(const std::string& Name, const std::string& /*Value*/)
+void MusicBrainz5::CLabelInfo::ParseAttribute(const char *Name, const char * /*Value*/)
 {
 #ifdef _MB5_DEBUG_
 	std::cerr << "Unrecognised labelinfo attribute: '" << Name << "'" << std::endl;
@@ -28,7 +28,7 @@
 
 #include "musicbrainz5/Lifespan.h"
 
-class MusicBrainz5::CLifespanPrivate
+class MusicBrainz5::CLifespanPrivate: public CSharedData
 {
 	public:
 		std::string m_Begin;
@@ -59,19 +59,50 @@ MusicBrainz5::CLifespan& MusicBrainz5::CLifespan::operator =(const CLifespan& Ot
 {
 	if (this!=&Other)
 	{
+		CSharedData::Unshare(m_d);
+
 		CEntity::operator =(Other);
 
-		m_d->m_Begin=Other.m_d->m_Begin;
-		m_d->m_End=Other.m_d->m_End;
-		m_d->m_Ended=Other.m_d->m_Ended;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_Begin=Other.m_d->m_Begin;
+			m_d->m_End=Other.m_d->m_End;
+			m_d->m_Ended=Other.m_d->m_Ended;
+		}
 	}
 
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+MusicBrainz5::CLifespan::CLifespan(CLifespan&& Other)
+:	CEntity(),
+	m_d(new CLifespanPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CLifespan& MusicBrainz5::CLifespan::operator =(CLifespan&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CLifespan::~CLifespan()
 {
-	delete m_d;
+	if (m_d->RemoveReference())
+		delete m_d;
 }
 
 MusicBrainz5::CLifespan *MusicBrainz5::CLifespan::Clone()
@@ -79,7 +110,7 @@ MusicBrainz5::CLifespan *MusicBrainz5::CLifespan::Clone()
 	return new CLifespan(*this);
 }
 
-void MusicBrainz5::CLifespan::ParseAttribute(const std::string& Name, const std::string& /*Value*/)
+void MusicBrainz5::CLifespan::ParseAttribute(const char *Name, const char * /*Value*/)
 {
 #ifdef _MB5_DEBUG_
 	std::cerr << "Unrecognised lifespan attribute: '" << Name << "'" << std::endl;
@@ -28,9 +28,15 @@
 
 #include "musicbrainz5/List.h"
 
+#include <string.h>
 #include <vector>
 
-class MusicBrainz5::CListPrivate
+// Largest number of items the count attribute of a list reserves space for. Search results
+// report the total number of matches in it, but only return up to 100 of them at a time.
+
+#define MAX_RESERVE	100
+
+class MusicBrainz5::CListPrivate: public CSharedData
 {
 public:
 	CListPrivate()
@@ -61,30 +67,62 @@ MusicBrainz5::CList& MusicBrainz5::CList::operator =(const CList& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		m_d->m_Offset=Other.m_d->m_Offset;
-		m_d->m_Count=Other.m_d->m_Count;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_Offset=Other.m_d->m_Offset;
+			m_d->m_Count=Other.m_d->m_Count;
+
+			std::vector<CEntity *>::const_iterator ThisItem=Other.m_d->m_Items.begin();
+			while (ThisItem!=Other.m_d->m_Items.end())
+			{
+				CEntity *Item=(*ThisItem);
+				m_d->m_Items.push_back(Item->Clone());
+				++ThisItem;
+			}
+		}
+	}
 
-		std::vector<CEntity *>::const_iterator ThisItem=Other.m_d->m_Items.begin();
-		while (ThisItem!=Other.m_d->m_Items.end())
+	return *this;
+}
+
+#if __cplusplus >= 201103L
+MusicBrainz5::CList::CList(CList&& Other)
+:	CEntity(),
+	m_d(new CListPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CList& MusicBrainz5::CList::operator =(CList&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
 		{
-			CEntity *Item=(*ThisItem);
-			m_d->m_Items.push_back(Item->Clone());
-			++ThisItem;
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
 		}
+		else
+			*this=Other;
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CList::~CList()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::CList::Cleanup()
@@ -101,12 +139,16 @@ MusicBrainz5::CList *MusicBrainz5::CList::Clone()
 	return new CList(*this);
 }
 
-void MusicBrainz5::CList::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CList::ParseAttribute(const char *Name, const char *Value)
 {
-	if ("offset"==Name)
+	if (0==strcmp(Name,"offset"))
 		ProcessItem(Value,m_d->m_Offset);
-	else if ("count"==Name)
+	else if (0==strcmp(Name,"count"))
+	{
 		ProcessItem(Value,m_d->m_Count);
+
+		Reserve(m_d->m_Count<MAX_RESERVE ? m_d->m_Count : MAX_RESERVE);
+	}
 	else
 	{
 #ifdef _MB5_DEBUG_
@@ -134,6 +176,17 @@ void MusicBrainz5::CList::AddItem(CEntity *Item)
 	m_d->m_Items.push_back(Item);
 }
 
+void MusicBrainz5::CList::Reserve(int Size)
+{
+	if (Size>0)
+		m_d->m_Items.reserve(Size);
+}
+
+MusicBrainz5::CEntity * const *MusicBrainz5::CList::Items() const
+{
+	return m_d->m_Items.empty() ? 0 : &m_d->m_Items[0];
+}
+
 int MusicBrainz5::CList::NumItems() const
 {
 	return m_d->m_Items.size();
@@ -0,0 +1,125 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/LookupResult.h"
+
+class MusicBrainz5::CLookupResultPrivate
+{
+	public:
+		CLookupResultPrivate()
+		:	m_Result(CQuery::eQuery_Success)
+		{
+		}
+
+		std::string m_ID;
+		CQuery::tQueryResult m_Result;
+		std::string m_ErrorMessage;
+		CMetadata m_Metadata;
+};
+
+MusicBrainz5::CLookupResult::CLookupResult(const std::string& ID)
+:	m_d(new CLookupResultPrivate)
+{
+	m_d->m_ID=ID;
+}
+
+MusicBrainz5::CLookupResult::CLookupResult(const CLookupResult& Other)
+:	m_d(new CLookupResultPrivate)
+{
+	*this=Other;
+}
+
+MusicBrainz5::CLookupResult& MusicBrainz5::CLookupResult::operator =(const CLookupResult& Other)
+{
+	if (this!=&Other)
+	{
+		m_d->m_ID=Other.m_d->m_ID;
+		m_d->m_Result=Other.m_d->m_Result;
+		m_d->m_ErrorMessage=Other.m_d->m_ErrorMessage;
+		m_d->m_Metadata=Other.m_d->m_Metadata;
+	}
+
+	return *this;
+}
+
+MusicBrainz5::CLookupResult::~CLookupResult()
+{
+	delete m_d;
+}
+
+void MusicBrainz5::CLookupResult::Set(const CMetadata& Metadata, CQuery::tQueryResult Result, const std::string& ErrorMessage)
+{
+	m_d->m_Metadata=Metadata;
+	m_d->m_Result=Result;
+	m_d->m_ErrorMessage=ErrorMessage;
+}
+
+std::string MusicBrainz5::CLookupResult::ID() const
+{
+	return m_d->m_ID;
+}
+
+MusicBrainz5::CQuery::tQueryResult MusicBrainz5::CLookupResult::Result() const
+{
+	return m_d->m_Result;
+}
+
+std::string MusicBrainz5::CLookupResult::ErrorMessage() const
+{
+	return m_d->m_ErrorMessage;
+}
+
+MusicBrainz5::CMetadata *MusicBrainz5::CLookupResult::Metadata() const
+{
+	return &m_d->m_Metadata;
+}
+
+MusicBrainz5::CRelease *MusicBrainz5::CLookupResult::Release() const
+{
+	return m_d->m_Metadata.Release();
+}
+
+MusicBrainz5::CArtist *MusicBrainz5::CLookupResult::Artist() const
+{
+	return m_d->m_Metadata.Artist();
+}
+
+MusicBrainz5::CRecording *MusicBrainz5::CLookupResult::Recording() const
+{
+	return m_d->m_Metadata.Recording();
+}
+
+MusicBrainz5::CLabel *MusicBrainz5::CLookupResult::Label() const
+{
+	return m_d->m_Metadata.Label();
+}
+
+MusicBrainz5::CWork *MusicBrainz5::CLookupResult::Work() const
+{
+	return m_d->m_Metadata.Work();
+}
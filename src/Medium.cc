@@ -28,16 +28,19 @@
 
 #include "musicbrainz5/Medium.h"
 
+#include "musicbrainz5/NameTable.h"
+
 #include "musicbrainz5/Disc.h"
 #include "musicbrainz5/DiscList.h"
 #include "musicbrainz5/Track.h"
 #include "musicbrainz5/TrackList.h"
 
-class MusicBrainz5::CMediumPrivate
+class MusicBrainz5::CMediumPrivate: public CSharedData
 {
 	public:
 		CMediumPrivate()
 		:	m_Position(0),
+			m_Format(CStringPool::Empty()),
 			m_DiscList(0),
 			m_TrackList(0)
 		{
@@ -45,11 +48,33 @@ class MusicBrainz5::CMediumPrivate
 
 		std::string m_Title;
 		int m_Position;
-		std::string m_Format;
+		const std::string *m_Format;
 		CDiscList *m_DiscList;
 		CTrackList *m_TrackList;
 };
 
+// Child elements handled by ParseElement
+
+enum
+{
+	eElement_Title,
+	eElement_Position,
+	eElement_Format,
+	eElement_DiscList,
+	eElement_TrackList
+};
+
+static const MusicBrainz5::CNameTable::CEntry ElementEntries[]=
+{
+	{ "title", eElement_Title },
+	{ "position", eElement_Position },
+	{ "format", eElement_Format },
+	{ "disc-list", eElement_DiscList },
+	{ "track-list", eElement_TrackList }
+};
+
+static const MusicBrainz5::CNameTable Elements(ElementEntries,sizeof(ElementEntries)/sizeof(ElementEntries[0]));
+
 MusicBrainz5::CMedium::CMedium(const XMLNode& Node)
 :	CEntity(),
 	m_d(new CMediumPrivate)
@@ -73,29 +98,61 @@ MusicBrainz5::CMedium& MusicBrainz5::CMedium::operator =(const CMedium& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		m_d->m_Title=Other.m_d->m_Title;
-		m_d->m_Position=Other.m_d->m_Position;
-		m_d->m_Format=Other.m_d->m_Format;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_Title=Other.m_d->m_Title;
+			m_d->m_Position=Other.m_d->m_Position;
+			m_d->m_Format=Other.m_d->m_Format;
 
-		if (Other.m_d->m_DiscList)
-			m_d->m_DiscList=new CDiscList(*Other.m_d->m_DiscList);
+			if (Other.m_d->m_DiscList)
+				m_d->m_DiscList=new CDiscList(*Other.m_d->m_DiscList);
 
-		if (Other.m_d->m_TrackList)
-			m_d->m_TrackList=new CTrackList(*Other.m_d->m_TrackList);
+			if (Other.m_d->m_TrackList)
+				m_d->m_TrackList=new CTrackList(*Other.m_d->m_TrackList);
+		}
+	}
+
+	return *this;
+}
+
+#if __cplusplus >= 201103L
+MusicBrainz5::CMedium::CMedium(CMedium&& Other)
+:	CEntity(),
+	m_d(new CMediumPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CMedium& MusicBrainz5::CMedium::operator =(CMedium&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CMedium::~CMedium()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::CMedium::Cleanup()
@@ -112,7 +169,7 @@ MusicBrainz5::CMedium *MusicBrainz5::CMedium::Clone()
 	return new CMedium(*this);
 }
 
-void MusicBrainz5::CMedium::ParseAttribute(const std::string& Name, const std::string& /*Value*/)
+void MusicBrainz5::CMedium::ParseAttribute(const char *Name, const char * /*Value*/)
 {
 #ifdef _MB5_DEBUG_
 	std::cerr << "Unrecognised medium attribute: '" << Name << "'" << std::endl;
@@ -123,33 +180,33 @@ void MusicBrainz5::CMedium::ParseAttribute(const std::string& Name, const std::s
 
 void MusicBrainz5::CMedium::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
-
-	if ("title"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Title);
-	}
-	else if ("position"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Position);
-	}
-	else if ("format"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Format);
-	}
-	else if ("disc-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_DiscList);
-	}
-	else if ("track-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_TrackList);
-	}
-	else
+	switch (Elements.Find(Node.getName()))
 	{
+		case eElement_Title:
+			ProcessItem(Node,m_d->m_Title);
+			break;
+
+		case eElement_Position:
+			ProcessItem(Node,m_d->m_Position);
+			break;
+
+		case eElement_Format:
+			ProcessItem(Node,m_d->m_Format);
+			break;
+
+		case eElement_DiscList:
+			ProcessItem(Node,m_d->m_DiscList);
+			break;
+
+		case eElement_TrackList:
+			ProcessItem(Node,m_d->m_TrackList);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised medium element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised medium element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -169,6 +226,11 @@ int MusicBrainz5::CMedium::Position() const
 }
 
 std::string MusicBrainz5::CMedium::Format() const
+{
+	return *m_d->m_Format;
+}
+
+const std::string *MusicBrainz5::CMedium::InternedFormat() const
 {
 	return m_d->m_Format;
 }
@@ -30,7 +30,7 @@
 
 #include "musicbrainz5/Medium.h"
 
-class MusicBrainz5::CMediumListPrivate
+class MusicBrainz5::CMediumListPrivate: public CSharedData
 {
 	public:
 		CMediumListPrivate()
@@ -64,17 +64,46 @@ MusicBrainz5::CMediumList& MusicBrainz5::CMediumList::operator =(const CMediumLi
 {
 	if (this!=&Other)
 	{
+		CSharedData::Unshare(m_d);
+
 		CListImpl<CMedium>::operator =(Other);
 
-		m_d->m_TrackCount=Other.m_d->m_TrackCount;
+		if (!CSharedData::Share(m_d,Other.m_d))
+			m_d->m_TrackCount=Other.m_d->m_TrackCount;
+	}
+
+	return *this;
+}
+
+#if __cplusplus >= 201103L
+MusicBrainz5::CMediumList::CMediumList(CMediumList&& Other)
+:	CListImpl<CMedium>(),
+	m_d(new CMediumListPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CMediumList& MusicBrainz5::CMediumList::operator =(CMediumList&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CListImpl<CMedium>::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CMediumList::~CMediumList()
 {
-	delete m_d;
+	if (m_d->RemoveReference())
+		delete m_d;
 }
 
 MusicBrainz5::CMediumList *MusicBrainz5::CMediumList::Clone()
@@ -82,7 +111,7 @@ MusicBrainz5::CMediumList *MusicBrainz5::CMediumList::Clone()
 	return new CMediumList(*this);
 }
 
-void MusicBrainz5::CMediumList::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CMediumList::ParseAttribute(const char *Name, const char *Value)
 {
 	CListImpl<CMedium>::ParseAttribute(Name,Value);
 }
@@ -28,7 +28,7 @@
 
 #include "musicbrainz5/Message.h"
 
-class MusicBrainz5::CMessagePrivate
+class MusicBrainz5::CMessagePrivate: public CSharedData
 {
 public:
 		std::string m_Text;
@@ -57,17 +57,46 @@ MusicBrainz5::CMessage& MusicBrainz5::CMessage::operator =(const CMessage& Other
 {
 	if (this!=&Other)
 	{
+		CSharedData::Unshare(m_d);
+
 		CEntity::operator =(Other);
 
-		m_d->m_Text=Other.m_d->m_Text;
+		if (!CSharedData::Share(m_d,Other.m_d))
+			m_d->m_Text=Other.m_d->m_Text;
 	}
 
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+MusicBrainz5::CMessage::CMessage(CMessage&& Other)
+:	CEntity(),
+	m_d(new CMessagePrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CMessage& MusicBrainz5::CMessage::operator =(CMessage&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CMessage::~CMessage()
 {
-	delete m_d;
+	if (m_d->RemoveReference())
+		delete m_d;
 }
 
 MusicBrainz5::CMessage *MusicBrainz5::CMessage::Clone()
@@ -75,7 +104,7 @@ MusicBrainz5::CMessage *MusicBrainz5::CMessage::Clone()
 	return new CMessage(*this);
 }
 
-void MusicBrainz5::CMessage::ParseAttribute(const std::string& Name, const std::string& /*Value*/)
+void MusicBrainz5::CMessage::ParseAttribute(const char *Name, const char * /*Value*/)
 {
 #ifdef _MB5_DEBUG_
 	std::cerr << "Unrecognised message attribute: '" << Name << "'" << std::endl;
@@ -28,6 +28,10 @@
 
 #include "musicbrainz5/Metadata.h"
 
+#include "musicbrainz5/NameTable.h"
+
+#include <string.h>
+
 #include "musicbrainz5/Artist.h"
 #include "musicbrainz5/ArtistList.h"
 #include "musicbrainz5/Release.h"
@@ -62,7 +66,7 @@
 #include "musicbrainz5/LabelInfoList.h"
 #include "musicbrainz5/Message.h"
 
-class MusicBrainz5::CMetadataPrivate
+class MusicBrainz5::CMetadataPrivate: public CSharedData
 {
 	public:
 		CMetadataPrivate()
@@ -93,8 +97,14 @@ class MusicBrainz5::CMetadataPrivate
 			m_UserTagList(0),
 			m_CollectionList(0),
 			m_CDStub(0),
-			m_Message(0)
+			m_Message(0),
+			m_Arena(0)
+		{
+		}
+
+		~CMetadataPrivate()
 		{
+			delete m_Arena;
 		}
 
 		std::string m_XMLNS;
@@ -129,8 +139,75 @@ class MusicBrainz5::CMetadataPrivate
 		CCollectionList *m_CollectionList;
 		CCDStub *m_CDStub;
 		CMessage *m_Message;
+		CArena *m_Arena;
+};
+
+// Child elements handled by ParseElement
+
+enum
+{
+	eElement_Artist,
+	eElement_Release,
+	eElement_ReleaseGroup,
+	eElement_Recording,
+	eElement_Label,
+	eElement_Work,
+	eElement_PUID,
+	eElement_ISRC,
+	eElement_Disc,
+	eElement_Rating,
+	eElement_UserRating,
+	eElement_Collection,
+	eElement_ArtistList,
+	eElement_ReleaseList,
+	eElement_ReleaseGroupList,
+	eElement_RecordingList,
+	eElement_LabelList,
+	eElement_WorkList,
+	eElement_ISRCList,
+	eElement_AnnotationList,
+	eElement_CDStubList,
+	eElement_FreeDBDiscList,
+	eElement_TagList,
+	eElement_UserTagList,
+	eElement_CollectionList,
+	eElement_CDStub,
+	eElement_Message
+};
+
+static const MusicBrainz5::CNameTable::CEntry ElementEntries[]=
+{
+	{ "artist", eElement_Artist },
+	{ "release", eElement_Release },
+	{ "release-group", eElement_ReleaseGroup },
+	{ "recording", eElement_Recording },
+	{ "label", eElement_Label },
+	{ "work", eElement_Work },
+	{ "puid", eElement_PUID },
+	{ "isrc", eElement_ISRC },
+	{ "disc", eElement_Disc },
+	{ "rating", eElement_Rating },
+	{ "user-rating", eElement_UserRating },
+	{ "collection", eElement_Collection },
+	{ "artist-list", eElement_ArtistList },
+	{ "release-list", eElement_ReleaseList },
+	{ "release-group-list", eElement_ReleaseGroupList },
+	{ "recording-list", eElement_RecordingList },
+	{ "label-list", eElement_LabelList },
+	{ "work-list", eElement_WorkList },
+	{ "isrc-list", eElement_ISRCList },
+	{ "annotation-list", eElement_AnnotationList },
+	{ "cdstub-list", eElement_CDStubList },
+	{ "freedb-disc-list", eElement_FreeDBDiscList },
+	{ "tag-list", eElement_TagList },
+	{ "user-tag-list", eElement_UserTagList },
+	{ "collection-list", eElement_CollectionList },
+	{ "cdstub", eElement_CDStub },
+	{ "message", eElement_Message }
 };
 
+static const MusicBrainz5::CNameTable Elements(ElementEntries,sizeof(ElementEntries)/sizeof(ElementEntries[0]));
+
 MusicBrainz5::CMetadata::CMetadata(const XMLNode& Node)
 :	CEntity(),
 	m_d(new CMetadataPrivate)
@@ -154,108 +231,175 @@ MusicBrainz5::CMetadata& MusicBrainz5::CMetadata::operator =(const CMetadata& Ot
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		m_d->m_XMLNS=Other.m_d->m_XMLNS;
-		m_d->m_XMLNSExt=Other.m_d->m_XMLNSExt;
-		m_d->m_Generator=Other.m_d->m_Generator;
-		m_d->m_Created=Other.m_d->m_Created;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_XMLNS=Other.m_d->m_XMLNS;
+			m_d->m_XMLNSExt=Other.m_d->m_XMLNSExt;
+			m_d->m_Generator=Other.m_d->m_Generator;
+			m_d->m_Created=Other.m_d->m_Created;
+
+			// A copy of a result built in an arena gets an arena of its own
+
+			delete m_d->m_Arena;
+			m_d->m_Arena=Other.m_d->m_Arena ? new CArena : 0;
+
+			CArenaScope Scope(m_d->m_Arena);
+
+			if (Other.m_d->m_Artist)
+				m_d->m_Artist=new CArtist(*Other.m_d->m_Artist);
+
+			if (Other.m_d->m_Release)
+				m_d->m_Release=new CRelease(*Other.m_d->m_Release);
 
-		if (Other.m_d->m_Artist)
-			m_d->m_Artist=new CArtist(*Other.m_d->m_Artist);
+			if (Other.m_d->m_ReleaseGroup)
+				m_d->m_ReleaseGroup=new CReleaseGroup(*Other.m_d->m_ReleaseGroup);
 
-		if (Other.m_d->m_Release)
-			m_d->m_Release=new CRelease(*Other.m_d->m_Release);
+			if (Other.m_d->m_Recording)
+				m_d->m_Recording=new CRecording(*Other.m_d->m_Recording);
 
-		if (Other.m_d->m_ReleaseGroup)
-			m_d->m_ReleaseGroup=new CReleaseGroup(*Other.m_d->m_ReleaseGroup);
+			if (Other.m_d->m_Label)
+				m_d->m_Label=new CLabel(*Other.m_d->m_Label);
 
-		if (Other.m_d->m_Recording)
-			m_d->m_Recording=new CRecording(*Other.m_d->m_Recording);
+			if (Other.m_d->m_Work)
+				m_d->m_Work=new CWork(*Other.m_d->m_Work);
 
-		if (Other.m_d->m_Label)
-			m_d->m_Label=new CLabel(*Other.m_d->m_Label);
+			if (Other.m_d->m_PUID)
+				m_d->m_PUID=new CPUID(*Other.m_d->m_PUID);
 
-		if (Other.m_d->m_Work)
-			m_d->m_Work=new CWork(*Other.m_d->m_Work);
+			if (Other.m_d->m_ISRC)
+				m_d->m_ISRC=new CISRC(*Other.m_d->m_ISRC);
 
-		if (Other.m_d->m_PUID)
-			m_d->m_PUID=new CPUID(*Other.m_d->m_PUID);
+			if (Other.m_d->m_Disc)
+				m_d->m_Disc=new CDisc(*Other.m_d->m_Disc);
 
-		if (Other.m_d->m_ISRC)
-			m_d->m_ISRC=new CISRC(*Other.m_d->m_ISRC);
+			if (Other.m_d->m_LabelInfoList)
+				m_d->m_LabelInfoList=new CLabelInfoList(*Other.m_d->m_LabelInfoList);
 
-		if (Other.m_d->m_Disc)
-			m_d->m_Disc=new CDisc(*Other.m_d->m_Disc);
+			if (Other.m_d->m_Rating)
+				m_d->m_Rating=new CRating(*Other.m_d->m_Rating);
 
-		if (Other.m_d->m_LabelInfoList)
-			m_d->m_LabelInfoList=new CLabelInfoList(*Other.m_d->m_LabelInfoList);
+			if (Other.m_d->m_UserRating)
+				m_d->m_UserRating=new CUserRating(*Other.m_d->m_UserRating);
 
-		if (Other.m_d->m_Rating)
-			m_d->m_Rating=new CRating(*Other.m_d->m_Rating);
+			if (Other.m_d->m_Collection)
+				m_d->m_Collection=new CCollection(*Other.m_d->m_Collection);
 
-		if (Other.m_d->m_UserRating)
-			m_d->m_UserRating=new CUserRating(*Other.m_d->m_UserRating);
+			if (Other.m_d->m_ArtistList)
+				m_d->m_ArtistList=new CArtistList(*Other.m_d->m_ArtistList);
 
-		if (Other.m_d->m_Collection)
-			m_d->m_Collection=new CCollection(*Other.m_d->m_Collection);
+			if (Other.m_d->m_ReleaseList)
+				m_d->m_ReleaseList=new CReleaseList(*Other.m_d->m_ReleaseList);
 
-		if (Other.m_d->m_ArtistList)
-			m_d->m_ArtistList=new CArtistList(*Other.m_d->m_ArtistList);
+			if (Other.m_d->m_ReleaseGroupList)
+				m_d->m_ReleaseGroupList=new CReleaseGroupList(*Other.m_d->m_ReleaseGroupList);
 
-		if (Other.m_d->m_ReleaseList)
-			m_d->m_ReleaseList=new CReleaseList(*Other.m_d->m_ReleaseList);
+			if (Other.m_d->m_RecordingList)
+				m_d->m_RecordingList=new CRecordingList(*Other.m_d->m_RecordingList);
 
-		if (Other.m_d->m_ReleaseGroupList)
-			m_d->m_ReleaseGroupList=new CReleaseGroupList(*Other.m_d->m_ReleaseGroupList);
+			if (Other.m_d->m_LabelList)
+				m_d->m_LabelList=new CLabelList(*Other.m_d->m_LabelList);
 
-		if (Other.m_d->m_RecordingList)
-			m_d->m_RecordingList=new CRecordingList(*Other.m_d->m_RecordingList);
+			if (Other.m_d->m_WorkList)
+				m_d->m_WorkList=new CWorkList(*Other.m_d->m_WorkList);
 
-		if (Other.m_d->m_LabelList)
-			m_d->m_LabelList=new CLabelList(*Other.m_d->m_LabelList);
+			if (Other.m_d->m_ISRCList)
+				m_d->m_ISRCList=new CISRCList(*Other.m_d->m_ISRCList);
 
-		if (Other.m_d->m_WorkList)
-			m_d->m_WorkList=new CWorkList(*Other.m_d->m_WorkList);
+			if (Other.m_d->m_AnnotationList)
+				m_d->m_AnnotationList=new CAnnotationList(*Other.m_d->m_AnnotationList);
 
-		if (Other.m_d->m_ISRCList)
-			m_d->m_ISRCList=new CISRCList(*Other.m_d->m_ISRCList);
+			if (Other.m_d->m_CDStubList)
+				m_d->m_CDStubList=new CCDStubList(*Other.m_d->m_CDStubList);
 
-		if (Other.m_d->m_AnnotationList)
-			m_d->m_AnnotationList=new CAnnotationList(*Other.m_d->m_AnnotationList);
+			if (Other.m_d->m_FreeDBDiscList)
+				m_d->m_FreeDBDiscList=new CFreeDBDiscList(*Other.m_d->m_FreeDBDiscList);
 
-		if (Other.m_d->m_CDStubList)
-			m_d->m_CDStubList=new CCDStubList(*Other.m_d->m_CDStubList);
+			if (Other.m_d->m_TagList)
+				m_d->m_TagList=new CTagList(*Other.m_d->m_TagList);
 
-		if (Other.m_d->m_FreeDBDiscList)
-			m_d->m_FreeDBDiscList=new CFreeDBDiscList(*Other.m_d->m_FreeDBDiscList);
+			if (Other.m_d->m_UserTagList)
+				m_d->m_UserTagList=new CUserTagList(*Other.m_d->m_UserTagList);
 
-		if (Other.m_d->m_TagList)
-			m_d->m_TagList=new CTagList(*Other.m_d->m_TagList);
+			if (Other.m_d->m_CollectionList)
+				m_d->m_CollectionList=new CCollectionList(*Other.m_d->m_CollectionList);
 
-		if (Other.m_d->m_UserTagList)
-			m_d->m_UserTagList=new CUserTagList(*Other.m_d->m_UserTagList);
+			if (Other.m_d->m_CDStub)
+				m_d->m_CDStub=new CCDStub(*Other.m_d->m_CDStub);
 
-		if (Other.m_d->m_CollectionList)
-			m_d->m_CollectionList=new CCollectionList(*Other.m_d->m_CollectionList);
+			if (Other.m_d->m_Message)
+				m_d->m_Message=new CMessage(*Other.m_d->m_Message);
+		}
+	}
+
+	return *this;
+}
 
-		if (Other.m_d->m_CDStub)
-			m_d->m_CDStub=new CCDStub(*Other.m_d->m_CDStub);
+#if __cplusplus >= 201103L
+MusicBrainz5::CMetadata::CMetadata(CMetadata&& Other)
+:	CEntity(),
+	m_d(new CMetadataPrivate)
+{
+	*this=std::move(Other);
+}
 
-		if (Other.m_d->m_Message)
-			m_d->m_Message=new CMessage(*Other.m_d->m_Message);
+MusicBrainz5::CMetadata& MusicBrainz5::CMetadata::operator =(CMetadata&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CMetadata::~CMetadata()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
+}
+
+void MusicBrainz5::CMetadata::UseArena()
+{
+	if (!m_d->m_Arena)
+	{
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
+
+		m_d->m_Arena=new CArena;
+	}
+}
+
+MusicBrainz5::CArena *MusicBrainz5::CMetadata::Arena() const
+{
+	return m_d->m_Arena;
+}
+
+void MusicBrainz5::CMetadata::SetImmutable(bool Immutable)
+{
+	CSharedData::Unshare(m_d);
+
+	m_d->SetImmutable(Immutable);
+}
+
+bool MusicBrainz5::CMetadata::Immutable() const
+{
+	return m_d->Immutable();
 }
 
 void MusicBrainz5::CMetadata::Cleanup()
@@ -350,15 +494,15 @@ MusicBrainz5::CMetadata *MusicBrainz5::CMetadata::Clone()
 	return new CMetadata(*this);
 }
 
-void MusicBrainz5::CMetadata::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CMetadata::ParseAttribute(const char *Name, const char *Value)
 {
-	if ("xmlns"==Name)
+	if (0==strcmp(Name,"xmlns"))
 		m_d->m_XMLNS=Value;
-	else if ("xmlns:ext"==Name)
+	else if (0==strcmp(Name,"xmlns:ext"))
 		m_d->m_XMLNSExt=Value;
-	else if ("generator"==Name)
+	else if (0==strcmp(Name,"generator"))
 		m_d->m_Generator=Value;
-	else if ("created"==Name)
+	else if (0==strcmp(Name,"created"))
 		m_d->m_Created=Value;
 	else
 	{
@@ -370,121 +514,124 @@ void MusicBrainz5::CMetadata::ParseAttribute(const std::string& Name, const std:
 
 void MusicBrainz5::CMetadata::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	CArenaScope Scope(m_d->m_Arena);
+	CImmutableScope Immutable(m_d->Immutable());
 
-	if ("artist"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Artist);
-	}
-	else if ("release"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Release);
-	}
-	else if ("release-group"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ReleaseGroup);
-	}
-	else if ("recording"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Recording);
-	}
-	else if ("label"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Label);
-	}
-	else if ("work"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Work);
-	}
-	else if ("puid"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_PUID);
-	}
-	else if ("isrc"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ISRC);
-	}
-	else if ("disc"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Disc);
-	}
-	else if ("rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Rating);
-	}
-	else if ("user-rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserRating);
-	}
-	else if ("collection"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Collection);
-	}
-	else if ("artist-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ArtistList);
-	}
-	else if ("release-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ReleaseList);
-	}
-	else if ("release-group-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ReleaseGroupList);
-	}
-	else if ("recording-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_RecordingList);
-	}
-	else if ("label-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_LabelList);
-	}
-	else if ("work-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_WorkList);
-	}
-	else if ("isrc-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ISRCList);
-	}
-	else if ("annotation-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_AnnotationList);
-	}
-	else if ("cdstub-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_CDStubList);
-	}
-	else if ("freedb-disc-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_FreeDBDiscList);
-	}
-	else if ("tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_TagList);
-	}
-	else if ("user-tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserTagList);
-	}
-	else if ("collection-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_CollectionList);
-	}
-	else if ("cdstub"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_CDStub);
-	}
-	else if ("message"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Message);
-	}
-	else
+	switch (Elements.Find(Node.getName()))
 	{
+		case eElement_Artist:
+			ProcessItem(Node,m_d->m_Artist);
+			break;
+
+		case eElement_Release:
+			ProcessItem(Node,m_d->m_Release);
+			break;
+
+		case eElement_ReleaseGroup:
+			ProcessItem(Node,m_d->m_ReleaseGroup);
+			break;
+
+		case eElement_Recording:
+			ProcessItem(Node,m_d->m_Recording);
+			break;
+
+		case eElement_Label:
+			ProcessItem(Node,m_d->m_Label);
+			break;
+
+		case eElement_Work:
+			ProcessItem(Node,m_d->m_Work);
+			break;
+
+		case eElement_PUID:
+			ProcessItem(Node,m_d->m_PUID);
+			break;
+
+		case eElement_ISRC:
+			ProcessItem(Node,m_d->m_ISRC);
+			break;
+
+		case eElement_Disc:
+			ProcessItem(Node,m_d->m_Disc);
+			break;
+
+		case eElement_Rating:
+			ProcessItem(Node,m_d->m_Rating);
+			break;
+
+		case eElement_UserRating:
+			ProcessItem(Node,m_d->m_UserRating);
+			break;
+
+		case eElement_Collection:
+			ProcessItem(Node,m_d->m_Collection);
+			break;
+
+		case eElement_ArtistList:
+			ProcessItem(Node,m_d->m_ArtistList);
+			break;
+
+		case eElement_ReleaseList:
+			ProcessItem(Node,m_d->m_ReleaseList);
+			break;
+
+		case eElement_ReleaseGroupList:
+			ProcessItem(Node,m_d->m_ReleaseGroupList);
+			break;
+
+		case eElement_RecordingList:
+			ProcessItem(Node,m_d->m_RecordingList);
+			break;
+
+		case eElement_LabelList:
+			ProcessItem(Node,m_d->m_LabelList);
+			break;
+
+		case eElement_WorkList:
+			ProcessItem(Node,m_d->m_WorkList);
+			break;
+
+		case eElement_ISRCList:
+			ProcessItem(Node,m_d->m_ISRCList);
+			break;
+
+		case eElement_AnnotationList:
+			ProcessItem(Node,m_d->m_AnnotationList);
+			break;
+
+		case eElement_CDStubList:
+			ProcessItem(Node,m_d->m_CDStubList);
+			break;
+
+		case eElement_FreeDBDiscList:
+			ProcessItem(Node,m_d->m_FreeDBDiscList);
+			break;
+
+		case eElement_TagList:
+			ProcessItem(Node,m_d->m_TagList);
+			break;
+
+		case eElement_UserTagList:
+			ProcessItem(Node,m_d->m_UserTagList);
+			break;
+
+		case eElement_CollectionList:
+			ProcessItem(Node,m_d->m_CollectionList);
+			break;
+
+		case eElement_CDStub:
+			ProcessItem(Node,m_d->m_CDStub);
+			break;
+
+		case eElement_Message:
+			ProcessItem(Node,m_d->m_Message);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised metadata element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised metadata element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -0,0 +1,163 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/MetadataParser.h"
+
+#include <vector>
+#include <cstring>
+
+#include "musicbrainz5/Metadata.h"
+#include "musicbrainz5/List.h"
+#include "musicbrainz5/xmlParser.h"
+
+class MusicBrainz5::CMetadataParserPrivate: public XMLStreamHandler
+{
+	public:
+		CMetadataParserPrivate(CMetadata& Metadata)
+		:	m_Metadata(Metadata),
+			m_Parser(this),
+			m_EntityCallback(0),
+			m_EntityUserData(0)
+		{
+		}
+
+		virtual bool startElement(const XMLNode& Node, int Depth)
+		{
+			bool Stream=false;
+
+			if (1==Depth)
+			{
+				m_Metadata.Parse(Node);
+				m_Open.push_back(&m_Metadata);
+
+				Stream=true;
+			}
+			else if (2==Depth && IsList(Node.getName()))
+			{
+				// Create the list from its attributes, then add its items one at a time
+
+				CEntity *List=0;
+
+				if (m_Open.back())
+				{
+					m_Open.back()->ParseChild(Node);
+					List=reinterpret_cast<CEntity *>(Node.getUserData());
+				}
+
+				m_Open.push_back(List);
+
+				Stream=true;
+			}
+
+			return Stream;
+		}
+
+		virtual void element(const XMLNode& Node, int Depth)
+		{
+			CEntity *Parent=m_Open.back();
+
+			if (Parent)
+			{
+				CList *List=3==Depth && m_EntityCallback ? dynamic_cast<CList *>(Parent) : 0;
+
+				if (List)
+				{
+					// Hand the item to the caller, then free it before the next one is read. It is
+					// not allocated from the arena, which would otherwise keep growing.
+
+					CArenaScope Scope(0);
+					CImmutableScope Immutable(m_Metadata.Immutable());
+
+					int NumItems=List->NumItems();
+
+					List->ParseChild(Node);
+
+					for (int count=NumItems;count<List->NumItems();count++)
+						m_EntityCallback(*List->Item(count),m_EntityUserData);
+
+					List->Cleanup();
+				}
+				else
+				{
+					CArenaScope Scope(m_Metadata.Arena());
+					CImmutableScope Immutable(m_Metadata.Immutable());
+
+					Parent->ParseChild(Node);
+				}
+			}
+		}
+
+		virtual void endElement(const XMLNode& /*Node*/, int /*Depth*/)
+		{
+			m_Open.pop_back();
+		}
+
+		static bool IsList(const char *Name)
+		{
+			size_t Length=strlen(Name);
+
+			return Length>5 && 0==strcmp(Name+Length-5,"-list");
+		}
+
+		CMetadata& m_Metadata;
+		XMLStreamParser m_Parser;
+		std::vector<CEntity *> m_Open;
+		CMetadataParser::tEntityCallback m_EntityCallback;
+		void *m_EntityUserData;
+};
+
+MusicBrainz5::CMetadataParser::CMetadataParser(CMetadata& Metadata)
+:	m_d(new CMetadataParserPrivate(Metadata))
+{
+}
+
+MusicBrainz5::CMetadataParser::~CMetadataParser()
+{
+	delete m_d;
+}
+
+void MusicBrainz5::CMetadataParser::SetEntityCallback(tEntityCallback Callback, void *UserData)
+{
+	m_d->m_EntityCallback=Callback;
+	m_d->m_EntityUserData=UserData;
+}
+
+bool MusicBrainz5::CMetadataParser::ParseChunk(const char *Data, int Length, bool Terminate)
+{
+	return m_d->m_Parser.parseChunk(Data,Length,Terminate);
+}
+
+int MusicBrainz5::CMetadataParser::ErrorCode() const
+{
+	return m_d->m_Parser.results().code;
+}
+
+std::string MusicBrainz5::CMetadataParser::ErrorMessage() const
+{
+	return m_d->m_Parser.results().message;
+}
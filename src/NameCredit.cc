@@ -28,9 +28,11 @@
 
 #include "musicbrainz5/NameCredit.h"
 
+#include <string.h>
+
 #include "musicbrainz5/Artist.h"
 
-class MusicBrainz5::CNameCreditPrivate
+class MusicBrainz5::CNameCreditPrivate: public CSharedData
 {
 	public:
 		CNameCreditPrivate()
@@ -66,25 +68,57 @@ MusicBrainz5::CNameCredit& MusicBrainz5::CNameCredit::operator =(const CNameCred
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		m_d->m_JoinPhrase=Other.m_d->m_JoinPhrase;
-		m_d->m_Name=Other.m_d->m_Name;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_JoinPhrase=Other.m_d->m_JoinPhrase;
+			m_d->m_Name=Other.m_d->m_Name;
 
-		if (Other.m_d->m_Artist)
-			m_d->m_Artist=new CArtist(*Other.m_d->m_Artist);
+			if (Other.m_d->m_Artist)
+				m_d->m_Artist=new CArtist(*Other.m_d->m_Artist);
+		}
 	}
 
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+MusicBrainz5::CNameCredit::CNameCredit(CNameCredit&& Other)
+:	CEntity(),
+	m_d(new CNameCreditPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CNameCredit& MusicBrainz5::CNameCredit::operator =(CNameCredit&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CNameCredit::~CNameCredit()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::CNameCredit::Cleanup()
@@ -98,9 +132,9 @@ MusicBrainz5::CNameCredit *MusicBrainz5::CNameCredit::Clone()
 	return new CNameCredit(*this);
 }
 
-void MusicBrainz5::CNameCredit::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CNameCredit::ParseAttribute(const char *Name, const char *Value)
 {
-	if ("joinphrase"==Name)
+	if (0==strcmp(Name,"joinphrase"))
 		m_d->m_JoinPhrase=Value;
 	else
 	{
@@ -0,0 +1,119 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/NameTable.h"
+
+#include <vector>
+
+#include <string.h>
+
+// Number of seeds tried for a table size before the table is made larger
+
+#define MAX_SEEDS	256
+
+class MusicBrainz5::CNameTablePrivate
+{
+	public:
+		CNameTablePrivate()
+		:	m_Seed(0),
+			m_Mask(0)
+		{
+		}
+
+		static unsigned int Hash(const char *Name, unsigned int Seed)
+		{
+			// FNV-1a, with the seed mixed into the offset basis
+
+			unsigned int Ret=2166136261U^Seed;
+
+			while (*Name)
+			{
+				Ret^=static_cast<unsigned char>(*Name++);
+				Ret*=16777619U;
+			}
+
+			return Ret^(Ret>>15);
+		}
+
+		bool Build(const CNameTable::CEntry *Entries, int NumEntries, unsigned int Size, unsigned int Seed)
+		{
+			m_Slots.assign(Size,0);
+			m_Seed=Seed;
+			m_Mask=Size-1;
+
+			for (int count=0;count<NumEntries;count++)
+			{
+				const CNameTable::CEntry*& Slot=m_Slots[Hash(Entries[count].m_Name,m_Seed)&m_Mask];
+
+				if (Slot)
+					return false;
+
+				Slot=&Entries[count];
+			}
+
+			return true;
+		}
+
+		std::vector<const CNameTable::CEntry *> m_Slots;
+		unsigned int m_Seed;
+		unsigned int m_Mask;
+};
+
+MusicBrainz5::CNameTable::CNameTable(const CEntry *Entries, int NumEntries)
+:	m_d(new CNameTablePrivate)
+{
+	unsigned int Size=1;
+	while (Size<2*static_cast<unsigned int>(NumEntries))
+		Size*=2;
+
+	for (bool Built=false;!Built;Size*=2)
+	{
+		for (unsigned int Seed=0;!Built && Seed<MAX_SEEDS;Seed++)
+			Built=m_d->Build(Entries,NumEntries,Size,Seed);
+	}
+}
+
+MusicBrainz5::CNameTable::~CNameTable()
+{
+	delete m_d;
+}
+
+int MusicBrainz5::CNameTable::Find(const char *Name) const
+{
+	int Ret=-1;
+
+	if (Name)
+	{
+		const CEntry *Entry=m_d->m_Slots[CNameTablePrivate::Hash(Name,m_d->m_Seed)&m_d->m_Mask];
+
+		if (Entry && 0==strcmp(Entry->m_Name,Name))
+			Ret=Entry->m_Value;
+	}
+
+	return Ret;
+}
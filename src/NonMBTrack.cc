@@ -28,7 +28,7 @@
 
 #include "musicbrainz5/NonMBTrack.h"
 
-class MusicBrainz5::CNonMBTrackPrivate
+class MusicBrainz5::CNonMBTrackPrivate: public CSharedData
 {
 	public:
 		CNonMBTrackPrivate()
@@ -64,19 +64,50 @@ MusicBrainz5::CNonMBTrack& MusicBrainz5::CNonMBTrack::operator =(const CNonMBTra
 {
 	if (this!=&Other)
 	{
+		CSharedData::Unshare(m_d);
+
 		CEntity::operator =(Other);
 
-		m_d->m_Title=Other.m_d->m_Title;
-		m_d->m_Artist=Other.m_d->m_Artist;
-		m_d->m_Length=Other.m_d->m_Length;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_Title=Other.m_d->m_Title;
+			m_d->m_Artist=Other.m_d->m_Artist;
+			m_d->m_Length=Other.m_d->m_Length;
+		}
 	}
 
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+MusicBrainz5::CNonMBTrack::CNonMBTrack(CNonMBTrack&& Other)
+:	CEntity(),
+	m_d(new CNonMBTrackPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CNonMBTrack& MusicBrainz5::CNonMBTrack::operator =(CNonMBTrack&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CNonMBTrack::~CNonMBTrack()
 {
-	delete m_d;
+	if (m_d->RemoveReference())
+		delete m_d;
 }
 
 MusicBrainz5::CNonMBTrack *MusicBrainz5::CNonMBTrack::Clone()
@@ -84,7 +115,7 @@ MusicBrainz5::CNonMBTrack *MusicBrainz5::CNonMBTrack::Clone()
 	return new CNonMBTrack(*this);
 }
 
-void MusicBrainz5::CNonMBTrack::ParseAttribute(const std::string& Name, const std::string& /*Value*/)
+void MusicBrainz5::CNonMBTrack::ParseAttribute(const char *Name, const char * /*Value*/)
 {
 #ifdef _MB5_DEBUG_
 	std::cerr << "Unrecognised non MB track attribute: '" << Name << "'" << std::endl;
@@ -28,7 +28,9 @@
 
 #include "musicbrainz5/Offset.h"
 
-class MusicBrainz5::COffsetPrivate
+#include <string.h>
+
+class MusicBrainz5::COffsetPrivate: public CSharedData
 {
 	public:
 		COffsetPrivate()
@@ -67,22 +69,54 @@ MusicBrainz5::COffset& MusicBrainz5::COffset::operator =(const COffset& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		m_d->m_Position=Other.m_d->m_Position;
-		m_d->m_Offset=Other.m_d->m_Offset;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_Position=Other.m_d->m_Position;
+			m_d->m_Offset=Other.m_d->m_Offset;
+		}
 	}
 
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+MusicBrainz5::COffset::COffset(COffset&& Other)
+:	CEntity(),
+	m_d(new COffsetPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::COffset& MusicBrainz5::COffset::operator =(COffset&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::COffset::~COffset()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::COffset::Cleanup()
@@ -94,9 +128,9 @@ MusicBrainz5::COffset *MusicBrainz5::COffset::Clone()
 	return new COffset(*this);
 }
 
-void MusicBrainz5::COffset::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::COffset::ParseAttribute(const char *Name, const char *Value)
 {
-	if ("position"==Name)
+	if (0==strcmp(Name,"position"))
 		ProcessItem(Value,m_d->m_Position);
 	else
 	{
@@ -28,10 +28,12 @@
 
 #include "musicbrainz5/PUID.h"
 
+#include <string.h>
+
 #include "musicbrainz5/RecordingList.h"
 #include "musicbrainz5/Recording.h"
 
-class MusicBrainz5::CPUIDPrivate
+class MusicBrainz5::CPUIDPrivate: public CSharedData
 {
 	public:
 		CPUIDPrivate()
@@ -66,24 +68,56 @@ MusicBrainz5::CPUID& MusicBrainz5::CPUID::operator =(const CPUID& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_ID=Other.m_d->m_ID;
 
-		if (Other.m_d->m_RecordingList)
-			m_d->m_RecordingList=new CRecordingList(*Other.m_d->m_RecordingList);
+			if (Other.m_d->m_RecordingList)
+				m_d->m_RecordingList=new CRecordingList(*Other.m_d->m_RecordingList);
+		}
 	}
 
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+MusicBrainz5::CPUID::CPUID(CPUID&& Other)
+:	CEntity(),
+	m_d(new CPUIDPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CPUID& MusicBrainz5::CPUID::operator =(CPUID&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CPUID::~CPUID()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::CPUID::Cleanup()
@@ -97,9 +131,9 @@ MusicBrainz5::CPUID *MusicBrainz5::CPUID::Clone()
 	return new CPUID(*this);
 }
 
-void MusicBrainz5::CPUID::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CPUID::ParseAttribute(const char *Name, const char *Value)
 {
-	if ("id"==Name)
+	if (0==strcmp(Name,"id"))
 		m_d->m_ID=Value;
 	else
 	{
@@ -35,18 +35,29 @@
 #include <sstream>
 #include <iostream>
 #include <cstdlib>
+#include <deque>
+#include <exception>
+#include <set>
+#include <map>
 
+#include <stdint.h>
 #include <string.h>
-#include <unistd.h>
-#include <sys/time.h>
+#include <pthread.h>
 
 #include <ne_uri.h>
 
 #include "musicbrainz5/HTTPFetch.h"
+#include "musicbrainz5/HTTPConnectionPool.h"
+#include "musicbrainz5/RateLimiter.h"
+#include "musicbrainz5/QueryCache.h"
+#include "musicbrainz5/DiskCache.h"
 #include "musicbrainz5/Disc.h"
 #include "musicbrainz5/Message.h"
 #include "musicbrainz5/ReleaseList.h"
 #include "musicbrainz5/Release.h"
+#include "musicbrainz5/MetadataParser.h"
+#include "musicbrainz5/JSONParser.h"
+#include "musicbrainz5/LookupResult.h"
 
 class MusicBrainz5::CQueryPrivate
 {
@@ -55,10 +66,173 @@ class MusicBrainz5::CQueryPrivate
 		:	m_Port(80),
 			m_ProxyPort(0),
 			m_LastResult(CQuery::eQuery_Success),
-			m_LastHTTPCode(200)
+			m_LastHTTPCode(200),
+			m_ConnectionPool(&m_OwnConnectionPool),
+			m_RateLimiter(&CRateLimiter::Default()),
+			m_Cache(0),
+			m_DiskCache(0),
+			m_MaxAsyncWorkers(4),
+			m_AsyncIdleWorkers(0),
+			m_AsyncPending(0),
+			m_AsyncStop(false),
+			m_StreamingParse(false),
+			m_Compression(false),
+			m_ArenaAllocation(false),
+			m_ImmutableResults(false),
+			m_WireFormat(CQuery::eWireFormat_XML),
+			m_LastWireBytes(0),
+			m_LastDecodedBytes(0),
+			m_CoalescedRequests(0)
 		{
+			pthread_mutex_init(&m_Lock,0);
+			pthread_mutex_init(&m_AsyncLock,0);
+			pthread_cond_init(&m_AsyncWake,0);
+			pthread_cond_init(&m_AsyncIdle,0);
 		}
 
+		~CQueryPrivate()
+		{
+			pthread_cond_destroy(&m_AsyncIdle);
+			pthread_cond_destroy(&m_AsyncWake);
+			pthread_mutex_destroy(&m_AsyncLock);
+			pthread_mutex_destroy(&m_Lock);
+		}
+
+		class CStreamingResponse
+		{
+			public:
+				CMetadataParser *m_Parser;
+				std::vector<unsigned char> *m_Copy;
+		};
+
+		static uint64_t Hash(const std::string& Value)
+		{
+			// FNV-1a
+
+			uint64_t Ret=14695981039346656037ULL;
+
+			for (std::string::size_type count=0;count<Value.length();count++)
+			{
+				Ret^=(unsigned char)Value[count];
+				Ret*=1099511628211ULL;
+			}
+
+			return Ret;
+		}
+
+		std::string CacheKey(const std::string& Query) const
+		{
+			// Results may depend on the user, as some resources are only visible to their owner.
+			// A hash of the password keeps a query with the wrong password from finding them.
+
+			std::stringstream os;
+
+			os << m_Server << ":" << m_Port << "|" << m_UserName << "|" << std::hex << Hash(m_Password) << "|" << Query;
+
+			return os.str();
+		}
+
+		std::string FlightKey(const std::string& Query) const
+		{
+			// A request is only shared by queries that would have made it with the same
+			// credentials, through the same proxy
+
+			std::stringstream os;
+
+			os << m_ProxyHost << ":" << m_ProxyPort << "|" << m_ProxyUserName << "|" << std::hex << Hash(m_ProxyPassword) << "|" << CacheKey(Query);
+
+			return os.str();
+		}
+
+		static std::string CacheEntity(const std::string& Query)
+		{
+			// Queries are all of the form /ws/2/entity[/id[/resource]][?params]
+
+			std::string Prefix="/ws/2/";
+
+			if (0!=Query.compare(0,Prefix.length(),Prefix))
+				return "";
+
+			std::string::size_type End=Query.find_first_of("/?",Prefix.length());
+
+			return Query.substr(Prefix.length(),End==std::string::npos ? std::string::npos : End-Prefix.length());
+		}
+
+		class CBatch
+		{
+			public:
+				CBatch(const std::vector<std::string>& IDs, CQuery::tLookupCallback Callback, void *UserData)
+				:	m_Remaining(IDs.size()),
+					m_Callback(Callback),
+					m_UserData(UserData)
+				{
+					pthread_mutex_init(&m_Lock,0);
+					pthread_cond_init(&m_Done,0);
+
+					for (std::vector<std::string>::size_type count=0;count<IDs.size();count++)
+						m_Results.push_back(CLookupResult(IDs[count]));
+				}
+
+				~CBatch()
+				{
+					pthread_cond_destroy(&m_Done);
+					pthread_mutex_destroy(&m_Lock);
+				}
+
+				pthread_mutex_t m_Lock;
+				pthread_cond_t m_Done;
+				std::vector<CLookupResult> m_Results;
+				int m_Remaining;
+				CQuery::tLookupCallback m_Callback;
+				void *m_UserData;
+		};
+
+		class CBatchItem
+		{
+			public:
+				CBatch *m_Batch;
+				int m_Index;
+		};
+
+		class CFlight
+		{
+			public:
+				CFlight()
+				:	m_References(1),
+					m_Complete(false),
+					m_Shared(false),
+					m_Result(CQuery::eQuery_Success),
+					m_HTTPCode(0)
+				{
+					pthread_cond_init(&m_Done,0);
+				}
+
+				~CFlight()
+				{
+					pthread_cond_destroy(&m_Done);
+				}
+
+				pthread_cond_t m_Done;
+				int m_References;
+				bool m_Complete;
+				bool m_Shared;
+				CMetadata m_Metadata;
+				CQuery::tQueryResult m_Result;
+				int m_HTTPCode;
+				std::string m_ErrorMessage;
+		};
+
+		typedef std::map<std::string,CFlight *> tFlightMap;
+
+		class CAsyncRequest
+		{
+			public:
+				std::string m_Query;
+				CQuery::tQueryCallback m_Callback;
+				void *m_UserData;
+				bool m_Revalidate;
+		};
+
 		std::string m_UserAgent;
 		std::string m_Server;
 		int m_Port;
@@ -71,57 +245,775 @@ class MusicBrainz5::CQueryPrivate
 		CQuery::tQueryResult m_LastResult;
 		int m_LastHTTPCode;
 		std::string m_LastErrorMessage;
+		CHTTPConnectionPool m_OwnConnectionPool;
+		CHTTPConnectionPool *m_ConnectionPool;
+		CRateLimiter *m_RateLimiter;
+		CQueryCache *m_Cache;
+		CDiskCache *m_DiskCache;
+		pthread_mutex_t m_Lock;
+		pthread_mutex_t m_AsyncLock;
+		pthread_cond_t m_AsyncWake;
+		pthread_cond_t m_AsyncIdle;
+		std::deque<CAsyncRequest> m_AsyncQueue;
+		std::vector<pthread_t> m_AsyncWorkers;
+		std::set<std::string> m_Revalidating;
+		int m_MaxAsyncWorkers;
+		int m_AsyncIdleWorkers;
+		int m_AsyncPending;
+		bool m_AsyncStop;
+		bool m_StreamingParse;
+		bool m_Compression;
+		bool m_ArenaAllocation;
+		bool m_ImmutableResults;
+		CQuery::tWireFormat m_WireFormat;
+		size_t m_LastWireBytes;
+		size_t m_LastDecodedBytes;
+		unsigned long m_CoalescedRequests;
 };
 
-MusicBrainz5::CQuery::CQuery(const std::string& UserAgent, const std::string& Server, int Port)
-:	m_d(new CQueryPrivate)
+// Requests currently being made, keyed on CQueryPrivate::FlightKey. A flight is freed
+// by whichever of the requesting thread and the threads waiting for it finishes last
+
+static pthread_mutex_t FlightLock=PTHREAD_MUTEX_INITIALIZER;
+static MusicBrainz5::CQueryPrivate::tFlightMap Flights;
+
+static void ReleaseFlight(MusicBrainz5::CQueryPrivate::CFlight *Flight)
+{
+	pthread_mutex_lock(&FlightLock);
+
+	Flight->m_References--;
+	if (0==Flight->m_References)
+		delete Flight;
+
+	pthread_mutex_unlock(&FlightLock);
+}
+
+static void CompleteFlight(const std::string& Key, MusicBrainz5::CQueryPrivate::CFlight *Flight, const MusicBrainz5::CMetadata *Metadata)
+{
+	pthread_mutex_lock(&FlightLock);
+
+	Flights.erase(Key);
+
+	bool Waiting=Flight->m_References>1;
+
+	pthread_mutex_unlock(&FlightLock);
+
+	// The result is only copied if someone is waiting for it. Once the flight is out of
+	// the map nobody else can join it, and those waiting don't look at the result until
+	// it is complete, so it is copied without holding up every other query.
+
+	bool Copied=true;
+
+	if (Metadata && Waiting)
+	{
+		try
+		{
+			Flight->m_Metadata=*Metadata;
+		}
+
+		catch (...)
+		{
+			Copied=false;
+		}
+	}
+
+	pthread_mutex_lock(&FlightLock);
+
+	if (!Copied)
+	{
+		Flight->m_Shared=false;
+		Flight->m_Metadata=MusicBrainz5::CMetadata();
+	}
+
+	Flight->m_Complete=true;
+	pthread_cond_broadcast(&Flight->m_Done);
+
+	pthread_mutex_unlock(&FlightLock);
+
+	ReleaseFlight(Flight);
+}
+
+MusicBrainz5::CQuery::CQuery(const std::string& UserAgent, const std::string& Server, int Port)
+:	m_d(new CQueryPrivate)
+{
+	m_d->m_UserAgent=UserAgent;
+	m_d->m_Server=Server;
+	m_d->m_Port=Port;
+}
+
+MusicBrainz5::CQuery::~CQuery()
+{
+	WaitAsync();
+
+	pthread_mutex_lock(&m_d->m_AsyncLock);
+	m_d->m_AsyncStop=true;
+	pthread_cond_broadcast(&m_d->m_AsyncWake);
+	pthread_mutex_unlock(&m_d->m_AsyncLock);
+
+	std::vector<pthread_t>::const_iterator ThisWorker=m_d->m_AsyncWorkers.begin();
+	while (ThisWorker!=m_d->m_AsyncWorkers.end())
+	{
+		pthread_join(*ThisWorker,0);
+		++ThisWorker;
+	}
+
+	delete m_d;
+}
+
+void MusicBrainz5::CQuery::SetUserName(const std::string& UserName)
+{
+	m_d->m_UserName=UserName;
+}
+
+void MusicBrainz5::CQuery::SetPassword(const std::string& Password)
+{
+	m_d->m_Password=Password;
+}
+
+void MusicBrainz5::CQuery::SetProxyHost(const std::string& ProxyHost)
+{
+	m_d->m_ProxyHost=ProxyHost;
+}
+
+void MusicBrainz5::CQuery::SetProxyPort(int ProxyPort)
+{
+	m_d->m_ProxyPort=ProxyPort;
+}
+
+void MusicBrainz5::CQuery::SetProxyUserName(const std::string& ProxyUserName)
+{
+	m_d->m_ProxyUserName=ProxyUserName;
+}
+
+void MusicBrainz5::CQuery::SetProxyPassword(const std::string& ProxyPassword)
+{
+	m_d->m_ProxyPassword=ProxyPassword;
+}
+
+void MusicBrainz5::CQuery::SetConnectionPool(CHTTPConnectionPool *ConnectionPool)
+{
+	m_d->m_ConnectionPool=ConnectionPool ? ConnectionPool : &m_d->m_OwnConnectionPool;
+}
+
+MusicBrainz5::CHTTPConnectionPool *MusicBrainz5::CQuery::ConnectionPool() const
+{
+	return m_d->m_ConnectionPool;
+}
+
+void MusicBrainz5::CQuery::SetRateLimiter(CRateLimiter *RateLimiter)
+{
+	m_d->m_RateLimiter=RateLimiter ? RateLimiter : &CRateLimiter::Default();
+}
+
+MusicBrainz5::CRateLimiter *MusicBrainz5::CQuery::RateLimiter() const
+{
+	return m_d->m_RateLimiter;
+}
+
+void MusicBrainz5::CQuery::SetCache(CQueryCache *Cache)
+{
+	m_d->m_Cache=Cache;
+}
+
+MusicBrainz5::CQueryCache *MusicBrainz5::CQuery::Cache() const
+{
+	return m_d->m_Cache;
+}
+
+void MusicBrainz5::CQuery::SetDiskCache(CDiskCache *DiskCache)
+{
+	m_d->m_DiskCache=DiskCache;
+}
+
+MusicBrainz5::CDiskCache *MusicBrainz5::CQuery::DiskCache() const
+{
+	return m_d->m_DiskCache;
+}
+
+void MusicBrainz5::CQuery::SetStreamingParse(bool StreamingParse)
+{
+	m_d->m_StreamingParse=StreamingParse;
+}
+
+void MusicBrainz5::CQuery::SetCompression(bool Compression)
+{
+	m_d->m_Compression=Compression;
+}
+
+void MusicBrainz5::CQuery::SetArenaAllocation(bool ArenaAllocation)
+{
+	m_d->m_ArenaAllocation=ArenaAllocation;
+}
+
+void MusicBrainz5::CQuery::SetImmutableResults(bool ImmutableResults)
+{
+	m_d->m_ImmutableResults=ImmutableResults;
+}
+
+void MusicBrainz5::CQuery::SetWireFormat(tWireFormat WireFormat)
+{
+	m_d->m_WireFormat=WireFormat;
+}
+
+int MusicBrainz5::CQuery::ParseResponse(void *UserData, const char *Data, size_t Length)
+{
+	CQueryPrivate::CStreamingResponse *Response=reinterpret_cast<CQueryPrivate::CStreamingResponse *>(UserData);
+
+	if (Response->m_Copy)
+		Response->m_Copy->insert(Response->m_Copy->end(),Data,Data+Length);
+
+	// Parse errors are reported once the response is complete
+
+	Response->m_Parser->ParseChunk(Data,Length);
+
+	return 0;
+}
+
+bool MusicBrainz5::CQuery::ParseMetadata(const std::string& Query, const char *Data, size_t Length, CMetadata& Metadata) const
+{
+	bool Ret=false;
+
+	Metadata=CMetadata();
+
+	if (m_d->m_ArenaAllocation)
+		Metadata.UseArena();
+
+	if (m_d->m_ImmutableResults)
+		Metadata.SetImmutable(true);
+
+	// The format is taken from the response itself, as a cached response may have been
+	// requested with a different setting
+
+	bool JSON=CJSONParser::IsJSON(Data,Length);
+
+	if (m_d->m_StreamingParse && !JSON)
+	{
+		CMetadataParser Parser(Metadata);
+		if (!Parser.ParseChunk(Data,Length,true))
+		{
+#ifdef _MB5_DEBUG_
+			std::cerr << "Error parsing response: '" << Parser.ErrorMessage() << "'" << std::endl;
+#endif
+
+			Metadata=CMetadata();
+		}
+		else
+			Ret=true;
+	}
+	else
+	{
+		XMLResults Results;
+		XMLNode *TopNode = JSON ? CJSONParser::Parse(Data, Length, CQueryPrivate::CacheEntity(Query), &Results) : XMLRootNode::parseBuffer(Data, Length, &Results);
+		if (Results.code==eXMLErrorNone)
+		{
+			XMLNode MetadataNode=*TopNode;
+			if (!MetadataNode.isEmpty())
+			{
+				Metadata.Parse(MetadataNode);
+				Ret=true;
+			}
+		}
+		delete TopNode;
+	}
+
+	return Ret;
+}
+
+MusicBrainz5::CMetadata MusicBrainz5::CQuery::PerformQuery(const std::string& Query, bool Revalidate)
+{
+	// Background revalidations are already limited to one per query, and must not hold up
+	// queries that can be answered from the cache
+
+	if (Revalidate)
+	{
+		tQueryResult Result;
+		int HTTPCode;
+		std::string ErrorMessage;
+
+		return ExecuteQuery(Query,true,Result,HTTPCode,ErrorMessage);
+	}
+
+	// Identical queries made at the same time, from any CQuery object, share one request
+
+	std::string Key=m_d->FlightKey(Query);
+
+	pthread_mutex_lock(&FlightLock);
+
+	CQueryPrivate::tFlightMap::iterator ThisFlight=Flights.find(Key);
+	if (ThisFlight!=Flights.end())
+	{
+		CQueryPrivate::CFlight *Flight=(*ThisFlight).second;
+
+		Flight->m_References++;
+
+		while (!Flight->m_Complete)
+			pthread_cond_wait(&Flight->m_Done,&FlightLock);
+
+		pthread_mutex_unlock(&FlightLock);
+
+		// A complete flight doesn't change, and the reference taken above keeps it alive,
+		// so the result is copied without holding the lock
+
+		bool Shared=Flight->m_Shared;
+		CMetadata Metadata;
+		tQueryResult Result=Flight->m_Result;
+		int HTTPCode=Flight->m_HTTPCode;
+		std::string ErrorMessage=Flight->m_ErrorMessage;
+
+		try
+		{
+			if (Shared && eQuery_Success==Result)
+				Metadata=Flight->m_Metadata;
+		}
+
+		catch (...)
+		{
+			ReleaseFlight(Flight);
+			throw;
+		}
+
+		ReleaseFlight(Flight);
+
+		if (Shared)
+		{
+			pthread_mutex_lock(&m_d->m_Lock);
+			m_d->m_CoalescedRequests++;
+			pthread_mutex_unlock(&m_d->m_Lock);
+
+			if (eQuery_Success==Result)
+				return Metadata;
+
+			SetLastResult(Result,HTTPCode,ErrorMessage);
+			ThrowError(Result,ErrorMessage);
+		}
+
+		// The request failed in a way that can't be passed on, so make our own
+
+		return ExecuteQuery(Query,false,Result,HTTPCode,ErrorMessage);
+	}
+
+	CQueryPrivate::CFlight *Flight=new CQueryPrivate::CFlight;
+	Flights[Key]=Flight;
+
+	pthread_mutex_unlock(&FlightLock);
+
+	CMetadata Metadata;
+
+	try
+	{
+		Metadata=ExecuteQuery(Query,false,Flight->m_Result,Flight->m_HTTPCode,Flight->m_ErrorMessage);
+		Flight->m_Shared=true;
+	}
+
+	catch (...)
+	{
+		Flight->m_Shared=eQuery_Success!=Flight->m_Result;
+		CompleteFlight(Key,Flight,0);
+
+		throw;
+	}
+
+	CompleteFlight(Key,Flight,&Metadata);
+
+	return Metadata;
+}
+
+MusicBrainz5::CMetadata MusicBrainz5::CQuery::ExecuteQuery(const std::string& Query, bool Revalidate, tQueryResult& Result, int& HTTPCode, std::string& ErrorMessage)
+{
+	CMetadata Metadata;
+
+	// A cached result that has expired, but can be revalidated, is kept in CachedData and
+	// CachedMetadata in case the server reports it unchanged
+
+	std::string CacheKey;
+	std::string CacheEntity;
+	std::vector<unsigned char> CachedData;
+	std::vector<unsigned char> CacheData;
+	CMetadata CachedMetadata;
+	std::string ETag;
+	std::string LastModified;
+	bool Cached=false;
+	bool InMemory=false;
+
+	// The disk cache keeps its keys, so nothing derived from a password is written to it
+
+	CDiskCache *DiskCache=m_d->m_Password.empty() ? m_d->m_DiskCache : 0;
+
+	if (m_d->m_Cache || DiskCache)
+	{
+		CacheKey=m_d->CacheKey(Query);
+		CacheEntity=CQueryPrivate::CacheEntity(Query);
+	}
+
+	if (m_d->m_Cache)
+	{
+		CQueryCache::tFindResult Found=m_d->m_Cache->Find(CacheKey,CachedData,CachedMetadata,ETag,LastModified);
+		if (CQueryCache::eFind_Miss!=Found)
+		{
+			Cached=CachedData.empty() || ParseMetadata(Query,reinterpret_cast<const char *>(&CachedData[0]),CachedData.size(),CachedMetadata);
+			InMemory=Cached;
+
+			if (Cached && !Revalidate && CQueryCache::eFind_Expired!=Found)
+			{
+				if (CQueryCache::eFind_Stale==Found)
+					StartAsync(Query,0,0,true);
+
+				return CachedMetadata;
+			}
+		}
+	}
+
+	if (!Cached && DiskCache)
+	{
+		CachedData.clear();
+
+		CDiskCache::tFindResult Found=DiskCache->Find(CacheKey,CachedData,ETag,LastModified);
+		if (CDiskCache::eFind_Miss!=Found && ParseMetadata(Query,reinterpret_cast<const char *>(&CachedData[0]),CachedData.size(),CachedMetadata))
+		{
+			Cached=true;
+
+			if (!Revalidate && CDiskCache::eFind_Expired!=Found)
+			{
+				// A stale response would look fresh again in the memory cache, so it is only
+				// added once the revalidation has brought it up to date
+
+				if (m_d->m_Cache && CDiskCache::eFind_Fresh==Found)
+					m_d->m_Cache->Store(CacheKey,CacheEntity,&CachedData[0],CachedData.size(),CachedMetadata,ETag,LastModified);
+
+				if (CDiskCache::eFind_Stale==Found)
+					StartAsync(Query,0,0,true);
+
+				return CachedMetadata;
+			}
+		}
+	}
+
+	if (!Cached)
+	{
+		ETag.clear();
+		LastModified.clear();
+	}
+
+	WaitRequest();
+
+	CHTTPFetch Fetch(UserAgent(),m_d->m_Server,m_d->m_Port);
+
+	if (!m_d->m_UserName.empty())
+		Fetch.SetUserName(m_d->m_UserName);
+
+	if (!m_d->m_Password.empty())
+		Fetch.SetPassword(m_d->m_Password);
+
+	if (!m_d->m_ProxyHost.empty())
+		Fetch.SetProxyHost(m_d->m_ProxyHost);
+
+	if (0!=m_d->m_ProxyPort)
+		Fetch.SetProxyPort(m_d->m_ProxyPort);
+
+	if (!m_d->m_ProxyUserName.empty())
+		Fetch.SetProxyUserName(m_d->m_ProxyUserName);
+
+	if (!m_d->m_ProxyPassword.empty())
+		Fetch.SetProxyPassword(m_d->m_ProxyPassword);
+
+	Fetch.SetConnectionPool(m_d->m_ConnectionPool);
+	Fetch.SetCompression(m_d->m_Compression);
+
+	if (Cached)
+	{
+		Fetch.SetIfNoneMatch(ETag);
+		Fetch.SetIfModifiedSince(LastModified);
+	}
+
+	try
+	{
+		// The streaming parser is fed each block of the response as it arrives. It only
+		// understands XML
+
+		CQueryPrivate::CStreamingResponse Response;
+		Response.m_Parser=0;
+		Response.m_Copy=0;
+
+		if (m_d->m_StreamingParse && eWireFormat_XML==m_d->m_WireFormat)
+		{
+			if (m_d->m_ArenaAllocation)
+				Metadata.UseArena();
+
+			if (m_d->m_ImmutableResults)
+				Metadata.SetImmutable(true);
+
+			Response.m_Parser=new CMetadataParser(Metadata);
+
+			if (DiskCache || (m_d->m_Cache && CQueryCache::eStorage_Response==m_d->m_Cache->Storage()))
+				Response.m_Copy=&CacheData;
+
+			Fetch.SetResponseReader(ParseResponse,&Response);
+		}
+
+		int Ret;
+
+		try
+		{
+			Ret=Fetch.Fetch(Query);
+		}
+
+		catch (...)
+		{
+			delete Response.m_Parser;
+			throw;
+		}
+
+		// A background revalidation must not change what the caller sees as the last
+		// request, including its result below
+
+		if (!Revalidate)
+		{
+			pthread_mutex_lock(&m_d->m_Lock);
+			m_d->m_LastWireBytes=Fetch.WireBytes();
+			m_d->m_LastDecodedBytes=Fetch.DecodedBytes();
+			pthread_mutex_unlock(&m_d->m_Lock);
+		}
+
+#ifdef _MB5_DEBUG_
+		//std::cerr << "Ret: " << Ret << std::endl;
+#endif
+
+		bool Parsed=Ret>0;
+
+		if (304==Fetch.Status())
+		{
+			// Not modified, so the cached result is still current
+
+			delete Response.m_Parser;
+
+#if __cplusplus >= 201103L
+			Metadata=std::move(CachedMetadata);
+#else
+			Metadata=CachedMetadata;
+#endif
+
+			if (m_d->m_Cache)
+			{
+				if (InMemory)
+					m_d->m_Cache->Refresh(CacheKey,CacheEntity);
+				else
+					m_d->m_Cache->Store(CacheKey,CacheEntity,&CachedData[0],CachedData.size(),Metadata,ETag,LastModified);
+			}
+
+			if (DiskCache)
+				DiskCache->Refresh(CacheKey);
+
+			Parsed=false;
+		}
+		else if (Response.m_Parser)
+		{
+			if (Ret<=0 || !Response.m_Parser->ParseChunk(0,0,true))
+			{
+#ifdef _MB5_DEBUG_
+				std::cerr << "Error parsing response: '" << Response.m_Parser->ErrorMessage() << "'" << std::endl;
+#endif
+
+				Metadata=CMetadata();
+				Parsed=false;
+			}
+
+			delete Response.m_Parser;
+		}
+		else if (Ret>0)
+		{
+			const char *Data=reinterpret_cast<const char *>(Fetch.DataBuffer());
+
+#ifdef _MB5_DEBUG_
+			//std::cerr << "Ret is '" << std::string(Data,Fetch.DataSize()) << "'" << std::endl;
+#endif
+
+			Parsed=ParseMetadata(Query,Data,Fetch.DataSize(),Metadata);
+		}
+
+		if (Parsed && (m_d->m_Cache || DiskCache))
+		{
+			const unsigned char *Data=Response.m_Parser ? (CacheData.empty() ? 0 : &CacheData[0]) : Fetch.DataBuffer();
+
+			if (m_d->m_Cache)
+				m_d->m_Cache->Store(CacheKey,CacheEntity,Data,Ret,Metadata,Fetch.ETag(),Fetch.LastModified());
+
+			if (DiskCache)
+				DiskCache->Store(CacheKey,Data,Ret,Fetch.ETag(),Fetch.LastModified());
+		}
+	}
+
+	catch (CConnectionError& Error)
+	{
+		Result=CQuery::eQuery_ConnectionError;
+		HTTPCode=Fetch.Status();
+		ErrorMessage=Fetch.ErrorMessage();
+
+		if (!Revalidate)
+			SetLastResult(Result,HTTPCode,ErrorMessage);
+
+		throw;
+	}
+
+	catch (CTimeoutError& Error)
+	{
+		Result=CQuery::eQuery_Timeout;
+		HTTPCode=Fetch.Status();
+		ErrorMessage=Fetch.ErrorMessage();
+
+		if (!Revalidate)
+			SetLastResult(Result,HTTPCode,ErrorMessage);
+
+		throw;
+	}
+
+	catch (CAuthenticationError& Error)
+	{
+		Result=CQuery::eQuery_AuthenticationError;
+		HTTPCode=Fetch.Status();
+		ErrorMessage=Fetch.ErrorMessage();
+
+		if (!Revalidate)
+			SetLastResult(Result,HTTPCode,ErrorMessage);
+
+		throw;
+	}
+
+	catch (CFetchError& Error)
+	{
+		Result=CQuery::eQuery_FetchError;
+		HTTPCode=Fetch.Status();
+		ErrorMessage=Fetch.ErrorMessage();
+
+		if (!Revalidate)
+			SetLastResult(Result,HTTPCode,ErrorMessage);
+
+		throw;
+	}
+
+	catch (CRequestError& Error)
+	{
+		Result=CQuery::eQuery_RequestError;
+		HTTPCode=Fetch.Status();
+		ErrorMessage=Fetch.ErrorMessage();
+
+		if (!Revalidate)
+			SetLastResult(Result,HTTPCode,ErrorMessage);
+
+		throw;
+	}
+
+	catch (CResourceNotFoundError& Error)
+	{
+		Result=CQuery::eQuery_ResourceNotFound;
+		HTTPCode=Fetch.Status();
+		ErrorMessage=Fetch.ErrorMessage();
+
+		if (!Revalidate)
+			SetLastResult(Result,HTTPCode,ErrorMessage);
+
+		throw;
+	}
+
+	return Metadata;
+}
+
+std::vector<MusicBrainz5::CLookupResult> MusicBrainz5::CQuery::LookupReleases(const std::vector<std::string>& ReleaseIDs, const tParamMap& Params, tLookupCallback Callback, void *UserData)
 {
-	m_d->m_UserAgent=UserAgent;
-	m_d->m_Server=Server;
-	m_d->m_Port=Port;
+	tParamMap ReleaseParams(Params);
+	if (ReleaseParams.empty())
+		ReleaseParams["inc"]="artists labels recordings release-groups url-rels discids artist-credits";
+
+	return LookupBatch("release",ReleaseIDs,ReleaseParams,Callback,UserData);
 }
 
-MusicBrainz5::CQuery::~CQuery()
+std::vector<MusicBrainz5::CLookupResult> MusicBrainz5::CQuery::LookupArtists(const std::vector<std::string>& ArtistIDs, const tParamMap& Params, tLookupCallback Callback, void *UserData)
 {
-	delete m_d;
+	return LookupBatch("artist",ArtistIDs,Params,Callback,UserData);
 }
 
-void MusicBrainz5::CQuery::SetUserName(const std::string& UserName)
+std::vector<MusicBrainz5::CLookupResult> MusicBrainz5::CQuery::LookupRecordings(const std::vector<std::string>& RecordingIDs, const tParamMap& Params, tLookupCallback Callback, void *UserData)
 {
-	m_d->m_UserName=UserName;
+	return LookupBatch("recording",RecordingIDs,Params,Callback,UserData);
 }
 
-void MusicBrainz5::CQuery::SetPassword(const std::string& Password)
+std::vector<MusicBrainz5::CLookupResult> MusicBrainz5::CQuery::LookupLabels(const std::vector<std::string>& LabelIDs, const tParamMap& Params, tLookupCallback Callback, void *UserData)
 {
-	m_d->m_Password=Password;
+	return LookupBatch("label",LabelIDs,Params,Callback,UserData);
 }
 
-void MusicBrainz5::CQuery::SetProxyHost(const std::string& ProxyHost)
+std::vector<MusicBrainz5::CLookupResult> MusicBrainz5::CQuery::LookupWorks(const std::vector<std::string>& WorkIDs, const tParamMap& Params, tLookupCallback Callback, void *UserData)
 {
-	m_d->m_ProxyHost=ProxyHost;
+	return LookupBatch("work",WorkIDs,Params,Callback,UserData);
 }
 
-void MusicBrainz5::CQuery::SetProxyPort(int ProxyPort)
+std::vector<MusicBrainz5::CLookupResult> MusicBrainz5::CQuery::LookupBatch(const std::string& Entity, const std::vector<std::string>& IDs, const tParamMap& Params, tLookupCallback Callback, void *UserData)
 {
-	m_d->m_ProxyPort=ProxyPort;
+	CQueryPrivate::CBatch Batch(IDs,Callback,UserData);
+	std::vector<CQueryPrivate::CBatchItem> Items(IDs.size());
+
+	// The lookups are spread over the asynchronous query workers
+
+	for (std::vector<std::string>::size_type count=0;count<IDs.size();count++)
+	{
+		Items[count].m_Batch=&Batch;
+		Items[count].m_Index=count;
+
+		StartAsync(BuildQuery(Entity,IDs[count],"",Params),LookupCompleted,&Items[count],false);
+	}
+
+	pthread_mutex_lock(&Batch.m_Lock);
+
+	while (Batch.m_Remaining!=0)
+		pthread_cond_wait(&Batch.m_Done,&Batch.m_Lock);
+
+	pthread_mutex_unlock(&Batch.m_Lock);
+
+	return Batch.m_Results;
 }
 
-void MusicBrainz5::CQuery::SetProxyUserName(const std::string& ProxyUserName)
+void MusicBrainz5::CQuery::LookupCompleted(const CMetadata& Metadata, tQueryResult Result, const std::string& ErrorMessage, void *UserData)
 {
-	m_d->m_ProxyUserName=ProxyUserName;
+	CQueryPrivate::CBatchItem *Item=reinterpret_cast<CQueryPrivate::CBatchItem *>(UserData);
+	CQueryPrivate::CBatch *Batch=Item->m_Batch;
+
+	pthread_mutex_lock(&Batch->m_Lock);
+
+	CLookupResult& LookupResult=Batch->m_Results[Item->m_Index];
+	LookupResult.Set(Metadata,Result,ErrorMessage);
+
+	try
+	{
+		if (Batch->m_Callback)
+			Batch->m_Callback(LookupResult,Item->m_Index,Batch->m_UserData);
+	}
+
+	catch (...)
+	{
+	}
+
+	Batch->m_Remaining--;
+	if (0==Batch->m_Remaining)
+		pthread_cond_signal(&Batch->m_Done);
+
+	pthread_mutex_unlock(&Batch->m_Lock);
 }
 
-void MusicBrainz5::CQuery::SetProxyPassword(const std::string& ProxyPassword)
+MusicBrainz5::CMetadata MusicBrainz5::CQuery::Query(const std::string& Entity, const std::string& ID, const std::string& Resource, const tParamMap& Params)
 {
-	m_d->m_ProxyPassword=ProxyPassword;
+	return PerformQuery(BuildQuery(Entity,ID,Resource,Params));
 }
 
-MusicBrainz5::CMetadata MusicBrainz5::CQuery::PerformQuery(const std::string& Query)
+void MusicBrainz5::CQuery::QueryAsync(const std::string& Entity, const std::string& ID, const std::string& Resource, const tParamMap& Params, tQueryCallback Callback, void *UserData)
 {
-	WaitRequest();
+	StartAsync(BuildQuery(Entity,ID,Resource,Params),Callback,UserData,false);
+}
 
+MusicBrainz5::CMetadata MusicBrainz5::CQuery::StreamQuery(const std::string& Entity, const std::string& ID, const std::string& Resource, const tParamMap& Params, tEntityCallback Callback, void *UserData)
+{
 	CMetadata Metadata;
 
+	WaitRequest();
+
 	CHTTPFetch Fetch(UserAgent(),m_d->m_Server,m_d->m_Port);
 
 	if (!m_d->m_UserName.empty())
@@ -142,87 +1034,75 @@ MusicBrainz5::CMetadata MusicBrainz5::CQuery::PerformQuery(const std::string& Qu
 	if (!m_d->m_ProxyPassword.empty())
 		Fetch.SetProxyPassword(m_d->m_ProxyPassword);
 
+	Fetch.SetConnectionPool(m_d->m_ConnectionPool);
+	Fetch.SetCompression(m_d->m_Compression);
+
+	CMetadataParser Parser(Metadata);
+	Parser.SetEntityCallback(Callback,UserData);
+
+	CQueryPrivate::CStreamingResponse Response;
+	Response.m_Parser=&Parser;
+	Response.m_Copy=0;
+
+	Fetch.SetResponseReader(ParseResponse,&Response);
+
 	try
 	{
-		int Ret=Fetch.Fetch(Query);
+		int Ret=Fetch.Fetch(BuildQuery(Entity,ID,Resource,Params,true));
 
-#ifdef _MB5_DEBUG_
-		//std::cerr << "Ret: " << Ret << std::endl;
-#endif
+		pthread_mutex_lock(&m_d->m_Lock);
+		m_d->m_LastWireBytes=Fetch.WireBytes();
+		m_d->m_LastDecodedBytes=Fetch.DecodedBytes();
+		pthread_mutex_unlock(&m_d->m_Lock);
 
-		if (Ret>0)
+		if (Ret<=0 || !Parser.ParseChunk(0,0,true))
 		{
-			std::vector<unsigned char> Data=Fetch.Data();
-			std::string strData(Data.begin(),Data.end());
-
 #ifdef _MB5_DEBUG_
-			//std::cerr << "Ret is '" << strData << "'" << std::endl;
+			std::cerr << "Error parsing response: '" << Parser.ErrorMessage() << "'" << std::endl;
 #endif
 
-			XMLResults Results;
-			XMLNode *TopNode = XMLRootNode::parseString(strData, &Results);
-			if (Results.code==eXMLErrorNone)
-			{
-				XMLNode MetadataNode=*TopNode;
-				if (!MetadataNode.isEmpty())
-				{
-					Metadata=CMetadata(MetadataNode);
-				}
-			}
-			delete TopNode;
+			Metadata=CMetadata();
 		}
 	}
 
 	catch (CConnectionError& Error)
 	{
-		m_d->m_LastResult=CQuery::eQuery_ConnectionError;
-		m_d->m_LastHTTPCode=Fetch.Status();
-		m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+		SetLastResult(CQuery::eQuery_ConnectionError,Fetch.Status(),Fetch.ErrorMessage());
 
 		throw;
 	}
 
 	catch (CTimeoutError& Error)
 	{
-		m_d->m_LastResult=CQuery::eQuery_Timeout;
-		m_d->m_LastHTTPCode=Fetch.Status();
-		m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+		SetLastResult(CQuery::eQuery_Timeout,Fetch.Status(),Fetch.ErrorMessage());
 
 		throw;
 	}
 
 	catch (CAuthenticationError& Error)
 	{
-		m_d->m_LastResult=CQuery::eQuery_AuthenticationError;
-		m_d->m_LastHTTPCode=Fetch.Status();
-		m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+		SetLastResult(CQuery::eQuery_AuthenticationError,Fetch.Status(),Fetch.ErrorMessage());
 
 		throw;
 	}
 
 	catch (CFetchError& Error)
 	{
-		m_d->m_LastResult=CQuery::eQuery_FetchError;
-		m_d->m_LastHTTPCode=Fetch.Status();
-		m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+		SetLastResult(CQuery::eQuery_FetchError,Fetch.Status(),Fetch.ErrorMessage());
 
 		throw;
 	}
 
 	catch (CRequestError& Error)
 	{
-		m_d->m_LastResult=CQuery::eQuery_RequestError;
-		m_d->m_LastHTTPCode=Fetch.Status();
-		m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+		SetLastResult(CQuery::eQuery_RequestError,Fetch.Status(),Fetch.ErrorMessage());
 
 		throw;
 	}
 
 	catch (CResourceNotFoundError& Error)
 	{
-		m_d->m_LastResult=CQuery::eQuery_ResourceNotFound;
-		m_d->m_LastHTTPCode=Fetch.Status();
-		m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+		SetLastResult(CQuery::eQuery_ResourceNotFound,Fetch.Status(),Fetch.ErrorMessage());
 
 		throw;
 	}
@@ -230,7 +1110,218 @@ MusicBrainz5::CMetadata MusicBrainz5::CQuery::PerformQuery(const std::string& Qu
 	return Metadata;
 }
 
-MusicBrainz5::CMetadata MusicBrainz5::CQuery::Query(const std::string& Entity, const std::string& ID, const std::string& Resource, const tParamMap& Params)
+void MusicBrainz5::CQuery::StartAsync(const std::string& Query, tQueryCallback Callback, void *UserData, bool Revalidate)
+{
+	CQueryPrivate::CAsyncRequest Request;
+
+	Request.m_Query=Query;
+	Request.m_Callback=Callback;
+	Request.m_UserData=UserData;
+	Request.m_Revalidate=Revalidate;
+
+	pthread_mutex_lock(&m_d->m_AsyncLock);
+
+	// Only one background revalidation of a query at a time
+
+	if (!Revalidate || m_d->m_Revalidating.insert(Query).second)
+	{
+		m_d->m_AsyncQueue.push_back(Request);
+		m_d->m_AsyncPending++;
+
+		if (0==m_d->m_AsyncIdleWorkers && (int)m_d->m_AsyncWorkers.size()<m_d->m_MaxAsyncWorkers)
+		{
+			pthread_t Worker;
+
+			if (0==pthread_create(&Worker,0,AsyncWorker,this))
+				m_d->m_AsyncWorkers.push_back(Worker);
+			else if (m_d->m_AsyncWorkers.empty())
+			{
+				// With no worker to pick it up the request is run on this thread instead
+
+				m_d->m_AsyncQueue.pop_back();
+
+				pthread_mutex_unlock(&m_d->m_AsyncLock);
+
+				RunAsync(Query,Callback,UserData,Revalidate);
+
+				return;
+			}
+		}
+
+		pthread_cond_signal(&m_d->m_AsyncWake);
+	}
+
+	pthread_mutex_unlock(&m_d->m_AsyncLock);
+}
+
+void MusicBrainz5::CQuery::WaitAsync()
+{
+	pthread_mutex_lock(&m_d->m_AsyncLock);
+
+	while (m_d->m_AsyncPending!=0)
+		pthread_cond_wait(&m_d->m_AsyncIdle,&m_d->m_AsyncLock);
+
+	pthread_mutex_unlock(&m_d->m_AsyncLock);
+}
+
+void MusicBrainz5::CQuery::SetMaxAsyncWorkers(int MaxAsyncWorkers)
+{
+	pthread_mutex_lock(&m_d->m_AsyncLock);
+	m_d->m_MaxAsyncWorkers=MaxAsyncWorkers>0 ? MaxAsyncWorkers : 1;
+	pthread_mutex_unlock(&m_d->m_AsyncLock);
+}
+
+int MusicBrainz5::CQuery::MaxAsyncWorkers() const
+{
+	return m_d->m_MaxAsyncWorkers;
+}
+
+void *MusicBrainz5::CQuery::AsyncWorker(void *UserData)
+{
+	CQuery *Query=reinterpret_cast<CQuery *>(UserData);
+	CQueryPrivate *Private=Query->m_d;
+
+	pthread_mutex_lock(&Private->m_AsyncLock);
+
+	for (;;)
+	{
+		Private->m_AsyncIdleWorkers++;
+
+		while (Private->m_AsyncQueue.empty() && !Private->m_AsyncStop)
+			pthread_cond_wait(&Private->m_AsyncWake,&Private->m_AsyncLock);
+
+		Private->m_AsyncIdleWorkers--;
+
+		if (Private->m_AsyncQueue.empty())
+			break;
+
+		CQueryPrivate::CAsyncRequest Request=Private->m_AsyncQueue.front();
+		Private->m_AsyncQueue.pop_front();
+
+		pthread_mutex_unlock(&Private->m_AsyncLock);
+
+		Query->RunAsync(Request.m_Query,Request.m_Callback,Request.m_UserData,Request.m_Revalidate);
+
+		pthread_mutex_lock(&Private->m_AsyncLock);
+	}
+
+	pthread_mutex_unlock(&Private->m_AsyncLock);
+
+	return 0;
+}
+
+void MusicBrainz5::CQuery::RunAsync(const std::string& Query, tQueryCallback Callback, void *UserData, bool Revalidate)
+{
+	CMetadata Metadata;
+	tQueryResult Result=eQuery_Success;
+	std::string ErrorMessage;
+
+	try
+	{
+		Metadata=PerformQuery(Query,Revalidate);
+	}
+
+	catch (CConnectionError& Error)
+	{
+		Result=eQuery_ConnectionError;
+		ErrorMessage=Error.ErrorMessage();
+	}
+
+	catch (CTimeoutError& Error)
+	{
+		Result=eQuery_Timeout;
+		ErrorMessage=Error.ErrorMessage();
+	}
+
+	catch (CAuthenticationError& Error)
+	{
+		Result=eQuery_AuthenticationError;
+		ErrorMessage=Error.ErrorMessage();
+	}
+
+	catch (CFetchError& Error)
+	{
+		Result=eQuery_FetchError;
+		ErrorMessage=Error.ErrorMessage();
+	}
+
+	catch (CRequestError& Error)
+	{
+		Result=eQuery_RequestError;
+		ErrorMessage=Error.ErrorMessage();
+	}
+
+	catch (CResourceNotFoundError& Error)
+	{
+		Result=eQuery_ResourceNotFound;
+		ErrorMessage=Error.ErrorMessage();
+	}
+
+	catch (std::exception& Error)
+	{
+		Result=eQuery_FetchError;
+		ErrorMessage=Error.what();
+	}
+
+	catch (...)
+	{
+		Result=eQuery_FetchError;
+		ErrorMessage="Unknown error";
+	}
+
+	// Nothing can be done on a worker thread with an exception thrown by the callback,
+	// and the request must still be counted as complete
+
+	try
+	{
+		if (Callback)
+			Callback(Metadata,Result,ErrorMessage,UserData);
+	}
+
+	catch (...)
+	{
+	}
+
+	pthread_mutex_lock(&m_d->m_AsyncLock);
+
+	if (Revalidate)
+		m_d->m_Revalidating.erase(Query);
+
+	m_d->m_AsyncPending--;
+	if (0==m_d->m_AsyncPending)
+		pthread_cond_broadcast(&m_d->m_AsyncIdle);
+
+	pthread_mutex_unlock(&m_d->m_AsyncLock);
+}
+
+void MusicBrainz5::CQuery::ThrowError(tQueryResult Result, const std::string& ErrorMessage)
+{
+	switch (Result)
+	{
+		case eQuery_ConnectionError:
+			throw CConnectionError(ErrorMessage);
+
+		case eQuery_Timeout:
+			throw CTimeoutError(ErrorMessage);
+
+		case eQuery_AuthenticationError:
+			throw CAuthenticationError(ErrorMessage);
+
+		case eQuery_FetchError:
+			throw CFetchError(ErrorMessage);
+
+		case eQuery_RequestError:
+			throw CRequestError(ErrorMessage);
+
+		case eQuery_ResourceNotFound:
+			throw CResourceNotFoundError(ErrorMessage);
+
+		default:
+			break;
+	}
+}
+
+std::string MusicBrainz5::CQuery::BuildQuery(const std::string& Entity, const std::string& ID, const std::string& Resource, const tParamMap& Params, bool Stream)
 {
 	std::stringstream os;
 
@@ -244,14 +1335,21 @@ MusicBrainz5::CMetadata MusicBrainz5::CQuery::Query(const std::string& Entity, c
 			os << "/" << Resource;
 	}
 
-	if (!Params.empty())
+	if (eWireFormat_JSON==m_d->m_WireFormat && !Stream)
+	{
+		tParamMap JSONParams(Params);
+		JSONParams["fmt"]="json";
+
+		os << "?" << URLEncode(JSONParams);
+	}
+	else if (!Params.empty())
 		os << "?" << URLEncode(Params);
 
 #ifdef _MB5_DEBUG_
 	//std::cerr << "Query is '" << os.str() << "'" << std::endl;
 #endif
 
-	return PerformQuery(os.str());
+	return os.str();
 }
 
 MusicBrainz5::CReleaseList MusicBrainz5::CQuery::LookupDiscID(const std::string& DiscID)
@@ -263,9 +1361,16 @@ MusicBrainz5::CReleaseList MusicBrainz5::CQuery::LookupDiscID(const std::string&
 
 	CMetadata Metadata=Query("discid",DiscID);
 
+	// With immutable results, Metadata shares its data with the cache and with other
+	// requests for the same query, and moving from it takes another reference instead
+
 	CDisc *Disc=Metadata.Disc();
 	if (Disc && Disc->ReleaseList())
+#if __cplusplus >= 201103L
+		ReleaseList=std::move(*Disc->ReleaseList());
+#else
 		ReleaseList=*Disc->ReleaseList();
+#endif
 
 	return ReleaseList;
 }
@@ -277,39 +1382,22 @@ MusicBrainz5::CRelease MusicBrainz5::CQuery::LookupRelease(const std::string& Re
 	tParamMap Params;
 	Params["inc"]="artists labels recordings release-groups url-rels discids artist-credits";
 
+	// As in LookupDiscID, this only takes over data that isn't shared
+
 	CMetadata Metadata=Query("release",ReleaseID,"",Params);
 	if (Metadata.Release())
+#if __cplusplus >= 201103L
+		Release=std::move(*Metadata.Release());
+#else
 		Release=*Metadata.Release();
+#endif
 
 	return Release;
 }
 
 void MusicBrainz5::CQuery::WaitRequest() const
 {
-	if (m_d->m_Server.find("musicbrainz.org")!=std::string::npos)
-	{
-		static struct timeval LastRequest;
-		const int TimeBetweenRequests=2;
-
-		struct timeval TimeNow;
-		gettimeofday(&TimeNow,0);
-
-		if (LastRequest.tv_sec!=0 || LastRequest.tv_usec!=0)
-		{
-			struct timeval Diff;
-
-			do
-			{
-				gettimeofday(&TimeNow,0);
-				timersub(&TimeNow,&LastRequest,&Diff);
-
-				if (Diff.tv_sec<TimeBetweenRequests)
-					usleep(100000);
-			}	while (Diff.tv_sec<TimeBetweenRequests);
-		}
-
-		memcpy(&LastRequest,&TimeNow,sizeof(LastRequest));
-	}
+	m_d->m_RateLimiter->Wait(m_d->m_Server);
 }
 
 bool MusicBrainz5::CQuery::AddCollectionEntries(const std::string& CollectionID, const std::vector<std::string>& Entries)
@@ -374,6 +1462,8 @@ bool MusicBrainz5::CQuery::EditCollection(const std::string& CollectionID, const
 		if (!m_d->m_ProxyPassword.empty())
 			Fetch.SetProxyPassword(m_d->m_ProxyPassword);
 
+		Fetch.SetConnectionPool(m_d->m_ConnectionPool);
+
 		try
 		{
 #ifdef _MB5_DEBUG_
@@ -388,15 +1478,14 @@ bool MusicBrainz5::CQuery::EditCollection(const std::string& CollectionID, const
 
 			if (Ret>0)
 			{
-				std::vector<unsigned char> Data=Fetch.Data();
-				std::string strData(Data.begin(),Data.end());
+				const char *Data=reinterpret_cast<const char *>(Fetch.DataBuffer());
 
 #ifdef _MB5_DEBUG_
-				//std::cerr << "Collection " << Action << " ret is '" << strData << "'" << std::endl;
+				//std::cerr << "Collection " << Action << " ret is '" << std::string(Data,Fetch.DataSize()) << "'" << std::endl;
 #endif
 
 				XMLResults Results;
-				XMLNode *TopNode = XMLRootNode::parseString(strData, &Results);
+				XMLNode *TopNode = XMLRootNode::parseBuffer(Data, Fetch.DataSize(), &Results);
 				if (Results.code==eXMLErrorNone)
 				{
 					XMLNode MetadataNode=*TopNode;
@@ -414,54 +1503,42 @@ bool MusicBrainz5::CQuery::EditCollection(const std::string& CollectionID, const
 
 		catch (CConnectionError& Error)
 		{
-			m_d->m_LastResult=CQuery::eQuery_ConnectionError;
-			m_d->m_LastHTTPCode=Fetch.Status();
-			m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+			SetLastResult(CQuery::eQuery_ConnectionError,Fetch.Status(),Fetch.ErrorMessage());
 
 			throw;
 		}
 
 		catch (CTimeoutError& Error)
 		{
-			m_d->m_LastResult=CQuery::eQuery_Timeout;
-			m_d->m_LastHTTPCode=Fetch.Status();
-			m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+			SetLastResult(CQuery::eQuery_Timeout,Fetch.Status(),Fetch.ErrorMessage());
 
 			throw;
 		}
 
 		catch (CAuthenticationError& Error)
 		{
-			m_d->m_LastResult=CQuery::eQuery_AuthenticationError;
-			m_d->m_LastHTTPCode=Fetch.Status();
-			m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+			SetLastResult(CQuery::eQuery_AuthenticationError,Fetch.Status(),Fetch.ErrorMessage());
 
 			throw;
 		}
 
 		catch (CFetchError& Error)
 		{
-			m_d->m_LastResult=CQuery::eQuery_FetchError;
-			m_d->m_LastHTTPCode=Fetch.Status();
-			m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+			SetLastResult(CQuery::eQuery_FetchError,Fetch.Status(),Fetch.ErrorMessage());
 
 			throw;
 		}
 
 		catch (CRequestError& Error)
 		{
-			m_d->m_LastResult=CQuery::eQuery_RequestError;
-			m_d->m_LastHTTPCode=Fetch.Status();
-			m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+			SetLastResult(CQuery::eQuery_RequestError,Fetch.Status(),Fetch.ErrorMessage());
 
 			throw;
 		}
 
 		catch (CResourceNotFoundError& Error)
 		{
-			m_d->m_LastResult=CQuery::eQuery_ResourceNotFound;
-			m_d->m_LastHTTPCode=Fetch.Status();
-			m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+			SetLastResult(CQuery::eQuery_ResourceNotFound,Fetch.Status(),Fetch.ErrorMessage());
 
 			throw;
 		}
@@ -505,19 +1582,69 @@ std::string MusicBrainz5::CQuery::URLEncode(const std::map<std::string,std::stri
 	return EncodedStr;
 }
 
+void MusicBrainz5::CQuery::SetLastResult(tQueryResult Result, int HTTPCode, const std::string& ErrorMessage)
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+
+	m_d->m_LastResult=Result;
+	m_d->m_LastHTTPCode=HTTPCode;
+	m_d->m_LastErrorMessage=ErrorMessage;
+
+	pthread_mutex_unlock(&m_d->m_Lock);
+}
+
 MusicBrainz5::CQuery::tQueryResult MusicBrainz5::CQuery::LastResult() const
 {
-	return m_d->m_LastResult;
+	pthread_mutex_lock(&m_d->m_Lock);
+	tQueryResult Ret=m_d->m_LastResult;
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
 }
 
 int MusicBrainz5::CQuery::LastHTTPCode() const
 {
-	return m_d->m_LastHTTPCode;
+	pthread_mutex_lock(&m_d->m_Lock);
+	int Ret=m_d->m_LastHTTPCode;
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+size_t MusicBrainz5::CQuery::LastWireBytes() const
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	size_t Ret=m_d->m_LastWireBytes;
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+size_t MusicBrainz5::CQuery::LastDecodedBytes() const
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	size_t Ret=m_d->m_LastDecodedBytes;
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+unsigned long MusicBrainz5::CQuery::CoalescedRequests() const
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	unsigned long Ret=m_d->m_CoalescedRequests;
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
 }
 
 std::string MusicBrainz5::CQuery::LastErrorMessage() const
 {
-	return m_d->m_LastErrorMessage;
+	pthread_mutex_lock(&m_d->m_Lock);
+	std::string Ret=m_d->m_LastErrorMessage;
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
 }
 
 std::string MusicBrainz5::CQuery::Version() const
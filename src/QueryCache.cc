@@ -0,0 +1,362 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/QueryCache.h"
+
+#include <map>
+#include <list>
+
+#include <time.h>
+#include <pthread.h>
+
+class MusicBrainz5::CQueryCachePrivate
+{
+	public:
+		CQueryCachePrivate()
+		:	m_Capacity(0),
+			m_Storage(CQueryCache::eStorage_Response),
+			m_DefaultTTL(3600),
+			m_StaleWhileRevalidate(0),
+			m_Size(0),
+			m_Hits(0),
+			m_Misses(0),
+			m_Evictions(0),
+			m_Revalidations(0)
+		{
+			pthread_mutex_init(&m_Lock,0);
+		}
+
+		~CQueryCachePrivate()
+		{
+			pthread_mutex_destroy(&m_Lock);
+		}
+
+		class CEntry
+		{
+			public:
+				std::string m_Key;
+				std::vector<unsigned char> m_Data;
+				CMetadata m_Metadata;
+				std::string m_ETag;
+				std::string m_LastModified;
+				size_t m_Size;
+				time_t m_Expires;
+		};
+
+		typedef std::list<CEntry> tEntryList;
+		typedef std::map<std::string,tEntryList::iterator> tEntryMap;
+
+		static time_t Now()
+		{
+			struct timespec TimeNow;
+			clock_gettime(CLOCK_MONOTONIC,&TimeNow);
+
+			return TimeNow.tv_sec;
+		}
+
+		void Remove(tEntryMap::iterator ThisEntry)
+		{
+			m_Size-=(*(*ThisEntry).second).m_Size;
+			m_Entries.erase((*ThisEntry).second);
+			m_Index.erase(ThisEntry);
+		}
+
+		void Evict(size_t Required)
+		{
+			// The least recently used entry is at the back of the list
+
+			while (!m_Entries.empty() && m_Size+Required>m_Capacity)
+			{
+				Remove(m_Index.find(m_Entries.back().m_Key));
+				m_Evictions++;
+			}
+		}
+
+		int EntityTTL(const std::string& Entity) const
+		{
+			std::map<std::string,int>::const_iterator ThisTTL=m_TTLs.find(Entity);
+			if (ThisTTL!=m_TTLs.end())
+				return (*ThisTTL).second;
+
+			return m_DefaultTTL;
+		}
+
+		pthread_mutex_t m_Lock;
+		size_t m_Capacity;
+		CQueryCache::tStorage m_Storage;
+		int m_DefaultTTL;
+		int m_StaleWhileRevalidate;
+		std::map<std::string,int> m_TTLs;
+		tEntryList m_Entries;
+		tEntryMap m_Index;
+		size_t m_Size;
+		unsigned long m_Hits;
+		unsigned long m_Misses;
+		unsigned long m_Evictions;
+		unsigned long m_Revalidations;
+};
+
+MusicBrainz5::CQueryCache::CQueryCache(size_t Capacity, tStorage Storage)
+:	m_d(new CQueryCachePrivate)
+{
+	m_d->m_Capacity=Capacity;
+	m_d->m_Storage=Storage;
+}
+
+MusicBrainz5::CQueryCache::~CQueryCache()
+{
+	delete m_d;
+}
+
+void MusicBrainz5::CQueryCache::SetCapacity(size_t Capacity)
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+
+	m_d->m_Capacity=Capacity;
+	m_d->Evict(0);
+
+	pthread_mutex_unlock(&m_d->m_Lock);
+}
+
+void MusicBrainz5::CQueryCache::SetDefaultTTL(int TTL)
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	m_d->m_DefaultTTL=TTL;
+	pthread_mutex_unlock(&m_d->m_Lock);
+}
+
+void MusicBrainz5::CQueryCache::SetTTL(const std::string& Entity, int TTL)
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	m_d->m_TTLs[Entity]=TTL;
+	pthread_mutex_unlock(&m_d->m_Lock);
+}
+
+void MusicBrainz5::CQueryCache::SetStaleWhileRevalidate(int StaleWhileRevalidate)
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	m_d->m_StaleWhileRevalidate=StaleWhileRevalidate;
+	pthread_mutex_unlock(&m_d->m_Lock);
+}
+
+size_t MusicBrainz5::CQueryCache::Capacity() const
+{
+	return m_d->m_Capacity;
+}
+
+MusicBrainz5::CQueryCache::tStorage MusicBrainz5::CQueryCache::Storage() const
+{
+	return m_d->m_Storage;
+}
+
+int MusicBrainz5::CQueryCache::DefaultTTL() const
+{
+	return m_d->m_DefaultTTL;
+}
+
+int MusicBrainz5::CQueryCache::StaleWhileRevalidate() const
+{
+	return m_d->m_StaleWhileRevalidate;
+}
+
+int MusicBrainz5::CQueryCache::TTL(const std::string& Entity) const
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	int Ret=m_d->EntityTTL(Entity);
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+size_t MusicBrainz5::CQueryCache::Size() const
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	size_t Ret=m_d->m_Size;
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+size_t MusicBrainz5::CQueryCache::Count() const
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	size_t Ret=m_d->m_Index.size();
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+unsigned long MusicBrainz5::CQueryCache::Hits() const
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	unsigned long Ret=m_d->m_Hits;
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+unsigned long MusicBrainz5::CQueryCache::Misses() const
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	unsigned long Ret=m_d->m_Misses;
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+unsigned long MusicBrainz5::CQueryCache::Evictions() const
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	unsigned long Ret=m_d->m_Evictions;
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+unsigned long MusicBrainz5::CQueryCache::Revalidations() const
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	unsigned long Ret=m_d->m_Revalidations;
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+void MusicBrainz5::CQueryCache::Clear()
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+
+	m_d->m_Entries.clear();
+	m_d->m_Index.clear();
+	m_d->m_Size=0;
+
+	pthread_mutex_unlock(&m_d->m_Lock);
+}
+
+MusicBrainz5::CQueryCache::tFindResult MusicBrainz5::CQueryCache::Find(const std::string& Key, std::vector<unsigned char>& Data, CMetadata& Metadata, std::string& ETag, std::string& LastModified)
+{
+	tFindResult Ret=eFind_Miss;
+
+	pthread_mutex_lock(&m_d->m_Lock);
+
+	CQueryCachePrivate::tEntryMap::iterator ThisEntry=m_d->m_Index.find(Key);
+	if (ThisEntry!=m_d->m_Index.end())
+	{
+		CQueryCachePrivate::tEntryList::iterator Entry=(*ThisEntry).second;
+		time_t TimeNow=CQueryCachePrivate::Now();
+
+		// Once past its time to live, an entry can still be used while it is revalidated,
+		// or as the result of a conditional request that finds it unchanged
+
+		if (TimeNow<Entry->m_Expires)
+			Ret=eFind_Fresh;
+		else if (TimeNow<Entry->m_Expires+m_d->m_StaleWhileRevalidate)
+			Ret=eFind_Stale;
+		else if (!Entry->m_ETag.empty() || !Entry->m_LastModified.empty())
+			Ret=eFind_Expired;
+		else
+			m_d->Remove(ThisEntry);
+
+		if (eFind_Miss!=Ret)
+		{
+			// Move to the front of the list, as the most recently used
+
+			m_d->m_Entries.splice(m_d->m_Entries.begin(),m_d->m_Entries,Entry);
+
+			if (CQueryCache::eStorage_Response==m_d->m_Storage)
+				Data=Entry->m_Data;
+			else
+				Metadata=Entry->m_Metadata;
+
+			ETag=Entry->m_ETag;
+			LastModified=Entry->m_LastModified;
+		}
+	}
+
+	if (eFind_Fresh==Ret || eFind_Stale==Ret)
+		m_d->m_Hits++;
+	else
+		m_d->m_Misses++;
+
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+void MusicBrainz5::CQueryCache::Refresh(const std::string& Key, const std::string& Entity)
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+
+	CQueryCachePrivate::tEntryMap::iterator ThisEntry=m_d->m_Index.find(Key);
+	if (ThisEntry!=m_d->m_Index.end())
+	{
+		(*(*ThisEntry).second).m_Expires=CQueryCachePrivate::Now()+m_d->EntityTTL(Entity);
+		m_d->m_Revalidations++;
+	}
+
+	pthread_mutex_unlock(&m_d->m_Lock);
+}
+
+void MusicBrainz5::CQueryCache::Store(const std::string& Key, const std::string& Entity, const unsigned char *Data, size_t Length, const CMetadata& Metadata, const std::string& ETag, const std::string& LastModified)
+{
+	if (CQueryCache::eStorage_Response==m_d->m_Storage && !Data)
+		return;
+
+	pthread_mutex_lock(&m_d->m_Lock);
+
+	int TTL=m_d->EntityTTL(Entity);
+
+	if (TTL>0 && Length<=m_d->m_Capacity)
+	{
+		CQueryCachePrivate::tEntryMap::iterator ThisEntry=m_d->m_Index.find(Key);
+		if (ThisEntry!=m_d->m_Index.end())
+			m_d->Remove(ThisEntry);
+
+		m_d->Evict(Length);
+
+		m_d->m_Entries.push_front(CQueryCachePrivate::CEntry());
+
+		CQueryCachePrivate::CEntry& Entry=m_d->m_Entries.front();
+		Entry.m_Key=Key;
+
+		if (CQueryCache::eStorage_Response==m_d->m_Storage)
+			Entry.m_Data.assign(Data,Data+Length);
+		else
+			Entry.m_Metadata=Metadata;
+
+		Entry.m_ETag=ETag;
+		Entry.m_LastModified=LastModified;
+		Entry.m_Size=Length;
+		Entry.m_Expires=CQueryCachePrivate::Now()+TTL;
+
+		m_d->m_Index[Key]=m_d->m_Entries.begin();
+		m_d->m_Size+=Length;
+	}
+
+	pthread_mutex_unlock(&m_d->m_Lock);
+}
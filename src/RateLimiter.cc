@@ -0,0 +1,449 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/RateLimiter.h"
+
+#include <map>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#ifdef _MB5_DEBUG_
+#include <iostream>
+#endif
+
+#define SHARED_MAGIC	0x4d42524c
+#define SHARED_HOSTS	32
+#define SHARED_HOST_LENGTH	128
+#define SHARED_INIT_TIMEOUT	1.0
+
+class MusicBrainz5::CRateLimiterPrivate
+{
+	public:
+		CRateLimiterPrivate()
+		:	m_Shared(0)
+		{
+			pthread_mutex_init(&m_Lock,0);
+		}
+
+		~CRateLimiterPrivate()
+		{
+			if (m_Shared)
+				munmap(m_Shared,sizeof(CSharedState));
+
+			pthread_mutex_destroy(&m_Lock);
+		}
+
+		// Plain data only, as buckets may live in shared memory
+
+		struct CBucket
+		{
+			char m_Host[SHARED_HOST_LENGTH];
+			double m_Interval;
+			double m_Tolerance;
+			double m_NextFree;
+			double m_WaitTime;
+			unsigned long m_Requests;
+		};
+
+		struct CSharedState
+		{
+			volatile int m_Initialised;
+			unsigned int m_Magic;
+			pthread_mutex_t m_Lock;
+			int m_NumBuckets;
+			CBucket m_Buckets[SHARED_HOSTS];
+		};
+
+		typedef std::map<std::string,CBucket> tBucketMap;
+
+		static double Now()
+		{
+			struct timespec TimeNow;
+			clock_gettime(CLOCK_MONOTONIC,&TimeNow);
+
+			return TimeNow.tv_sec+TimeNow.tv_nsec/1e9;
+		}
+
+		static void SleepUntil(double Time)
+		{
+			struct timespec WakeTime;
+			WakeTime.tv_sec=(time_t)Time;
+			WakeTime.tv_nsec=(long)((Time-WakeTime.tv_sec)*1e9);
+
+			while (EINTR==clock_nanosleep(CLOCK_MONOTONIC,TIMER_ABSTIME,&WakeTime,0))
+				;
+		}
+
+		bool Attach(const std::string& Name)
+		{
+			int fd=shm_open(Name.c_str(),O_RDWR|O_CREAT,0600);
+			if (-1==fd)
+				return false;
+
+			// A new segment is zero filled, so the first process to get here sets it up
+
+			CSharedState *Shared=0;
+			if (0==ftruncate(fd,sizeof(CSharedState)))
+			{
+				void *Map=mmap(0,sizeof(CSharedState),PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+				if (MAP_FAILED!=Map)
+					Shared=reinterpret_cast<CSharedState *>(Map);
+			}
+
+			close(fd);
+
+			if (!Shared)
+				return false;
+
+			if (__sync_bool_compare_and_swap(&Shared->m_Initialised,0,1))
+			{
+				pthread_mutexattr_t Attr;
+				pthread_mutexattr_init(&Attr);
+				pthread_mutexattr_setpshared(&Attr,PTHREAD_PROCESS_SHARED);
+				pthread_mutexattr_setrobust(&Attr,PTHREAD_MUTEX_ROBUST);
+				pthread_mutex_init(&Shared->m_Lock,&Attr);
+				pthread_mutexattr_destroy(&Attr);
+
+				Shared->m_Magic=SHARED_MAGIC;
+				Shared->m_NumBuckets=0;
+
+				__sync_synchronize();
+				Shared->m_Initialised=2;
+			}
+			else
+			{
+				// Setting up takes microseconds, so a segment that is still not ready after
+				// the timeout was left behind by a process that died part way through. It is
+				// not safe to set it up again, as that process may only have been stalled.
+
+				double Timeout=Now()+SHARED_INIT_TIMEOUT;
+
+				while (2!=Shared->m_Initialised && Now()<Timeout)
+					sched_yield();
+
+				if (2!=Shared->m_Initialised)
+				{
+					munmap(Shared,sizeof(CSharedState));
+					errno=ETIMEDOUT;
+					return false;
+				}
+			}
+
+			if (SHARED_MAGIC!=Shared->m_Magic)
+			{
+				munmap(Shared,sizeof(CSharedState));
+				return false;
+			}
+
+			m_Shared=Shared;
+
+			return true;
+		}
+
+		void Detach()
+		{
+			// The limiter carries on with a private copy of the shared buckets
+
+			for (int count=0;count<m_Shared->m_NumBuckets;count++)
+			{
+				CBucket& Bucket=m_Shared->m_Buckets[count];
+				m_Buckets[std::string(Bucket.m_Host,strnlen(Bucket.m_Host,SHARED_HOST_LENGTH))]=Bucket;
+			}
+
+			munmap(m_Shared,sizeof(CSharedState));
+			m_Shared=0;
+		}
+
+		void Lock()
+		{
+			// The local lock is always taken, so threads in this process never see the
+			// limiter detach from the segment part way through an update
+
+			pthread_mutex_lock(&m_Lock);
+
+			if (m_Shared)
+			{
+				// The bucket state is always consistent, so a lock left behind by a
+				// process that died while holding it can simply be recovered
+
+				int Ret=pthread_mutex_lock(&m_Shared->m_Lock);
+				if (EOWNERDEAD==Ret)
+					Ret=pthread_mutex_consistent(&m_Shared->m_Lock);
+
+				if (0!=Ret)
+				{
+#ifdef _MB5_DEBUG_
+					std::cerr << "Unable to lock shared rate limiter: " << strerror(Ret) << std::endl;
+#endif
+
+					Detach();
+				}
+			}
+		}
+
+		void Unlock()
+		{
+			if (m_Shared)
+				pthread_mutex_unlock(&m_Shared->m_Lock);
+
+			pthread_mutex_unlock(&m_Lock);
+		}
+
+		CBucket *FindExact(const std::string& Host)
+		{
+			if (m_Shared)
+			{
+				for (int count=0;count<m_Shared->m_NumBuckets;count++)
+					if (Host==m_Shared->m_Buckets[count].m_Host)
+						return &m_Shared->m_Buckets[count];
+			}
+			else
+			{
+				tBucketMap::iterator ThisBucket=m_Buckets.find(Host);
+				if (ThisBucket!=m_Buckets.end())
+					return &(*ThisBucket).second;
+			}
+
+			return 0;
+		}
+
+		CBucket *AddBucket(const std::string& Host)
+		{
+			CBucket *Bucket=0;
+
+			if (m_Shared)
+			{
+				if (m_Shared->m_NumBuckets<SHARED_HOSTS)
+					Bucket=&m_Shared->m_Buckets[m_Shared->m_NumBuckets++];
+			}
+			else
+				Bucket=&m_Buckets[Host];
+
+			if (Bucket)
+			{
+				memset(Bucket,0,sizeof(CBucket));
+				strncpy(Bucket->m_Host,Host.c_str(),SHARED_HOST_LENGTH-1);
+			}
+
+			return Bucket;
+		}
+
+		void RemoveBucket(const std::string& Host)
+		{
+			if (m_Shared)
+			{
+				CBucket *Bucket=FindExact(Host);
+				if (Bucket)
+				{
+					CBucket *Last=&m_Shared->m_Buckets[--m_Shared->m_NumBuckets];
+					if (Bucket!=Last)
+						memcpy(Bucket,Last,sizeof(CBucket));
+				}
+			}
+			else
+				m_Buckets.erase(Host);
+		}
+
+		CBucket *FindBucket(const std::string& Host)
+		{
+			// Try the host itself, then each of its parent domains
+
+			std::string::size_type Pos=0;
+			while (Pos!=std::string::npos)
+			{
+				CBucket *Bucket=FindExact(Host.substr(Pos));
+				if (Bucket)
+					return Bucket;
+
+				Pos=Host.find('.',Pos);
+				if (Pos!=std::string::npos)
+					Pos++;
+			}
+
+			return 0;
+		}
+
+		pthread_mutex_t m_Lock;
+		tBucketMap m_Buckets;
+		CSharedState *m_Shared;
+};
+
+MusicBrainz5::CRateLimiter::CRateLimiter()
+:	m_d(new CRateLimiterPrivate)
+{
+}
+
+MusicBrainz5::CRateLimiter::CRateLimiter(const std::string& SharedName)
+:	m_d(new CRateLimiterPrivate)
+{
+	if (!m_d->Attach(SharedName))
+	{
+#ifdef _MB5_DEBUG_
+		std::cerr << "Unable to attach rate limiter to shared memory '" << SharedName << "': " << strerror(errno) << std::endl;
+#endif
+	}
+}
+
+MusicBrainz5::CRateLimiter::~CRateLimiter()
+{
+	delete m_d;
+}
+
+MusicBrainz5::CRateLimiter& MusicBrainz5::CRateLimiter::Default()
+{
+	static CRateLimiter *DefaultLimiter=0;
+	static pthread_once_t Once=PTHREAD_ONCE_INIT;
+
+	struct CInit
+	{
+		static void Init()
+		{
+			DefaultLimiter=new CRateLimiter;
+			DefaultLimiter->SetRate("musicbrainz.org",0.5,1);
+		}
+	};
+
+	pthread_once(&Once,CInit::Init);
+
+	return *DefaultLimiter;
+}
+
+bool MusicBrainz5::CRateLimiter::Shared() const
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	bool Ret=0!=m_d->m_Shared;
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+bool MusicBrainz5::CRateLimiter::SetRate(const std::string& Host, double Rate, int Burst)
+{
+	if (Rate<=0)
+	{
+		RemoveRate(Host);
+		return true;
+	}
+
+	if (Host.length()>=SHARED_HOST_LENGTH)
+		return false;
+
+	if (Burst<1)
+		Burst=1;
+
+	m_d->Lock();
+
+	// Changing the rate of an existing bucket keeps its state, as other processes may be using it
+
+	CRateLimiterPrivate::CBucket *Bucket=m_d->FindExact(Host);
+	if (!Bucket)
+		Bucket=m_d->AddBucket(Host);
+
+	if (Bucket)
+	{
+		Bucket->m_Interval=1.0/Rate;
+		Bucket->m_Tolerance=(Burst-1)*Bucket->m_Interval;
+	}
+
+	m_d->Unlock();
+
+	return 0!=Bucket;
+}
+
+void MusicBrainz5::CRateLimiter::RemoveRate(const std::string& Host)
+{
+	m_d->Lock();
+	m_d->RemoveBucket(Host);
+	m_d->Unlock();
+}
+
+double MusicBrainz5::CRateLimiter::Wait(const std::string& Host)
+{
+	double TimeNow=CRateLimiterPrivate::Now();
+	double WakeTime=TimeNow;
+
+	m_d->Lock();
+
+	CRateLimiterPrivate::CBucket *Bucket=m_d->FindBucket(Host);
+	if (Bucket)
+	{
+		// NextFree is the time the bucket becomes empty again. A request may go ahead
+		// as long as that is no more than a burst ahead of now, otherwise it reserves
+		// the earliest slot and sleeps until then.
+
+		if (Bucket->m_NextFree<TimeNow)
+			Bucket->m_NextFree=TimeNow;
+
+		if (Bucket->m_NextFree-TimeNow>Bucket->m_Tolerance)
+			WakeTime=Bucket->m_NextFree-Bucket->m_Tolerance;
+
+		Bucket->m_NextFree+=Bucket->m_Interval;
+		Bucket->m_WaitTime+=WakeTime-TimeNow;
+		Bucket->m_Requests++;
+	}
+
+	m_d->Unlock();
+
+	if (WakeTime>TimeNow)
+		CRateLimiterPrivate::SleepUntil(WakeTime);
+
+	return WakeTime-TimeNow;
+}
+
+bool MusicBrainz5::CRateLimiter::Stats(const std::string& Host, double& Tokens, double& WaitTime, unsigned long& Requests) const
+{
+	double TimeNow=CRateLimiterPrivate::Now();
+
+	m_d->Lock();
+
+	CRateLimiterPrivate::CBucket *Bucket=m_d->FindBucket(Host);
+	if (Bucket)
+	{
+		double Pending=Bucket->m_NextFree-TimeNow;
+		if (Pending<0)
+			Pending=0;
+
+		Tokens=(Bucket->m_Tolerance+Bucket->m_Interval-Pending)/Bucket->m_Interval;
+		if (Tokens<0)
+			Tokens=0;
+
+		WaitTime=Bucket->m_WaitTime;
+		Requests=Bucket->m_Requests;
+	}
+
+	m_d->Unlock();
+
+	return 0!=Bucket;
+}
@@ -28,7 +28,9 @@
 
 #include "musicbrainz5/Rating.h"
 
-class MusicBrainz5::CRatingPrivate
+#include <string.h>
+
+class MusicBrainz5::CRatingPrivate: public CSharedData
 {
 	public:
 		CRatingPrivate()
@@ -69,18 +71,49 @@ MusicBrainz5::CRating& MusicBrainz5::CRating::operator =(const CRating& Other)
 {
 	if (this!=&Other)
 	{
+		CSharedData::Unshare(m_d);
+
 		CEntity::operator =(Other);
 
-		m_d->m_VotesCount=Other.m_d->m_VotesCount;
-		m_d->m_Rating=Other.m_d->m_Rating;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_VotesCount=Other.m_d->m_VotesCount;
+			m_d->m_Rating=Other.m_d->m_Rating;
+		}
+	}
+
+	return *this;
+}
+
+#if __cplusplus >= 201103L
+MusicBrainz5::CRating::CRating(CRating&& Other)
+:	CEntity(),
+	m_d(new CRatingPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CRating& MusicBrainz5::CRating::operator =(CRating&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CRating::~CRating()
 {
-	delete m_d;
+	if (m_d->RemoveReference())
+		delete m_d;
 }
 
 MusicBrainz5::CRating *MusicBrainz5::CRating::Clone()
@@ -88,9 +121,9 @@ MusicBrainz5::CRating *MusicBrainz5::CRating::Clone()
 	return new CRating(*this);
 }
 
-void MusicBrainz5::CRating::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CRating::ParseAttribute(const char *Name, const char *Value)
 {
-	if ("votes-count"==Name)
+	if (0==strcmp(Name,"votes-count"))
 	{
 		ProcessItem(Value,m_d->m_VotesCount);
 	}
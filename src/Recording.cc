@@ -28,6 +28,10 @@
 
 #include "musicbrainz5/Recording.h"
 
+#include "musicbrainz5/NameTable.h"
+
+#include <string.h>
+
 #include "musicbrainz5/ArtistCredit.h"
 #include "musicbrainz5/Rating.h"
 #include "musicbrainz5/UserRating.h"
@@ -44,7 +48,7 @@
 #include "musicbrainz5/UserTagList.h"
 #include "musicbrainz5/UserTag.h"
 
-class MusicBrainz5::CRecordingPrivate
+class MusicBrainz5::CRecordingPrivate: public CSharedData
 {
 	public:
 		CRecordingPrivate()
@@ -76,6 +80,42 @@ class MusicBrainz5::CRecordingPrivate
 		CUserRating *m_UserRating;
 };
 
+// Child elements handled by ParseElement
+
+enum
+{
+	eElement_Title,
+	eElement_Length,
+	eElement_Disambiguation,
+	eElement_ArtistCredit,
+	eElement_ReleaseList,
+	eElement_PUIDList,
+	eElement_ISRCList,
+	eElement_RelationList,
+	eElement_TagList,
+	eElement_UserTagList,
+	eElement_Rating,
+	eElement_UserRating
+};
+
+static const MusicBrainz5::CNameTable::CEntry ElementEntries[]=
+{
+	{ "title", eElement_Title },
+	{ "length", eElement_Length },
+	{ "disambiguation", eElement_Disambiguation },
+	{ "artist-credit", eElement_ArtistCredit },
+	{ "release-list", eElement_ReleaseList },
+	{ "puid-list", eElement_PUIDList },
+	{ "isrc-list", eElement_ISRCList },
+	{ "relation-list", eElement_RelationList },
+	{ "tag-list", eElement_TagList },
+	{ "user-tag-list", eElement_UserTagList },
+	{ "rating", eElement_Rating },
+	{ "user-rating", eElement_UserRating }
+};
+
+static const MusicBrainz5::CNameTable Elements(ElementEntries,sizeof(ElementEntries)/sizeof(ElementEntries[0]));
+
 MusicBrainz5::CRecording::CRecording(const XMLNode& Node)
 :	CEntity(),
 	m_d(new CRecordingPrivate)
@@ -99,51 +139,83 @@ MusicBrainz5::CRecording& MusicBrainz5::CRecording::operator =(const CRecording&
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
-		m_d->m_Title=Other.m_d->m_Title;
-		m_d->m_Length=Other.m_d->m_Length;
-		m_d->m_Disambiguation=Other.m_d->m_Disambiguation;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_ID=Other.m_d->m_ID;
+			m_d->m_Title=Other.m_d->m_Title;
+			m_d->m_Length=Other.m_d->m_Length;
+			m_d->m_Disambiguation=Other.m_d->m_Disambiguation;
 
-		if (Other.m_d->m_ArtistCredit)
-			m_d->m_ArtistCredit=new CArtistCredit(*Other.m_d->m_ArtistCredit);
+			if (Other.m_d->m_ArtistCredit)
+				m_d->m_ArtistCredit=new CArtistCredit(*Other.m_d->m_ArtistCredit);
 
-		if (Other.m_d->m_ReleaseList)
-			m_d->m_ReleaseList=new CReleaseList(*Other.m_d->m_ReleaseList);
+			if (Other.m_d->m_ReleaseList)
+				m_d->m_ReleaseList=new CReleaseList(*Other.m_d->m_ReleaseList);
 
-		if (Other.m_d->m_PUIDList)
-			m_d->m_PUIDList=new CPUIDList(*Other.m_d->m_PUIDList);
+			if (Other.m_d->m_PUIDList)
+				m_d->m_PUIDList=new CPUIDList(*Other.m_d->m_PUIDList);
 
-		if (Other.m_d->m_ISRCList)
-			m_d->m_ISRCList=new CISRCList(*Other.m_d->m_ISRCList);
+			if (Other.m_d->m_ISRCList)
+				m_d->m_ISRCList=new CISRCList(*Other.m_d->m_ISRCList);
 
-		if (Other.m_d->m_RelationListList)
-			m_d->m_RelationListList=new CRelationListList(*Other.m_d->m_RelationListList);
+			if (Other.m_d->m_RelationListList)
+				m_d->m_RelationListList=new CRelationListList(*Other.m_d->m_RelationListList);
 
-		if (Other.m_d->m_TagList)
-			m_d->m_TagList=new CTagList(*Other.m_d->m_TagList);
+			if (Other.m_d->m_TagList)
+				m_d->m_TagList=new CTagList(*Other.m_d->m_TagList);
 
-		if (Other.m_d->m_UserTagList)
-			m_d->m_UserTagList=new CUserTagList(*Other.m_d->m_UserTagList);
+			if (Other.m_d->m_UserTagList)
+				m_d->m_UserTagList=new CUserTagList(*Other.m_d->m_UserTagList);
 
-		if (Other.m_d->m_Rating)
-			m_d->m_Rating=new CRating(*Other.m_d->m_Rating);
+			if (Other.m_d->m_Rating)
+				m_d->m_Rating=new CRating(*Other.m_d->m_Rating);
 
-		if (Other.m_d->m_UserRating)
-			m_d->m_UserRating=new CUserRating(*Other.m_d->m_UserRating);
+			if (Other.m_d->m_UserRating)
+				m_d->m_UserRating=new CUserRating(*Other.m_d->m_UserRating);
+		}
 	}
 
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+MusicBrainz5::CRecording::CRecording(CRecording&& Other)
+:	CEntity(),
+	m_d(new CRecordingPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CRecording& MusicBrainz5::CRecording::operator =(CRecording&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CRecording::~CRecording()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 MusicBrainz5::CRecording *MusicBrainz5::CRecording::Clone()
@@ -151,9 +223,9 @@ MusicBrainz5::CRecording *MusicBrainz5::CRecording::Clone()
 	return new CRecording(*this);
 }
 
-void MusicBrainz5::CRecording::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CRecording::ParseAttribute(const char *Name, const char *Value)
 {
-	if ("id"==Name)
+	if (0==strcmp(Name,"id"))
 		m_d->m_ID=Value;
 	else
 	{
@@ -165,61 +237,61 @@ void MusicBrainz5::CRecording::ParseAttribute(const std::string& Name, const std
 
 void MusicBrainz5::CRecording::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
-
-	if ("title"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Title);
-	}
-	else if ("length"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Length);
-	}
-	else if ("disambiguation"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Disambiguation);
-	}
-	else if ("artist-credit"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ArtistCredit);
-	}
-	else if ("release-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ReleaseList);
-	}
-	else if ("puid-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_PUIDList);
-	}
-	else if ("isrc-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ISRCList);
-	}
-	else if ("relation-list"==NodeName)
-	{
-		ProcessRelationList(Node,m_d->m_RelationListList);
-	}
-	else if ("tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_TagList);
-	}
-	else if ("user-tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserTagList);
-	}
-	else if ("rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Rating);
-	}
-	else if ("user-rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserRating);
-	}
-	else
+	switch (Elements.Find(Node.getName()))
 	{
+		case eElement_Title:
+			ProcessItem(Node,m_d->m_Title);
+			break;
+
+		case eElement_Length:
+			ProcessItem(Node,m_d->m_Length);
+			break;
+
+		case eElement_Disambiguation:
+			ProcessItem(Node,m_d->m_Disambiguation);
+			break;
+
+		case eElement_ArtistCredit:
+			ProcessItem(Node,m_d->m_ArtistCredit);
+			break;
+
+		case eElement_ReleaseList:
+			ProcessItem(Node,m_d->m_ReleaseList);
+			break;
+
+		case eElement_PUIDList:
+			ProcessItem(Node,m_d->m_PUIDList);
+			break;
+
+		case eElement_ISRCList:
+			ProcessItem(Node,m_d->m_ISRCList);
+			break;
+
+		case eElement_RelationList:
+			ProcessRelationList(Node,m_d->m_RelationListList);
+			break;
+
+		case eElement_TagList:
+			ProcessItem(Node,m_d->m_TagList);
+			break;
+
+		case eElement_UserTagList:
+			ProcessItem(Node,m_d->m_UserTagList);
+			break;
+
+		case eElement_Rating:
+			ProcessItem(Node,m_d->m_Rating);
+			break;
+
+		case eElement_UserRating:
+			ProcessItem(Node,m_d->m_UserRating);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised recording element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised recording element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -28,6 +28,10 @@
 
 #include "musicbrainz5/Relation.h"
 
+#include "musicbrainz5/NameTable.h"
+
+#include <string.h>
+
 #include "musicbrainz5/Artist.h"
 #include "musicbrainz5/Release.h"
 #include "musicbrainz5/ReleaseGroup.h"
@@ -37,11 +41,13 @@
 #include "musicbrainz5/AttributeList.h"
 #include "musicbrainz5/Attribute.h"
 
-class MusicBrainz5::CRelationPrivate
+class MusicBrainz5::CRelationPrivate: public CSharedData
 {
 	public:
 		CRelationPrivate()
-		:	m_AttributeList(0),
+		:	m_Type(CStringPool::Empty()),
+			m_Direction(CStringPool::Empty()),
+			m_AttributeList(0),
 			m_Artist(0),
 			m_Release(0),
 			m_ReleaseGroup(0),
@@ -51,9 +57,9 @@ class MusicBrainz5::CRelationPrivate
 		{
 		}
 
-		std::string m_Type;
+		const std::string *m_Type;
 		std::string m_Target;
-		std::string m_Direction;
+		const std::string *m_Direction;
 		CAttributeList *m_AttributeList;
 		std::string m_Begin;
 		std::string m_End;
@@ -66,6 +72,42 @@ class MusicBrainz5::CRelationPrivate
 		CWork *m_Work;
 };
 
+// Child elements handled by ParseElement
+
+enum
+{
+	eElement_Target,
+	eElement_Direction,
+	eElement_AttributeList,
+	eElement_Begin,
+	eElement_End,
+	eElement_Ended,
+	eElement_Artist,
+	eElement_Release,
+	eElement_ReleaseGroup,
+	eElement_Recording,
+	eElement_Label,
+	eElement_Work
+};
+
+static const MusicBrainz5::CNameTable::CEntry ElementEntries[]=
+{
+	{ "target", eElement_Target },
+	{ "direction", eElement_Direction },
+	{ "attribute-list", eElement_AttributeList },
+	{ "begin", eElement_Begin },
+	{ "end", eElement_End },
+	{ "ended", eElement_Ended },
+	{ "artist", eElement_Artist },
+	{ "release", eElement_Release },
+	{ "release-group", eElement_ReleaseGroup },
+	{ "recording", eElement_Recording },
+	{ "label", eElement_Label },
+	{ "work", eElement_Work }
+};
+
+static const MusicBrainz5::CNameTable Elements(ElementEntries,sizeof(ElementEntries)/sizeof(ElementEntries[0]));
+
 MusicBrainz5::CRelation::CRelation(const XMLNode& Node)
 :	CEntity(),
 	m_d(new CRelationPrivate)
@@ -89,48 +131,80 @@ MusicBrainz5::CRelation& MusicBrainz5::CRelation::operator =(const CRelation& Ot
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		m_d->m_Type=Other.m_d->m_Type;
-		m_d->m_Target=Other.m_d->m_Target;
-		m_d->m_Direction=Other.m_d->m_Direction;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_Type=Other.m_d->m_Type;
+			m_d->m_Target=Other.m_d->m_Target;
+			m_d->m_Direction=Other.m_d->m_Direction;
+
+			if (Other.m_d->m_AttributeList)
+				m_d->m_AttributeList=new CAttributeList(*Other.m_d->m_AttributeList);
 
-		if (Other.m_d->m_AttributeList)
-			m_d->m_AttributeList=new CAttributeList(*Other.m_d->m_AttributeList);
+			m_d->m_Begin=Other.m_d->m_Begin;
+			m_d->m_End=Other.m_d->m_End;
+			m_d->m_Ended=Other.m_d->m_Ended;
 
-		m_d->m_Begin=Other.m_d->m_Begin;
-		m_d->m_End=Other.m_d->m_End;
-		m_d->m_Ended=Other.m_d->m_Ended;
+			if (Other.m_d->m_Artist)
+				m_d->m_Artist=new CArtist(*Other.m_d->m_Artist);
 
-		if (Other.m_d->m_Artist)
-			m_d->m_Artist=new CArtist(*Other.m_d->m_Artist);
+			if (Other.m_d->m_Release)
+				m_d->m_Release=new CRelease(*Other.m_d->m_Release);
 
-		if (Other.m_d->m_Release)
-			m_d->m_Release=new CRelease(*Other.m_d->m_Release);
+			if (Other.m_d->m_ReleaseGroup)
+				m_d->m_ReleaseGroup=new CReleaseGroup(*Other.m_d->m_ReleaseGroup);
 
-		if (Other.m_d->m_ReleaseGroup)
-			m_d->m_ReleaseGroup=new CReleaseGroup(*Other.m_d->m_ReleaseGroup);
+			if (Other.m_d->m_Recording)
+				m_d->m_Recording=new CRecording(*Other.m_d->m_Recording);
 
-		if (Other.m_d->m_Recording)
-			m_d->m_Recording=new CRecording(*Other.m_d->m_Recording);
+			if (Other.m_d->m_Label)
+				m_d->m_Label=new CLabel(*Other.m_d->m_Label);
+
+			if (Other.m_d->m_Work)
+				m_d->m_Work=new CWork(*Other.m_d->m_Work);
+		}
+	}
+
+	return *this;
+}
 
-		if (Other.m_d->m_Label)
-			m_d->m_Label=new CLabel(*Other.m_d->m_Label);
+#if __cplusplus >= 201103L
+MusicBrainz5::CRelation::CRelation(CRelation&& Other)
+:	CEntity(),
+	m_d(new CRelationPrivate)
+{
+	*this=std::move(Other);
+}
 
-		if (Other.m_d->m_Work)
-			m_d->m_Work=new CWork(*Other.m_d->m_Work);
+MusicBrainz5::CRelation& MusicBrainz5::CRelation::operator =(CRelation&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CRelation::~CRelation()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::CRelation::Cleanup()
@@ -162,10 +236,10 @@ MusicBrainz5::CRelation *MusicBrainz5::CRelation::Clone()
 	return new CRelation(*this);
 }
 
-void MusicBrainz5::CRelation::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CRelation::ParseAttribute(const char *Name, const char *Value)
 {
-	if ("type"==Name)
-		m_d->m_Type=Value;
+	if (0==strcmp(Name,"type"))
+		m_d->m_Type=CStringPool::Intern(Value);
 	else
 	{
 #ifdef _MB5_DEBUG_
@@ -176,61 +250,61 @@ void MusicBrainz5::CRelation::ParseAttribute(const std::string& Name, const std:
 
 void MusicBrainz5::CRelation::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
-
-	if ("target"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Target);
-	}
-	else if ("direction"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Direction);
-	}
-	else if ("attribute-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_AttributeList);
-	}
-	else if ("begin"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Begin);
-	}
-	else if ("end"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_End);
-	}
-	else if ("ended"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Ended);
-	}
-	else if ("artist"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Artist);
-	}
-	else if ("release"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Release);
-	}
-	else if ("release-group"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ReleaseGroup);
-	}
-	else if ("recording"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Recording);
-	}
-	else if ("label"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Label);
-	}
-	else if ("work"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Work);
-	}
-	else
+	switch (Elements.Find(Node.getName()))
 	{
+		case eElement_Target:
+			ProcessItem(Node,m_d->m_Target);
+			break;
+
+		case eElement_Direction:
+			ProcessItem(Node,m_d->m_Direction);
+			break;
+
+		case eElement_AttributeList:
+			ProcessItem(Node,m_d->m_AttributeList);
+			break;
+
+		case eElement_Begin:
+			ProcessItem(Node,m_d->m_Begin);
+			break;
+
+		case eElement_End:
+			ProcessItem(Node,m_d->m_End);
+			break;
+
+		case eElement_Ended:
+			ProcessItem(Node,m_d->m_Ended);
+			break;
+
+		case eElement_Artist:
+			ProcessItem(Node,m_d->m_Artist);
+			break;
+
+		case eElement_Release:
+			ProcessItem(Node,m_d->m_Release);
+			break;
+
+		case eElement_ReleaseGroup:
+			ProcessItem(Node,m_d->m_ReleaseGroup);
+			break;
+
+		case eElement_Recording:
+			ProcessItem(Node,m_d->m_Recording);
+			break;
+
+		case eElement_Label:
+			ProcessItem(Node,m_d->m_Label);
+			break;
+
+		case eElement_Work:
+			ProcessItem(Node,m_d->m_Work);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised relation element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised relation element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -240,6 +314,11 @@ std::string MusicBrainz5::CRelation::GetElementName()
 }
 
 std::string MusicBrainz5::CRelation::Type() const
+{
+	return *m_d->m_Type;
+}
+
+const std::string *MusicBrainz5::CRelation::InternedType() const
 {
 	return m_d->m_Type;
 }
@@ -250,6 +329,11 @@ std::string MusicBrainz5::CRelation::Target() const
 }
 
 std::string MusicBrainz5::CRelation::Direction() const
+{
+	return *m_d->m_Direction;
+}
+
+const std::string *MusicBrainz5::CRelation::InternedDirection() const
 {
 	return m_d->m_Direction;
 }
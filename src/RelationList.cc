@@ -28,12 +28,19 @@
 
 #include "musicbrainz5/RelationList.h"
 
+#include <string.h>
+
 #include "musicbrainz5/Relation.h"
 
-class MusicBrainz5::CRelationListPrivate
+class MusicBrainz5::CRelationListPrivate: public CSharedData
 {
 	public:
-		std::string m_TargetType;
+		CRelationListPrivate()
+		:	m_TargetType(CStringPool::Empty())
+		{
+		}
+
+		const std::string *m_TargetType;
 };
 
 MusicBrainz5::CRelationList::CRelationList(const XMLNode& Node)
@@ -59,17 +66,46 @@ MusicBrainz5::CRelationList& MusicBrainz5::CRelationList::operator =(const CRela
 {
 	if (this!=&Other)
 	{
+		CSharedData::Unshare(m_d);
+
 		CListImpl<CRelation>::operator =(Other);
 
-		m_d->m_TargetType=Other.m_d->m_TargetType;
+		if (!CSharedData::Share(m_d,Other.m_d))
+			m_d->m_TargetType=Other.m_d->m_TargetType;
 	}
 
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+MusicBrainz5::CRelationList::CRelationList(CRelationList&& Other)
+:	CListImpl<CRelation>(),
+	m_d(new CRelationListPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CRelationList& MusicBrainz5::CRelationList::operator =(CRelationList&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CListImpl<CRelation>::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CRelationList::~CRelationList()
 {
-	delete m_d;
+	if (m_d->RemoveReference())
+		delete m_d;
 }
 
 MusicBrainz5::CRelationList *MusicBrainz5::CRelationList::Clone()
@@ -77,9 +113,9 @@ MusicBrainz5::CRelationList *MusicBrainz5::CRelationList::Clone()
 	return new CRelationList(*this);
 }
 
-void MusicBrainz5::CRelationList::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CRelationList::ParseAttribute(const char *Name, const char *Value)
 {
-	if ("target-type"==Name)
+	if (0==strcmp(Name,"target-type"))
 		ProcessItem(Value,m_d->m_TargetType);
 	else
 		CListImpl<CRelation>::ParseAttribute(Name,Value);
@@ -96,6 +132,11 @@ std::string MusicBrainz5::CRelationList::GetElementName()
 }
 
 std::string MusicBrainz5::CRelationList::TargetType() const
+{
+	return *m_d->m_TargetType;
+}
+
+const std::string *MusicBrainz5::CRelationList::InternedTargetType() const
 {
 	return m_d->m_TargetType;
 }
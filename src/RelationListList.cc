@@ -33,7 +33,7 @@
 #include "musicbrainz5/RelationList.h"
 #include "musicbrainz5/Relation.h"
 
-class MusicBrainz5::CRelationListListPrivate
+class MusicBrainz5::CRelationListListPrivate: public CSharedData
 {
 	public:
 		CRelationListListPrivate()
@@ -59,16 +59,20 @@ MusicBrainz5::CRelationListList& MusicBrainz5::CRelationListList::operator =(con
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
-		if (Other.m_d->m_ListGroup)
+		if (!CSharedData::Share(m_d,Other.m_d))
 		{
-			m_d->m_ListGroup=new std::vector<CRelationList *>;
-
-			for (std::vector<CRelationList *>::const_iterator ThisRelationList=Other.m_d->m_ListGroup->begin();ThisRelationList!=Other.m_d->m_ListGroup->end();++ThisRelationList)
+			if (Other.m_d->m_ListGroup)
 			{
-				CRelationList *RelationList=*ThisRelationList;
-				m_d->m_ListGroup->push_back(new CRelationList(*RelationList));
+				m_d->m_ListGroup=new std::vector<CRelationList *>;
+
+				for (std::vector<CRelationList *>::const_iterator ThisRelationList=Other.m_d->m_ListGroup->begin();ThisRelationList!=Other.m_d->m_ListGroup->end();++ThisRelationList)
+				{
+					CRelationList *RelationList=*ThisRelationList;
+					m_d->m_ListGroup->push_back(new CRelationList(*RelationList));
+				}
 			}
 		}
 	}
@@ -76,11 +80,35 @@ MusicBrainz5::CRelationListList& MusicBrainz5::CRelationListList::operator =(con
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+MusicBrainz5::CRelationListList::CRelationListList(CRelationListList&& Other)
+:	m_d(new CRelationListListPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CRelationListList& MusicBrainz5::CRelationListList::operator =(CRelationListList&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+			std::swap(m_d,Other.m_d);
+		else
+			*this=Other;
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CRelationListList::~CRelationListList()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::CRelationListList::Cleanup()
@@ -28,6 +28,8 @@
 
 #include "musicbrainz5/Release.h"
 
+#include "musicbrainz5/NameTable.h"
+
 #include <string.h>
 
 #include "musicbrainz5/TextRepresentation.h"
@@ -44,13 +46,17 @@
 #include "musicbrainz5/Collection.h"
 #include "musicbrainz5/CollectionList.h"
 
-class MusicBrainz5::CReleasePrivate
+class MusicBrainz5::CReleasePrivate: public CSharedData
 {
 	public:
 		CReleasePrivate()
-		:	m_TextRepresentation(0),
+		:	m_Status(CStringPool::Empty()),
+			m_Quality(CStringPool::Empty()),
+			m_Packaging(CStringPool::Empty()),
+			m_TextRepresentation(0),
 			m_ArtistCredit(0),
 			m_ReleaseGroup(0),
+			m_Country(CStringPool::Empty()),
 			m_LabelInfoList(0),
 			m_MediumList(0),
 			m_RelationListList(0),
@@ -60,15 +66,15 @@ class MusicBrainz5::CReleasePrivate
 
 		std::string m_ID;
 		std::string m_Title;
-		std::string m_Status;
-		std::string m_Quality;
+		const std::string *m_Status;
+		const std::string *m_Quality;
 		std::string m_Disambiguation;
-		std::string m_Packaging;
+		const std::string *m_Packaging;
 		CTextRepresentation *m_TextRepresentation;
 		CArtistCredit *m_ArtistCredit;
 		CReleaseGroup *m_ReleaseGroup;
 		std::string m_Date;
-		std::string m_Country;
+		const std::string *m_Country;
 		std::string m_Barcode;
 		std::string m_ASIN;
 		CLabelInfoList *m_LabelInfoList;
@@ -77,6 +83,50 @@ class MusicBrainz5::CReleasePrivate
 		CCollectionList *m_CollectionList;
 };
 
+// Child elements handled by ParseElement
+
+enum
+{
+	eElement_Title,
+	eElement_Status,
+	eElement_Quality,
+	eElement_Disambiguation,
+	eElement_Packaging,
+	eElement_TextRepresentation,
+	eElement_ArtistCredit,
+	eElement_ReleaseGroup,
+	eElement_Date,
+	eElement_Country,
+	eElement_Barcode,
+	eElement_ASIN,
+	eElement_LabelInfoList,
+	eElement_MediumList,
+	eElement_RelationList,
+	eElement_CollectionList
+};
+
+static const MusicBrainz5::CNameTable::CEntry ElementEntries[]=
+{
+	{ "title", eElement_Title },
+	{ "status", eElement_Status },
+	{ "quality", eElement_Quality },
+	{ "disambiguation", eElement_Disambiguation },
+	{ "packaging", eElement_Packaging },
+	{ "text-representation", eElement_TextRepresentation },
+	{ "artist-credit", eElement_ArtistCredit },
+	{ "release-group", eElement_ReleaseGroup },
+	{ "date", eElement_Date },
+	{ "country", eElement_Country },
+	{ "barcode", eElement_Barcode },
+	{ "asin", eElement_ASIN },
+	{ "label-info-list", eElement_LabelInfoList },
+	{ "medium-list", eElement_MediumList },
+	{ "relation-list", eElement_RelationList },
+	{ "collection-list", eElement_CollectionList }
+};
+
+static const MusicBrainz5::CNameTable Elements(ElementEntries,sizeof(ElementEntries)/sizeof(ElementEntries[0]));
+
 MusicBrainz5::CRelease::CRelease(const XMLNode& Node)
 :	CEntity(),
 	m_d(new CReleasePrivate)
@@ -100,52 +150,84 @@ MusicBrainz5::CRelease& MusicBrainz5::CRelease::operator =(const CRelease& Other
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
-		m_d->m_Title=Other.m_d->m_Title;
-		m_d->m_Status=Other.m_d->m_Status;
-		m_d->m_Quality=Other.m_d->m_Quality;
-		m_d->m_Disambiguation=Other.m_d->m_Disambiguation;
-		m_d->m_Packaging=Other.m_d->m_Packaging;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_ID=Other.m_d->m_ID;
+			m_d->m_Title=Other.m_d->m_Title;
+			m_d->m_Status=Other.m_d->m_Status;
+			m_d->m_Quality=Other.m_d->m_Quality;
+			m_d->m_Disambiguation=Other.m_d->m_Disambiguation;
+			m_d->m_Packaging=Other.m_d->m_Packaging;
 
-		if (Other.m_d->m_TextRepresentation)
-			m_d->m_TextRepresentation=new CTextRepresentation(*Other.m_d->m_TextRepresentation);
+			if (Other.m_d->m_TextRepresentation)
+				m_d->m_TextRepresentation=new CTextRepresentation(*Other.m_d->m_TextRepresentation);
 
-		if (Other.m_d->m_ArtistCredit)
-			m_d->m_ArtistCredit=new CArtistCredit(*Other.m_d->m_ArtistCredit);
+			if (Other.m_d->m_ArtistCredit)
+				m_d->m_ArtistCredit=new CArtistCredit(*Other.m_d->m_ArtistCredit);
 
-		if (Other.m_d->m_ReleaseGroup)
-			m_d->m_ReleaseGroup=new CReleaseGroup(*Other.m_d->m_ReleaseGroup);
+			if (Other.m_d->m_ReleaseGroup)
+				m_d->m_ReleaseGroup=new CReleaseGroup(*Other.m_d->m_ReleaseGroup);
 
-		m_d->m_Date=Other.m_d->m_Date;
-		m_d->m_Country=Other.m_d->m_Country;
-		m_d->m_Barcode=Other.m_d->m_Barcode;
-		m_d->m_ASIN=Other.m_d->m_ASIN;
+			m_d->m_Date=Other.m_d->m_Date;
+			m_d->m_Country=Other.m_d->m_Country;
+			m_d->m_Barcode=Other.m_d->m_Barcode;
+			m_d->m_ASIN=Other.m_d->m_ASIN;
 
-		if (Other.m_d->m_LabelInfoList)
-			m_d->m_LabelInfoList=new CLabelInfoList(*Other.m_d->m_LabelInfoList);
+			if (Other.m_d->m_LabelInfoList)
+				m_d->m_LabelInfoList=new CLabelInfoList(*Other.m_d->m_LabelInfoList);
 
-		if (Other.m_d->m_MediumList)
-			m_d->m_MediumList=new CMediumList(*Other.m_d->m_MediumList);
+			if (Other.m_d->m_MediumList)
+				m_d->m_MediumList=new CMediumList(*Other.m_d->m_MediumList);
 
-		if (Other.m_d->m_RelationListList)
-			m_d->m_RelationListList=new CRelationListList(*Other.m_d->m_RelationListList);
+			if (Other.m_d->m_RelationListList)
+				m_d->m_RelationListList=new CRelationListList(*Other.m_d->m_RelationListList);
 
-		if (Other.m_d->m_CollectionList)
-			m_d->m_CollectionList=new CCollectionList(*Other.m_d->m_CollectionList);
+			if (Other.m_d->m_CollectionList)
+				m_d->m_CollectionList=new CCollectionList(*Other.m_d->m_CollectionList);
+		}
 	}
 
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+MusicBrainz5::CRelease::CRelease(CRelease&& Other)
+:	CEntity(),
+	m_d(new CReleasePrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CRelease& MusicBrainz5::CRelease::operator =(CRelease&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CRelease::~CRelease()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::CRelease::Cleanup()
@@ -174,9 +256,9 @@ MusicBrainz5::CRelease *MusicBrainz5::CRelease::Clone()
 	return new CRelease(*this);
 }
 
-void MusicBrainz5::CRelease::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CRelease::ParseAttribute(const char *Name, const char *Value)
 {
-	if ("id"==Name)
+	if (0==strcmp(Name,"id"))
 		m_d->m_ID=Value;
 	else
 	{
@@ -188,77 +270,77 @@ void MusicBrainz5::CRelease::ParseAttribute(const std::string& Name, const std::
 
 void MusicBrainz5::CRelease::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
-
-	if ("title"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Title);
-	}
-	else if ("status"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Status);
-	}
-	else if ("quality"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Quality);
-	}
-	else if ("disambiguation"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Disambiguation);
-	}
-	else if ("packaging"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Packaging);
-	}
-	else if ("text-representation"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_TextRepresentation);
-	}
-	else if ("artist-credit"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ArtistCredit);
-	}
-	else if ("release-group"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ReleaseGroup);
-	}
-	else if ("date"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Date);
-	}
-	else if ("country"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Country);
-	}
-	else if ("barcode"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Barcode);
-	}
-	else if ("asin"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ASIN);
-	}
-	else if ("label-info-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_LabelInfoList);
-	}
-	else if ("medium-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_MediumList);
-	}
-	else if ("relation-list"==NodeName)
-	{
-		ProcessRelationList(Node,m_d->m_RelationListList);
-	}
-	else if ("collection-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_CollectionList);
-	}
-	else
+	switch (Elements.Find(Node.getName()))
 	{
+		case eElement_Title:
+			ProcessItem(Node,m_d->m_Title);
+			break;
+
+		case eElement_Status:
+			ProcessItem(Node,m_d->m_Status);
+			break;
+
+		case eElement_Quality:
+			ProcessItem(Node,m_d->m_Quality);
+			break;
+
+		case eElement_Disambiguation:
+			ProcessItem(Node,m_d->m_Disambiguation);
+			break;
+
+		case eElement_Packaging:
+			ProcessItem(Node,m_d->m_Packaging);
+			break;
+
+		case eElement_TextRepresentation:
+			ProcessItem(Node,m_d->m_TextRepresentation);
+			break;
+
+		case eElement_ArtistCredit:
+			ProcessItem(Node,m_d->m_ArtistCredit);
+			break;
+
+		case eElement_ReleaseGroup:
+			ProcessItem(Node,m_d->m_ReleaseGroup);
+			break;
+
+		case eElement_Date:
+			ProcessItem(Node,m_d->m_Date);
+			break;
+
+		case eElement_Country:
+			ProcessItem(Node,m_d->m_Country);
+			break;
+
+		case eElement_Barcode:
+			ProcessItem(Node,m_d->m_Barcode);
+			break;
+
+		case eElement_ASIN:
+			ProcessItem(Node,m_d->m_ASIN);
+			break;
+
+		case eElement_LabelInfoList:
+			ProcessItem(Node,m_d->m_LabelInfoList);
+			break;
+
+		case eElement_MediumList:
+			ProcessItem(Node,m_d->m_MediumList);
+			break;
+
+		case eElement_RelationList:
+			ProcessRelationList(Node,m_d->m_RelationListList);
+			break;
+
+		case eElement_CollectionList:
+			ProcessItem(Node,m_d->m_CollectionList);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised release element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised release element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -278,11 +360,21 @@ std::string MusicBrainz5::CRelease::Title() const
 }
 
 std::string MusicBrainz5::CRelease::Status() const
+{
+	return *m_d->m_Status;
+}
+
+const std::string *MusicBrainz5::CRelease::InternedStatus() const
 {
 	return m_d->m_Status;
 }
 
 std::string MusicBrainz5::CRelease::Quality() const
+{
+	return *m_d->m_Quality;
+}
+
+const std::string *MusicBrainz5::CRelease::InternedQuality() const
 {
 	return m_d->m_Quality;
 }
@@ -293,6 +385,11 @@ std::string MusicBrainz5::CRelease::Disambiguation() const
 }
 
 std::string MusicBrainz5::CRelease::Packaging() const
+{
+	return *m_d->m_Packaging;
+}
+
+const std::string *MusicBrainz5::CRelease::InternedPackaging() const
 {
 	return m_d->m_Packaging;
 }
@@ -318,6 +415,11 @@ std::string MusicBrainz5::CRelease::Date() const
 }
 
 std::string MusicBrainz5::CRelease::Country() const
+{
+	return *m_d->m_Country;
+}
+
+const std::string *MusicBrainz5::CRelease::InternedCountry() const
 {
 	return m_d->m_Country;
 }
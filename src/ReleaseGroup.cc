@@ -28,6 +28,10 @@
 
 #include "musicbrainz5/ReleaseGroup.h"
 
+#include "musicbrainz5/NameTable.h"
+
+#include <string.h>
+
 #include "musicbrainz5/ArtistCredit.h"
 #include "musicbrainz5/Rating.h"
 #include "musicbrainz5/UserRating.h"
@@ -43,7 +47,7 @@
 #include "musicbrainz5/SecondaryTypeList.h"
 #include "musicbrainz5/SecondaryType.h"
 
-class MusicBrainz5::CReleaseGroupPrivate
+class MusicBrainz5::CReleaseGroupPrivate: public CSharedData
 {
 	public:
 		CReleaseGroupPrivate()
@@ -73,6 +77,42 @@ class MusicBrainz5::CReleaseGroupPrivate
 		CSecondaryTypeList *m_SecondaryTypeList;
 };
 
+// Child elements handled by ParseElement
+
+enum
+{
+	eElement_PrimaryType,
+	eElement_Title,
+	eElement_Disambiguation,
+	eElement_FirstReleaseDate,
+	eElement_ArtistCredit,
+	eElement_ReleaseList,
+	eElement_RelationList,
+	eElement_TagList,
+	eElement_UserTagList,
+	eElement_Rating,
+	eElement_UserRating,
+	eElement_SecondaryTypeList
+};
+
+static const MusicBrainz5::CNameTable::CEntry ElementEntries[]=
+{
+	{ "primary-type", eElement_PrimaryType },
+	{ "title", eElement_Title },
+	{ "disambiguation", eElement_Disambiguation },
+	{ "first-release-date", eElement_FirstReleaseDate },
+	{ "artist-credit", eElement_ArtistCredit },
+	{ "release-list", eElement_ReleaseList },
+	{ "relation-list", eElement_RelationList },
+	{ "tag-list", eElement_TagList },
+	{ "user-tag-list", eElement_UserTagList },
+	{ "rating", eElement_Rating },
+	{ "user-rating", eElement_UserRating },
+	{ "secondary-type-list", eElement_SecondaryTypeList }
+};
+
+static const MusicBrainz5::CNameTable Elements(ElementEntries,sizeof(ElementEntries)/sizeof(ElementEntries[0]));
+
 MusicBrainz5::CReleaseGroup::CReleaseGroup(const XMLNode& Node)
 :	CEntity(),
 	m_d(new CReleaseGroupPrivate)
@@ -96,49 +136,81 @@ MusicBrainz5::CReleaseGroup& MusicBrainz5::CReleaseGroup::operator =(const CRele
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
-		m_d->m_PrimaryType=Other.m_d->m_PrimaryType;
-		m_d->m_Title=Other.m_d->m_Title;
-		m_d->m_Disambiguation=Other.m_d->m_Disambiguation;
-		m_d->m_FirstReleaseDate=Other.m_d->m_FirstReleaseDate;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_ID=Other.m_d->m_ID;
+			m_d->m_PrimaryType=Other.m_d->m_PrimaryType;
+			m_d->m_Title=Other.m_d->m_Title;
+			m_d->m_Disambiguation=Other.m_d->m_Disambiguation;
+			m_d->m_FirstReleaseDate=Other.m_d->m_FirstReleaseDate;
 
-		if (Other.m_d->m_ArtistCredit)
-			m_d->m_ArtistCredit=new CArtistCredit(*Other.m_d->m_ArtistCredit);
+			if (Other.m_d->m_ArtistCredit)
+				m_d->m_ArtistCredit=new CArtistCredit(*Other.m_d->m_ArtistCredit);
 
-		if (Other.m_d->m_ReleaseList)
-			m_d->m_ReleaseList=new CReleaseList(*Other.m_d->m_ReleaseList);
+			if (Other.m_d->m_ReleaseList)
+				m_d->m_ReleaseList=new CReleaseList(*Other.m_d->m_ReleaseList);
 
-		if (Other.m_d->m_RelationListList)
-			m_d->m_RelationListList=new CRelationListList(*Other.m_d->m_RelationListList);
+			if (Other.m_d->m_RelationListList)
+				m_d->m_RelationListList=new CRelationListList(*Other.m_d->m_RelationListList);
 
-		if (Other.m_d->m_TagList)
-			m_d->m_TagList=new CTagList(*Other.m_d->m_TagList);
+			if (Other.m_d->m_TagList)
+				m_d->m_TagList=new CTagList(*Other.m_d->m_TagList);
 
-		if (Other.m_d->m_UserTagList)
-			m_d->m_UserTagList=new CUserTagList(*Other.m_d->m_UserTagList);
+			if (Other.m_d->m_UserTagList)
+				m_d->m_UserTagList=new CUserTagList(*Other.m_d->m_UserTagList);
 
-		if (Other.m_d->m_Rating)
-			m_d->m_Rating=new CRating(*Other.m_d->m_Rating);
+			if (Other.m_d->m_Rating)
+				m_d->m_Rating=new CRating(*Other.m_d->m_Rating);
 
-		if (Other.m_d->m_UserRating)
-			m_d->m_UserRating=new CUserRating(*Other.m_d->m_UserRating);
+			if (Other.m_d->m_UserRating)
+				m_d->m_UserRating=new CUserRating(*Other.m_d->m_UserRating);
 
-		if (Other.m_d->m_SecondaryTypeList)
-			m_d->m_SecondaryTypeList=new CSecondaryTypeList(*Other.m_d->m_SecondaryTypeList);
+			if (Other.m_d->m_SecondaryTypeList)
+				m_d->m_SecondaryTypeList=new CSecondaryTypeList(*Other.m_d->m_SecondaryTypeList);
+		}
 	}
 
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+MusicBrainz5::CReleaseGroup::CReleaseGroup(CReleaseGroup&& Other)
+:	CEntity(),
+	m_d(new CReleaseGroupPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CReleaseGroup& MusicBrainz5::CReleaseGroup::operator =(CReleaseGroup&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CReleaseGroup::~CReleaseGroup()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::CReleaseGroup::Cleanup()
@@ -173,11 +245,11 @@ MusicBrainz5::CReleaseGroup *MusicBrainz5::CReleaseGroup::Clone()
 	return new CReleaseGroup(*this);
 }
 
-void MusicBrainz5::CReleaseGroup::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CReleaseGroup::ParseAttribute(const char *Name, const char *Value)
 {
-	if ("id"==Name)
+	if (0==strcmp(Name,"id"))
 		m_d->m_ID=Value;
-	else if ("type"==Name)
+	else if (0==strcmp(Name,"type"))
 	{
 		//Ignore type
 	}
@@ -191,61 +263,61 @@ void MusicBrainz5::CReleaseGroup::ParseAttribute(const std::string& Name, const
 
 void MusicBrainz5::CReleaseGroup::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
-
-	if ("primary-type"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_PrimaryType);
-	}
-	else if ("title"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Title);
-	}
-	else if ("disambiguation"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Disambiguation);
-	}
-	else if ("first-release-date"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_FirstReleaseDate);
-	}
-	else if ("artist-credit"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ArtistCredit);
-	}
-	else if ("release-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ReleaseList);
-	}
-	else if ("relation-list"==NodeName)
-	{
-		ProcessRelationList(Node,m_d->m_RelationListList);
-	}
-	else if ("tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_TagList);
-	}
-	else if ("user-tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserTagList);
-	}
-	else if ("rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Rating);
-	}
-	else if ("user-rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserRating);
-	}
-	else if ("secondary-type-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_SecondaryTypeList);
-	}
-	else
+	switch (Elements.Find(Node.getName()))
 	{
+		case eElement_PrimaryType:
+			ProcessItem(Node,m_d->m_PrimaryType);
+			break;
+
+		case eElement_Title:
+			ProcessItem(Node,m_d->m_Title);
+			break;
+
+		case eElement_Disambiguation:
+			ProcessItem(Node,m_d->m_Disambiguation);
+			break;
+
+		case eElement_FirstReleaseDate:
+			ProcessItem(Node,m_d->m_FirstReleaseDate);
+			break;
+
+		case eElement_ArtistCredit:
+			ProcessItem(Node,m_d->m_ArtistCredit);
+			break;
+
+		case eElement_ReleaseList:
+			ProcessItem(Node,m_d->m_ReleaseList);
+			break;
+
+		case eElement_RelationList:
+			ProcessRelationList(Node,m_d->m_RelationListList);
+			break;
+
+		case eElement_TagList:
+			ProcessItem(Node,m_d->m_TagList);
+			break;
+
+		case eElement_UserTagList:
+			ProcessItem(Node,m_d->m_UserTagList);
+			break;
+
+		case eElement_Rating:
+			ProcessItem(Node,m_d->m_Rating);
+			break;
+
+		case eElement_UserRating:
+			ProcessItem(Node,m_d->m_UserRating);
+			break;
+
+		case eElement_SecondaryTypeList:
+			ProcessItem(Node,m_d->m_SecondaryTypeList);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised release group element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised release group element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -0,0 +1,311 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/SearchResults.h"
+
+#include <map>
+#include <sstream>
+
+#include <pthread.h>
+
+#include "musicbrainz5/ArtistList.h"
+#include "musicbrainz5/ReleaseList.h"
+#include "musicbrainz5/ReleaseGroupList.h"
+#include "musicbrainz5/RecordingList.h"
+#include "musicbrainz5/LabelList.h"
+#include "musicbrainz5/WorkList.h"
+#include "musicbrainz5/AnnotationList.h"
+#include "musicbrainz5/CDStubList.h"
+#include "musicbrainz5/FreeDBDiscList.h"
+#include "musicbrainz5/TagList.h"
+#include "musicbrainz5/CollectionList.h"
+
+class MusicBrainz5::CSearchResultsBasePrivate
+{
+	public:
+		CSearchResultsBasePrivate()
+		:	m_Query(0),
+			m_PageSize(100),
+			m_Prefetch(2),
+			m_Count(-1),
+			m_NextPage(0),
+			m_NextRequest(0),
+			m_Pending(0),
+			m_Current(0)
+		{
+			pthread_mutex_init(&m_Lock,0);
+			pthread_cond_init(&m_PageDone,0);
+		}
+
+		~CSearchResultsBasePrivate()
+		{
+			pthread_cond_destroy(&m_PageDone);
+			pthread_mutex_destroy(&m_Lock);
+		}
+
+		class CPage
+		{
+			public:
+				CPage(CSearchResultsBasePrivate *Results)
+				:	m_Results(Results),
+					m_Complete(false),
+					m_Result(CQuery::eQuery_Success)
+				{
+				}
+
+				CSearchResultsBasePrivate *m_Results;
+				bool m_Complete;
+				CMetadata m_Metadata;
+				CQuery::tQueryResult m_Result;
+				std::string m_ErrorMessage;
+		};
+
+		CQuery *m_Query;
+		std::string m_Entity;
+		CQuery::tParamMap m_Params;
+		int m_PageSize;
+		int m_Prefetch;
+		int m_Count;
+		int m_NextPage;
+		int m_NextRequest;
+		int m_Pending;
+		std::map<int,CPage *> m_Pages;
+		CPage *m_Current;
+		pthread_mutex_t m_Lock;
+		pthread_cond_t m_PageDone;
+};
+
+MusicBrainz5::CSearchResultsBase::CSearchResultsBase(CQuery& Query, const std::string& Entity, const CQuery::tParamMap& Params, int PageSize, int Prefetch)
+:	m_d(new CSearchResultsBasePrivate)
+{
+	m_d->m_Query=&Query;
+	m_d->m_Entity=Entity;
+	m_d->m_Params=Params;
+	m_d->m_PageSize=PageSize>0 ? PageSize : 1;
+	m_d->m_Prefetch=Prefetch>0 ? Prefetch : 0;
+}
+
+MusicBrainz5::CSearchResultsBase::~CSearchResultsBase()
+{
+	// Pages still being fetched refer to this object
+
+	pthread_mutex_lock(&m_d->m_Lock);
+
+	while (m_d->m_Pending!=0)
+		pthread_cond_wait(&m_d->m_PageDone,&m_d->m_Lock);
+
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	std::map<int,CSearchResultsBasePrivate::CPage *>::iterator ThisPage=m_d->m_Pages.begin();
+	while (ThisPage!=m_d->m_Pages.end())
+	{
+		delete (*ThisPage).second;
+		++ThisPage;
+	}
+
+	delete m_d->m_Current;
+	delete m_d;
+}
+
+int MusicBrainz5::CSearchResultsBase::Count() const
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+	int Ret=m_d->m_Count;
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return Ret;
+}
+
+int MusicBrainz5::CSearchResultsBase::PageSize() const
+{
+	return m_d->m_PageSize;
+}
+
+int MusicBrainz5::CSearchResultsBase::Prefetch() const
+{
+	return m_d->m_Prefetch;
+}
+
+MusicBrainz5::CList *MusicBrainz5::CSearchResultsBase::NextPage()
+{
+	pthread_mutex_lock(&m_d->m_Lock);
+
+	delete m_d->m_Current;
+	m_d->m_Current=0;
+
+	if (m_d->m_Count>=0 && m_d->m_NextPage*m_d->m_PageSize>=m_d->m_Count)
+	{
+		pthread_mutex_unlock(&m_d->m_Lock);
+
+		return 0;
+	}
+
+	// A page that failed earlier is requested again
+
+	if (m_d->m_NextPage<m_d->m_NextRequest && m_d->m_Pages.end()==m_d->m_Pages.find(m_d->m_NextPage))
+		RequestPage(m_d->m_NextPage);
+
+	RequestPages();
+
+	CSearchResultsBasePrivate::CPage *Page=m_d->m_Pages[m_d->m_NextPage];
+
+	while (!Page->m_Complete)
+		pthread_cond_wait(&m_d->m_PageDone,&m_d->m_Lock);
+
+	m_d->m_Pages.erase(m_d->m_NextPage);
+
+	if (CQuery::eQuery_Success!=Page->m_Result)
+	{
+		// The page is not skipped, so the next call tries it again
+
+		CQuery::tQueryResult Result=Page->m_Result;
+		std::string ErrorMessage=Page->m_ErrorMessage;
+
+		delete Page;
+
+		pthread_mutex_unlock(&m_d->m_Lock);
+
+		CQuery::ThrowError(Result,ErrorMessage);
+
+		return 0;
+	}
+
+	m_d->m_NextPage++;
+
+	m_d->m_Current=Page;
+
+	CList *List=PageList(Page->m_Metadata);
+
+	if (m_d->m_Count<0)
+	{
+		// The first page tells us how many pages there are
+
+		m_d->m_Count=List ? List->Count() : 0;
+		RequestPages();
+	}
+
+	// Results may have been removed since the count was given
+
+	if (!List || 0==List->NumItems())
+	{
+		m_d->m_Count=(m_d->m_NextPage-1)*m_d->m_PageSize;
+		List=0;
+	}
+
+	pthread_mutex_unlock(&m_d->m_Lock);
+
+	return List;
+}
+
+void MusicBrainz5::CSearchResultsBase::RequestPages()
+{
+	// Until the number of results is known, only the first page is requested
+
+	int LastPage=m_d->m_NextPage;
+
+	if (m_d->m_Count>=0)
+	{
+		LastPage+=m_d->m_Prefetch;
+
+		int NumPages=(m_d->m_Count+m_d->m_PageSize-1)/m_d->m_PageSize;
+		if (LastPage>=NumPages)
+			LastPage=NumPages-1;
+	}
+
+	while (m_d->m_NextRequest<=LastPage)
+		RequestPage(m_d->m_NextRequest++);
+}
+
+void MusicBrainz5::CSearchResultsBase::RequestPage(int PageNum)
+{
+	std::stringstream Limit;
+	Limit << m_d->m_PageSize;
+
+	std::stringstream Offset;
+	Offset << PageNum*m_d->m_PageSize;
+
+	CQuery::tParamMap Params(m_d->m_Params);
+	Params["limit"]=Limit.str();
+	Params["offset"]=Offset.str();
+
+	CSearchResultsBasePrivate::CPage *Page=new CSearchResultsBasePrivate::CPage(m_d);
+	m_d->m_Pages[PageNum]=Page;
+	m_d->m_Pending++;
+
+	m_d->m_Query->QueryAsync(m_d->m_Entity,"","",Params,PageCompleted,Page);
+}
+
+MusicBrainz5::CList *MusicBrainz5::CSearchResultsBase::PageList(const CMetadata& Metadata) const
+{
+	const std::string& Entity=m_d->m_Entity;
+
+	if ("artist"==Entity)
+		return Metadata.ArtistList();
+	else if ("release"==Entity)
+		return Metadata.ReleaseList();
+	else if ("release-group"==Entity)
+		return Metadata.ReleaseGroupList();
+	else if ("recording"==Entity)
+		return Metadata.RecordingList();
+	else if ("label"==Entity)
+		return Metadata.LabelList();
+	else if ("work"==Entity)
+		return Metadata.WorkList();
+	else if ("annotation"==Entity)
+		return Metadata.AnnotationList();
+	else if ("cdstub"==Entity)
+		return Metadata.CDStubList();
+	else if ("freedb-disc"==Entity)
+		return Metadata.FreeDBDiscList();
+	else if ("tag"==Entity)
+		return Metadata.TagList();
+	else if ("collection"==Entity)
+		return Metadata.CollectionList();
+
+	return 0;
+}
+
+void MusicBrainz5::CSearchResultsBase::PageCompleted(const CMetadata& Metadata, CQuery::tQueryResult Result, const std::string& ErrorMessage, void *UserData)
+{
+	CSearchResultsBasePrivate::CPage *Page=reinterpret_cast<CSearchResultsBasePrivate::CPage *>(UserData);
+	CSearchResultsBasePrivate *Results=Page->m_Results;
+
+	pthread_mutex_lock(&Results->m_Lock);
+
+	Page->m_Metadata=Metadata;
+	Page->m_Result=Result;
+
+	Page->m_ErrorMessage=ErrorMessage;
+
+	Page->m_Complete=true;
+
+	Results->m_Pending--;
+	pthread_cond_broadcast(&Results->m_PageDone);
+
+	pthread_mutex_unlock(&Results->m_Lock);
+}
@@ -29,7 +29,7 @@
 #include "musicbrainz5/SecondaryType.h"
 
 
-class MusicBrainz5::CSecondaryTypePrivate
+class MusicBrainz5::CSecondaryTypePrivate: public CSharedData
 {
 	public:
 		CSecondaryTypePrivate()
@@ -65,21 +65,51 @@ MusicBrainz5::CSecondaryType& MusicBrainz5::CSecondaryType::operator =(const CSe
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		m_d->m_SecondaryType=Other.m_d->m_SecondaryType;
+		if (!CSharedData::Share(m_d,Other.m_d))
+			m_d->m_SecondaryType=Other.m_d->m_SecondaryType;
+	}
+
+	return *this;
+}
+
+#if __cplusplus >= 201103L
+MusicBrainz5::CSecondaryType::CSecondaryType(CSecondaryType&& Other)
+:	CEntity(),
+	m_d(new CSecondaryTypePrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CSecondaryType& MusicBrainz5::CSecondaryType::operator =(CSecondaryType&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CSecondaryType::~CSecondaryType()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::CSecondaryType::Cleanup()
@@ -91,7 +121,7 @@ MusicBrainz5::CSecondaryType *MusicBrainz5::CSecondaryType::Clone()
 	return new CSecondaryType(*this);
 }
 
-void MusicBrainz5::CSecondaryType::ParseAttribute(const std::string& Name, const std::string& /*Value*/)
+void MusicBrainz5::CSecondaryType::ParseAttribute(const char *Name, const char * /*Value*/)
 {
 #ifdef _MB5_DEBUG_
 	std::cerr << "Unrecognised secondary type attribute: '" << Name << "'" << std::endl;
@@ -30,7 +30,7 @@
 
 #include "musicbrainz5/SecondaryType.h"
 
-class MusicBrainz5::CSecondaryTypeListPrivate
+class MusicBrainz5::CSecondaryTypeListPrivate: public CSharedData
 {
 	public:
 		CSecondaryTypeListPrivate()
@@ -61,15 +61,45 @@ MusicBrainz5::CSecondaryTypeList& MusicBrainz5::CSecondaryTypeList::operator =(c
 {
 	if (this!=&Other)
 	{
+		CSharedData::Unshare(m_d);
+
 		CListImpl<CSecondaryType>::operator =(Other);
+
+		CSharedData::Share(m_d,Other.m_d);
+	}
+
+	return *this;
+}
+
+#if __cplusplus >= 201103L
+MusicBrainz5::CSecondaryTypeList::CSecondaryTypeList(CSecondaryTypeList&& Other)
+:	CListImpl<CSecondaryType>(),
+	m_d(new CSecondaryTypeListPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CSecondaryTypeList& MusicBrainz5::CSecondaryTypeList::operator =(CSecondaryTypeList&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CListImpl<CSecondaryType>::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CSecondaryTypeList::~CSecondaryTypeList()
 {
-	delete m_d;
+	if (m_d->RemoveReference())
+		delete m_d;
 }
 
 MusicBrainz5::CSecondaryTypeList *MusicBrainz5::CSecondaryTypeList::Clone()
@@ -77,7 +107,7 @@ MusicBrainz5::CSecondaryTypeList *MusicBrainz5::CSecondaryTypeList::Clone()
 	return new CSecondaryTypeList(*this);
 }
 
-void MusicBrainz5::CSecondaryTypeList::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CSecondaryTypeList::ParseAttribute(const char *Name, const char *Value)
 {
 	CListImpl<CSecondaryType>::ParseAttribute(Name,Value);
 }
@@ -0,0 +1,97 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/SharedData.h"
+
+#include <pthread.h>
+
+static pthread_once_t ImmutableOnce=PTHREAD_ONCE_INIT;
+static pthread_key_t ImmutableKey;
+
+static void CreateImmutableKey()
+{
+	pthread_key_create(&ImmutableKey,0);
+}
+
+MusicBrainz5::CSharedData::CSharedData()
+:	m_References(1),
+	m_Immutable(CreateImmutable())
+{
+}
+
+bool MusicBrainz5::CSharedData::Immutable() const
+{
+	return m_Immutable;
+}
+
+bool MusicBrainz5::CSharedData::Shared() const
+{
+	return __sync_add_and_fetch(const_cast<int *>(&m_References),0)>1;
+}
+
+void MusicBrainz5::CSharedData::SetImmutable(bool Immutable)
+{
+	m_Immutable=Immutable;
+}
+
+void MusicBrainz5::CSharedData::AddReference()
+{
+	__sync_add_and_fetch(&m_References,1);
+}
+
+bool MusicBrainz5::CSharedData::RemoveReference()
+{
+	return 0==__sync_sub_and_fetch(&m_References,1);
+}
+
+bool MusicBrainz5::CSharedData::CreateImmutable()
+{
+	pthread_once(&ImmutableOnce,CreateImmutableKey);
+
+	return 0!=pthread_getspecific(ImmutableKey);
+}
+
+void MusicBrainz5::CSharedData::SetCreateImmutable(bool Immutable)
+{
+	pthread_once(&ImmutableOnce,CreateImmutableKey);
+
+	// Any non-null value will do
+
+	pthread_setspecific(ImmutableKey,Immutable ? &ImmutableKey : 0);
+}
+
+MusicBrainz5::CImmutableScope::CImmutableScope(bool Immutable)
+:	m_Previous(CSharedData::CreateImmutable())
+{
+	CSharedData::SetCreateImmutable(Immutable);
+}
+
+MusicBrainz5::CImmutableScope::~CImmutableScope()
+{
+	CSharedData::SetCreateImmutable(m_Previous);
+}
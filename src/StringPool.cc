@@ -0,0 +1,96 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/StringPool.h"
+
+#include <set>
+
+#include <pthread.h>
+
+// The pool is created on first use and deliberately never destroyed, so that entities
+// destroyed during static destruction can still refer to it
+
+static pthread_once_t PoolOnce=PTHREAD_ONCE_INIT;
+static pthread_rwlock_t PoolLock;
+static std::set<std::string> *Pool;
+static const std::string *EmptyString;
+
+static void CreatePool()
+{
+	pthread_rwlock_init(&PoolLock,0);
+
+	Pool=new std::set<std::string>;
+	EmptyString=&*Pool->insert(std::string()).first;
+}
+
+const std::string *MusicBrainz5::CStringPool::Intern(const std::string& String)
+{
+	if (String.empty())
+		return Empty();
+
+	pthread_once(&PoolOnce,CreatePool);
+
+	// Nearly every value is already in the pool, so look it up under a shared lock first
+
+	const std::string *Ret=0;
+
+	pthread_rwlock_rdlock(&PoolLock);
+
+	std::set<std::string>::const_iterator ThisString=Pool->find(String);
+	if (ThisString!=Pool->end())
+		Ret=&*ThisString;
+
+	pthread_rwlock_unlock(&PoolLock);
+
+	if (!Ret)
+	{
+		pthread_rwlock_wrlock(&PoolLock);
+		Ret=&*Pool->insert(String).first;
+		pthread_rwlock_unlock(&PoolLock);
+	}
+
+	return Ret;
+}
+
+const std::string *MusicBrainz5::CStringPool::Empty()
+{
+	pthread_once(&PoolOnce,CreatePool);
+
+	return EmptyString;
+}
+
+size_t MusicBrainz5::CStringPool::Size()
+{
+	pthread_once(&PoolOnce,CreatePool);
+
+	pthread_rwlock_rdlock(&PoolLock);
+	size_t Ret=Pool->size();
+	pthread_rwlock_unlock(&PoolLock);
+
+	return Ret;
+}
@@ -28,7 +28,9 @@
 
 #include "musicbrainz5/Tag.h"
 
-class MusicBrainz5::CTagPrivate
+#include <string.h>
+
+class MusicBrainz5::CTagPrivate: public CSharedData
 {
 	public:
 		CTagPrivate()
@@ -63,18 +65,49 @@ MusicBrainz5::CTag& MusicBrainz5::CTag::operator =(const CTag& Other)
 {
 	if (this!=&Other)
 	{
+		CSharedData::Unshare(m_d);
+
 		CEntity::operator =(Other);
 
-		m_d->m_Count=Other.m_d->m_Count;
-		m_d->m_Name=Other.m_d->m_Name;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_Count=Other.m_d->m_Count;
+			m_d->m_Name=Other.m_d->m_Name;
+		}
+	}
+
+	return *this;
+}
+
+#if __cplusplus >= 201103L
+MusicBrainz5::CTag::CTag(CTag&& Other)
+:	CEntity(),
+	m_d(new CTagPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CTag& MusicBrainz5::CTag::operator =(CTag&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CTag::~CTag()
 {
-	delete m_d;
+	if (m_d->RemoveReference())
+		delete m_d;
 }
 
 MusicBrainz5::CTag *MusicBrainz5::CTag::Clone()
@@ -82,9 +115,9 @@ MusicBrainz5::CTag *MusicBrainz5::CTag::Clone()
 	return new CTag(*this);
 }
 
-void MusicBrainz5::CTag::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CTag::ParseAttribute(const char *Name, const char *Value)
 {
-	if ("count"==Name)
+	if (0==strcmp(Name,"count"))
 	{
 		ProcessItem(Value,m_d->m_Count);
 	}
@@ -28,7 +28,7 @@
 
 #include "musicbrainz5/TextRepresentation.h"
 
-class MusicBrainz5::CTextRepresentationPrivate
+class MusicBrainz5::CTextRepresentationPrivate: public CSharedData
 {
 	public:
 		std::string m_Language;
@@ -58,18 +58,49 @@ MusicBrainz5::CTextRepresentation& MusicBrainz5::CTextRepresentation::operator =
 {
 	if (this!=&Other)
 	{
+		CSharedData::Unshare(m_d);
+
 		CEntity::operator =(Other);
 
-		m_d->m_Language=Other.m_d->m_Language;
-		m_d->m_Script=Other.m_d->m_Script;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_Language=Other.m_d->m_Language;
+			m_d->m_Script=Other.m_d->m_Script;
+		}
 	}
 
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+MusicBrainz5::CTextRepresentation::CTextRepresentation(CTextRepresentation&& Other)
+:	CEntity(),
+	m_d(new CTextRepresentationPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CTextRepresentation& MusicBrainz5::CTextRepresentation::operator =(CTextRepresentation&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CTextRepresentation::~CTextRepresentation()
 {
-	delete m_d;
+	if (m_d->RemoveReference())
+		delete m_d;
 }
 
 MusicBrainz5::CTextRepresentation *MusicBrainz5::CTextRepresentation::Clone()
@@ -77,7 +108,7 @@ MusicBrainz5::CTextRepresentation *MusicBrainz5::CTextRepresentation::Clone()
 	return new CTextRepresentation(*this);
 }
 
-void MusicBrainz5::CTextRepresentation::ParseAttribute(const std::string& Name, const std::string& /*Value*/)
+void MusicBrainz5::CTextRepresentation::ParseAttribute(const char *Name, const char * /*Value*/)
 {
 #ifdef _MB5_DEBUG_
 	std::cerr << "Unrecognised textrepresentation attribute: '" << Name << "'" << std::endl;
@@ -28,10 +28,12 @@
 
 #include "musicbrainz5/Track.h"
 
+#include "musicbrainz5/NameTable.h"
+
 #include "musicbrainz5/Recording.h"
 #include "musicbrainz5/ArtistCredit.h"
 
-class MusicBrainz5::CTrackPrivate
+class MusicBrainz5::CTrackPrivate: public CSharedData
 {
 	public:
 		CTrackPrivate()
@@ -50,6 +52,30 @@ class MusicBrainz5::CTrackPrivate
 		std::string m_Number;
 };
 
+// Child elements handled by ParseElement
+
+enum
+{
+	eElement_Position,
+	eElement_Title,
+	eElement_Recording,
+	eElement_Length,
+	eElement_ArtistCredit,
+	eElement_Number
+};
+
+static const MusicBrainz5::CNameTable::CEntry ElementEntries[]=
+{
+	{ "position", eElement_Position },
+	{ "title", eElement_Title },
+	{ "recording", eElement_Recording },
+	{ "length", eElement_Length },
+	{ "artist-credit", eElement_ArtistCredit },
+	{ "number", eElement_Number }
+};
+
+static const MusicBrainz5::CNameTable Elements(ElementEntries,sizeof(ElementEntries)/sizeof(ElementEntries[0]));
+
 MusicBrainz5::CTrack::CTrack(const XMLNode& Node)
 :	CEntity(),
 	m_d(new CTrackPrivate)
@@ -73,32 +99,64 @@ MusicBrainz5::CTrack& MusicBrainz5::CTrack::operator =(const CTrack& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		m_d->m_Position=Other.m_d->m_Position;
-		m_d->m_Title=Other.m_d->m_Title;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_Position=Other.m_d->m_Position;
+			m_d->m_Title=Other.m_d->m_Title;
 
-		if (Other.m_d->m_Recording)
-			m_d->m_Recording=new CRecording(*Other.m_d->m_Recording);
+			if (Other.m_d->m_Recording)
+				m_d->m_Recording=new CRecording(*Other.m_d->m_Recording);
 
-		m_d->m_Length=Other.m_d->m_Length;
+			m_d->m_Length=Other.m_d->m_Length;
 
-		if (Other.m_d->m_ArtistCredit)
-			m_d->m_ArtistCredit=new CArtistCredit(*Other.m_d->m_ArtistCredit);
+			if (Other.m_d->m_ArtistCredit)
+				m_d->m_ArtistCredit=new CArtistCredit(*Other.m_d->m_ArtistCredit);
 
-		m_d->m_Number=Other.m_d->m_Number;
+			m_d->m_Number=Other.m_d->m_Number;
+		}
+	}
+
+	return *this;
+}
+
+#if __cplusplus >= 201103L
+MusicBrainz5::CTrack::CTrack(CTrack&& Other)
+:	CEntity(),
+	m_d(new CTrackPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CTrack& MusicBrainz5::CTrack::operator =(CTrack&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CTrack::~CTrack()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::CTrack::Cleanup()
@@ -115,7 +173,7 @@ MusicBrainz5::CTrack *MusicBrainz5::CTrack::Clone()
 	return new CTrack(*this);
 }
 
-void MusicBrainz5::CTrack::ParseAttribute(const std::string& Name, const std::string& /*Value*/)
+void MusicBrainz5::CTrack::ParseAttribute(const char *Name, const char * /*Value*/)
 {
 #ifdef _MB5_DEBUG_
 	std::cerr << "Unrecognised track attribute: '" << Name << "'" << std::endl;
@@ -126,37 +184,37 @@ void MusicBrainz5::CTrack::ParseAttribute(const std::string& Name, const std::st
 
 void MusicBrainz5::CTrack::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
-
-	if ("position"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Position);
-	}
-	else if ("title"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Title);
-	}
-	else if ("recording"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Recording);
-	}
-	else if ("length"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Length);
-	}
-	else if ("artist-credit"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ArtistCredit);
-	}
-	else if ("number"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Number);
-	}
-	else
+	switch (Elements.Find(Node.getName()))
 	{
+		case eElement_Position:
+			ProcessItem(Node,m_d->m_Position);
+			break;
+
+		case eElement_Title:
+			ProcessItem(Node,m_d->m_Title);
+			break;
+
+		case eElement_Recording:
+			ProcessItem(Node,m_d->m_Recording);
+			break;
+
+		case eElement_Length:
+			ProcessItem(Node,m_d->m_Length);
+			break;
+
+		case eElement_ArtistCredit:
+			ProcessItem(Node,m_d->m_ArtistCredit);
+			break;
+
+		case eElement_Number:
+			ProcessItem(Node,m_d->m_Number);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised track element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised track element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
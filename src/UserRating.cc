@@ -28,7 +28,7 @@
 
 #include "musicbrainz5/UserRating.h"
 
-class MusicBrainz5::CUserRatingPrivate
+class MusicBrainz5::CUserRatingPrivate: public CSharedData
 {
 	public:
 		CUserRatingPrivate()
@@ -67,17 +67,46 @@ MusicBrainz5::CUserRating& MusicBrainz5::CUserRating::operator =(const CUserRati
 {
 	if (this!=&Other)
 	{
+		CSharedData::Unshare(m_d);
+
 		CEntity::operator =(Other);
 
-		m_d->m_UserRating=Other.m_d->m_UserRating;
+		if (!CSharedData::Share(m_d,Other.m_d))
+			m_d->m_UserRating=Other.m_d->m_UserRating;
 	}
 
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+MusicBrainz5::CUserRating::CUserRating(CUserRating&& Other)
+:	CEntity(),
+	m_d(new CUserRatingPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CUserRating& MusicBrainz5::CUserRating::operator =(CUserRating&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CUserRating::~CUserRating()
 {
-	delete m_d;
+	if (m_d->RemoveReference())
+		delete m_d;
 }
 
 MusicBrainz5::CUserRating *MusicBrainz5::CUserRating::Clone()
@@ -85,7 +114,7 @@ MusicBrainz5::CUserRating *MusicBrainz5::CUserRating::Clone()
 	return new CUserRating(*this);
 }
 
-void MusicBrainz5::CUserRating::ParseAttribute(const std::string& Name, const std::string& /*Value*/)
+void MusicBrainz5::CUserRating::ParseAttribute(const char *Name, const char * /*Value*/)
 {
 #ifdef _MB5_DEBUG_
 	std::cerr << "Unrecognised userrating attribute: '" << Name << "'" << std::endl;
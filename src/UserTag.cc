@@ -28,7 +28,7 @@
 
 #include "musicbrainz5/UserTag.h"
 
-class MusicBrainz5::CUserTagPrivate
+class MusicBrainz5::CUserTagPrivate: public CSharedData
 {
 	public:
 		std::string m_Name;
@@ -57,17 +57,46 @@ MusicBrainz5::CUserTag& MusicBrainz5::CUserTag::operator =(const CUserTag& Other
 {
 	if (this!=&Other)
 	{
+		CSharedData::Unshare(m_d);
+
 		CEntity::operator =(Other);
 
-		m_d->m_Name=Other.m_d->m_Name;
+		if (!CSharedData::Share(m_d,Other.m_d))
+			m_d->m_Name=Other.m_d->m_Name;
 	}
 
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+MusicBrainz5::CUserTag::CUserTag(CUserTag&& Other)
+:	CEntity(),
+	m_d(new CUserTagPrivate)
+{
+	*this=std::move(Other);
+}
+
+MusicBrainz5::CUserTag& MusicBrainz5::CUserTag::operator =(CUserTag&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CUserTag::~CUserTag()
 {
-	delete m_d;
+	if (m_d->RemoveReference())
+		delete m_d;
 }
 
 MusicBrainz5::CUserTag *MusicBrainz5::CUserTag::Clone()
@@ -75,7 +104,7 @@ MusicBrainz5::CUserTag *MusicBrainz5::CUserTag::Clone()
 	return new CUserTag(*this);
 }
 
-void MusicBrainz5::CUserTag::ParseAttribute(const std::string& Name, const std::string& /*Value*/)
+void MusicBrainz5::CUserTag::ParseAttribute(const char *Name, const char * /*Value*/)
 {
 #ifdef _MB5_DEBUG_
 	std::cerr << "Unrecognised usertag attribute: '" << Name << "'" << std::endl;
@@ -28,6 +28,10 @@
 
 #include "musicbrainz5/Work.h"
 
+#include "musicbrainz5/NameTable.h"
+
+#include <string.h>
+
 #include "musicbrainz5/ArtistCredit.h"
 #include "musicbrainz5/AliasList.h"
 #include "musicbrainz5/Alias.h"
@@ -42,7 +46,7 @@
 #include "musicbrainz5/ISWC.h"
 #include "musicbrainz5/ISWCList.h"
 
-class MusicBrainz5::CWorkPrivate
+class MusicBrainz5::CWorkPrivate: public CSharedData
 {
 	public:
 		CWorkPrivate()
@@ -72,6 +76,40 @@ class MusicBrainz5::CWorkPrivate
 		std::string m_Language;
 };
 
+// Child elements handled by ParseElement
+
+enum
+{
+	eElement_Title,
+	eElement_ArtistCredit,
+	eElement_ISWCList,
+	eElement_Disambiguation,
+	eElement_AliasList,
+	eElement_RelationList,
+	eElement_TagList,
+	eElement_UserTagList,
+	eElement_Rating,
+	eElement_UserRating,
+	eElement_Language
+};
+
+static const MusicBrainz5::CNameTable::CEntry ElementEntries[]=
+{
+	{ "title", eElement_Title },
+	{ "artist-credit", eElement_ArtistCredit },
+	{ "iswc-list", eElement_ISWCList },
+	{ "disambiguation", eElement_Disambiguation },
+	{ "alias-list", eElement_AliasList },
+	{ "relation-list", eElement_RelationList },
+	{ "tag-list", eElement_TagList },
+	{ "user-tag-list", eElement_UserTagList },
+	{ "rating", eElement_Rating },
+	{ "user-rating", eElement_UserRating },
+	{ "language", eElement_Language }
+};
+
+static const MusicBrainz5::CNameTable Elements(ElementEntries,sizeof(ElementEntries)/sizeof(ElementEntries[0]));
+
 MusicBrainz5::CWork::CWork(const XMLNode& Node)
 :	CEntity(),
 	m_d(new CWorkPrivate)
@@ -95,51 +133,83 @@ MusicBrainz5::CWork& MusicBrainz5::CWork::operator =(const CWork& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
+		if (!CSharedData::Unshare(m_d))
+			Cleanup();
 
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
-		m_d->m_Type=Other.m_d->m_Type;
-		m_d->m_Title=Other.m_d->m_Title;
+		if (!CSharedData::Share(m_d,Other.m_d))
+		{
+			m_d->m_ID=Other.m_d->m_ID;
+			m_d->m_Type=Other.m_d->m_Type;
+			m_d->m_Title=Other.m_d->m_Title;
+
+			if (Other.m_d->m_ArtistCredit)
+				m_d->m_ArtistCredit=new CArtistCredit(*Other.m_d->m_ArtistCredit);
 
-		if (Other.m_d->m_ArtistCredit)
-			m_d->m_ArtistCredit=new CArtistCredit(*Other.m_d->m_ArtistCredit);
+			if (Other.m_d->m_ISWCList)
+				m_d->m_ISWCList=new CISWCList(*Other.m_d->m_ISWCList);
 
-		if (Other.m_d->m_ISWCList)
-			m_d->m_ISWCList=new CISWCList(*Other.m_d->m_ISWCList);
+			m_d->m_Disambiguation=Other.m_d->m_Disambiguation;
 
-		m_d->m_Disambiguation=Other.m_d->m_Disambiguation;
+			if (Other.m_d->m_AliasList)
+				m_d->m_AliasList=new CAliasList(*Other.m_d->m_AliasList);
 
-		if (Other.m_d->m_AliasList)
-			m_d->m_AliasList=new CAliasList(*Other.m_d->m_AliasList);
+			if (Other.m_d->m_RelationListList)
+				m_d->m_RelationListList=new CRelationListList(*Other.m_d->m_RelationListList);
 
-		if (Other.m_d->m_RelationListList)
-			m_d->m_RelationListList=new CRelationListList(*Other.m_d->m_RelationListList);
+			if (Other.m_d->m_TagList)
+				m_d->m_TagList=new CTagList(*Other.m_d->m_TagList);
 
-		if (Other.m_d->m_TagList)
-			m_d->m_TagList=new CTagList(*Other.m_d->m_TagList);
+			if (Other.m_d->m_UserTagList)
+				m_d->m_UserTagList=new CUserTagList(*Other.m_d->m_UserTagList);
 
-		if (Other.m_d->m_UserTagList)
-			m_d->m_UserTagList=new CUserTagList(*Other.m_d->m_UserTagList);
+			if (Other.m_d->m_Rating)
+				m_d->m_Rating=new CRating(*Other.m_d->m_Rating);
+
+			if (Other.m_d->m_UserRating)
+				m_d->m_UserRating=new CUserRating(*Other.m_d->m_UserRating);
+
+			m_d->m_Language=Other.m_d->m_Language;
+		}
+	}
 
-		if (Other.m_d->m_Rating)
-			m_d->m_Rating=new CRating(*Other.m_d->m_Rating);
+	return *this;
+}
 
-		if (Other.m_d->m_UserRating)
-			m_d->m_UserRating=new CUserRating(*Other.m_d->m_UserRating);
+#if __cplusplus >= 201103L
+MusicBrainz5::CWork::CWork(CWork&& Other)
+:	CEntity(),
+	m_d(new CWorkPrivate)
+{
+	*this=std::move(Other);
+}
 
-		m_d->m_Language=Other.m_d->m_Language;
+MusicBrainz5::CWork& MusicBrainz5::CWork::operator =(CWork&& Other)
+{
+	if (this!=&Other)
+	{
+		if (CSharedData::CanMove(m_d,Other.m_d))
+		{
+			CEntity::operator =(std::move(Other));
+			std::swap(m_d,Other.m_d);
+		}
+		else
+			*this=Other;
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CWork::~CWork()
 {
-	Cleanup();
+	if (m_d->RemoveReference())
+	{
+		Cleanup();
 
-	delete m_d;
+		delete m_d;
+	}
 }
 
 void MusicBrainz5::CWork::Cleanup()
@@ -174,11 +244,11 @@ MusicBrainz5::CWork *MusicBrainz5::CWork::Clone()
 	return new CWork(*this);
 }
 
-void MusicBrainz5::CWork::ParseAttribute(const std::string& Name, const std::string& Value)
+void MusicBrainz5::CWork::ParseAttribute(const char *Name, const char *Value)
 {
-	if ("id"==Name)
+	if (0==strcmp(Name,"id"))
 		m_d->m_ID=Value;
-	else if ("type"==Name)
+	else if (0==strcmp(Name,"type"))
 		m_d->m_Type=Value;
 	else
 	{
@@ -190,57 +260,57 @@ void MusicBrainz5::CWork::ParseAttribute(const std::string& Name, const std::str
 
 void MusicBrainz5::CWork::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
-
-	if ("title"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Title);
-	}
-	else if ("artist-credit"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ArtistCredit);
-	}
-	else if ("iswc-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ISWCList);
-	}
-	else if ("disambiguation"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Disambiguation);
-	}
-	else if ("alias-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_AliasList);
-	}
-	else if ("relation-list"==NodeName)
-	{
-		ProcessRelationList(Node,m_d->m_RelationListList);
-	}
-	else if ("tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_TagList);
-	}
-	else if ("user-tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserTagList);
-	}
-	else if ("rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Rating);
-	}
-	else if ("user-rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserRating);
-	}
-	else if ("language"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Language);
-	}
-	else
+	switch (Elements.Find(Node.getName()))
 	{
+		case eElement_Title:
+			ProcessItem(Node,m_d->m_Title);
+			break;
+
+		case eElement_ArtistCredit:
+			ProcessItem(Node,m_d->m_ArtistCredit);
+			break;
+
+		case eElement_ISWCList:
+			ProcessItem(Node,m_d->m_ISWCList);
+			break;
+
+		case eElement_Disambiguation:
+			ProcessItem(Node,m_d->m_Disambiguation);
+			break;
+
+		case eElement_AliasList:
+			ProcessItem(Node,m_d->m_AliasList);
+			break;
+
+		case eElement_RelationList:
+			ProcessRelationList(Node,m_d->m_RelationListList);
+			break;
+
+		case eElement_TagList:
+			ProcessItem(Node,m_d->m_TagList);
+			break;
+
+		case eElement_UserTagList:
+			ProcessItem(Node,m_d->m_UserTagList);
+			break;
+
+		case eElement_Rating:
+			ProcessItem(Node,m_d->m_Rating);
+			break;
+
+		case eElement_UserRating:
+			ProcessItem(Node,m_d->m_UserRating);
+			break;
+
+		case eElement_Language:
+			ProcessItem(Node,m_d->m_Language);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised work element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised work element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
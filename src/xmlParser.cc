@@ -29,6 +29,7 @@
 #include "musicbrainz5/xmlParser.h"
 
 #include <cstring>
+#include <pthread.h>
 #include <libxml/tree.h>
 #include <libxml/parser.h>
 
@@ -51,36 +52,94 @@ XMLNode XMLNode::emptyNode()
     return XMLNode(NULL);
 }
 
-XMLNode *XMLRootNode::parseFile(const std::string &filename, XMLResults* results)
+/* Parser contexts are kept per thread, and reused for every document that
+ * thread parses, so that the context and its name dictionary are only
+ * created once. Errors are recorded in the context rather than printed. */
+#define PARSE_OPTIONS (XML_PARSE_NOERROR | XML_PARSE_NOWARNING)
+
+static pthread_once_t libraryOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t contextKey;
+
+static void freeContext(void *ctxt)
+{
+    xmlFreeParserCtxt((xmlParserCtxtPtr)ctxt);
+}
+
+static void initLibrary()
+{
+    xmlInitParser();
+    pthread_key_create(&contextKey, freeContext);
+}
+
+static xmlParserCtxtPtr threadContext()
 {
-    xmlDocPtr doc;
+    xmlParserCtxtPtr ctxt;
 
-    doc = xmlParseFile(filename.c_str());
-    if ((doc == NULL) && (results != NULL)) {
-        const xmlError *error = xmlGetLastError();
-        results->message = error->message;
-        results->line = error->line;
-        results->code = error->code;
+    pthread_once(&libraryOnce, initLibrary);
+
+    ctxt = (xmlParserCtxtPtr)pthread_getspecific(contextKey);
+    if (ctxt == NULL) {
+        ctxt = xmlNewParserCtxt();
+        if (ctxt != NULL)
+            pthread_setspecific(contextKey, ctxt);
     }
 
+    return ctxt;
+}
+
+/* The error of the last parse on this context, not some other thread's */
+static void setResults(xmlParserCtxtPtr ctxt, XMLResults *results)
+{
+    if (ctxt == NULL) {
+        results->code = XML_ERR_NO_MEMORY;
+        return;
+    }
+
+    results->code = ctxt->lastError.code;
+    results->line = ctxt->lastError.line;
+    if (ctxt->lastError.message != NULL)
+        results->message = ctxt->lastError.message;
+
+    if (results->code == XML_ERR_OK)
+        results->code = XML_ERR_DOCUMENT_EMPTY;
+}
+
+XMLNode *XMLRootNode::parseFile(const std::string &filename, XMLResults* results)
+{
+    xmlParserCtxtPtr ctxt = threadContext();
+    xmlDocPtr doc = NULL;
+
+    if (ctxt != NULL)
+        doc = xmlCtxtReadFile(ctxt, filename.c_str(), NULL, PARSE_OPTIONS);
+    if ((doc == NULL) && (results != NULL))
+        setResults(ctxt, results);
+
     return new XMLRootNode(doc);
 }
 
 XMLNode *XMLRootNode::parseString(const std::string &xml, XMLResults* results)
 {
-    xmlDocPtr doc;
+    return parseBuffer(xml.c_str(), xml.length(), results);
+}
 
-    doc = xmlParseMemory(xml.c_str(), xml.length());
-    if ((doc == NULL) && (results != NULL)) {
-        const xmlError *error = xmlGetLastError();
-        results->message = error->message;
-        results->line = error->line;
-        results->code = error->code;
-    }
+XMLNode *XMLRootNode::parseBuffer(const char *buffer, int length, XMLResults* results)
+{
+    xmlParserCtxtPtr ctxt = threadContext();
+    xmlDocPtr doc = NULL;
+
+    if (ctxt != NULL)
+        doc = xmlCtxtReadMemory(ctxt, buffer, length, NULL, NULL, PARSE_OPTIONS);
+    if ((doc == NULL) && (results != NULL))
+        setResults(ctxt, results);
 
     return new XMLRootNode(doc);
 }
 
+XMLNode *XMLRootNode::fromDocument(xmlDocPtr doc)
+{
+    return new XMLRootNode(doc);
+}
+
 const char *XMLNode::getName() const
 {
     return (char *)mNode->name;
@@ -96,6 +155,14 @@ const char *XMLNode::getText() const
     return (char*)mNode->children->content;
 }
 
+const char *XMLNode::getPrefix() const
+{
+    if (mNode->ns == NULL)
+        return NULL;
+
+    return (char *)mNode->ns->prefix;
+}
+
 xmlAttrPtr XMLNode::getAttributeRaw(const char *name) const
 {
     xmlAttrPtr attr;
@@ -126,6 +193,16 @@ bool XMLNode::isAttributeSet(const char *name) const
     return (this->getAttributeRaw(name) != NULL);
 }
 
+void *XMLNode::getUserData() const
+{
+    return mNode->_private;
+}
+
+void XMLNode::setUserData(void *data) const
+{
+    mNode->_private = data;
+}
+
 bool XMLNode::operator ==(const XMLNode &rhs) const
 {
     return mNode == rhs.mNode;
@@ -204,3 +281,208 @@ const XMLAttribute XMLAttribute::next() const {
     return XMLAttribute(mAttr->next);
 }
 
+const char *XMLAttribute::getName() const {
+    return (const char *)mAttr->name;
+}
+
+const char *XMLAttribute::getValue() const {
+    if (mAttr->children == NULL || mAttr->children->content == NULL)
+        return "";
+
+    return (const char *)mAttr->children->content;
+}
+
+const char *XMLAttribute::getPrefix() const {
+    if (mAttr->ns == NULL)
+        return NULL;
+
+    return (const char *)mAttr->ns->prefix;
+}
+
+
+XMLStreamHandler::~XMLStreamHandler()
+{
+}
+
+XMLStreamParser::XMLStreamParser(XMLStreamHandler *handler)
+    : mHandler(handler),
+      mContext(NULL),
+      mCurrent(NULL),
+      mDepth(0),
+      mCollectDepth(0)
+{
+    xmlSAXHandler sax;
+
+    memset(&sax, 0, sizeof(sax));
+    sax.initialized = XML_SAX2_MAGIC;
+    sax.startElementNs = onStartElement;
+    sax.endElementNs = onEndElement;
+    sax.characters = onCharacters;
+    sax.cdataBlock = onCharacters;
+
+    pthread_once(&libraryOnce, initLibrary);
+
+    mContext = xmlCreatePushParserCtxt(&sax, this, NULL, 0, NULL);
+}
+
+XMLStreamParser::~XMLStreamParser()
+{
+    /* Anything still open if the document was truncated or invalid */
+    if (mCollectDepth != 0) {
+        while (mCurrent->parent != NULL)
+            mCurrent = mCurrent->parent;
+        xmlFreeNode(mCurrent);
+    }
+
+    while (!mOpen.empty()) {
+        xmlFreeNode(mOpen.back());
+        mOpen.pop_back();
+    }
+
+    if (mContext != NULL)
+        xmlFreeParserCtxt(mContext);
+}
+
+bool XMLStreamParser::parseChunk(const char *data, int length, bool terminate)
+{
+    if (mContext == NULL) {
+        mResults.code = XML_ERR_NO_MEMORY;
+        return false;
+    }
+
+    if (mResults.code != eXMLErrorNone)
+        return false;
+
+    xmlParseChunk(mContext, data, length, terminate ? 1 : 0);
+
+    if (mContext->lastError.code != XML_ERR_OK) {
+        mResults.code = mContext->lastError.code;
+        mResults.line = mContext->lastError.line;
+        if (mContext->lastError.message != NULL)
+            mResults.message = mContext->lastError.message;
+    }
+
+    return mResults.code == eXMLErrorNone;
+}
+
+const XMLResults &XMLStreamParser::results() const
+{
+    return mResults;
+}
+
+/* Namespace declared on a node for a prefix, declaring it if need be, so
+ * that it is freed along with the node */
+static xmlNsPtr namespaceOf(xmlNodePtr node, const unsigned char *prefix,
+                            const unsigned char *URI)
+{
+    xmlNsPtr ns;
+
+    for (ns = node->nsDef; ns != NULL; ns = ns->next)
+        if (xmlStrEqual(ns->prefix, prefix))
+            return ns;
+
+    return xmlNewNs(node, URI, prefix);
+}
+
+void XMLStreamParser::onStartElement(void *ctx, const unsigned char *localname,
+                                     const unsigned char *prefix, const unsigned char *URI,
+                                     int nb_namespaces, const unsigned char **namespaces,
+                                     int nb_attributes, int nb_defaulted,
+                                     const unsigned char **attributes)
+{
+    XMLStreamParser *parser = (XMLStreamParser *)ctx;
+    xmlNodePtr node;
+    int i;
+
+    (void)nb_namespaces;
+    (void)namespaces;
+    (void)nb_defaulted;
+
+    parser->mDepth++;
+
+    /* Names are kept unqualified, with their namespace prefix available
+     * through getPrefix(), as they are in a tree built by xmlParseMemory */
+    node = xmlNewNode(NULL, localname);
+    if (prefix != NULL)
+        xmlSetNs(node, namespaceOf(node, prefix, URI));
+
+    for (i = 0; i < nb_attributes; i++) {
+        const unsigned char **attr = attributes + i * 5;
+        xmlChar *value = xmlStrndup(attr[3], attr[4] - attr[3]);
+
+        /* Without entity substitution, SAX2 hands '&' over as "&#38;" */
+        if (xmlStrstr(value, BAD_CAST "&#38;") != NULL) {
+            xmlChar *in = value, *out = value;
+
+            while (*in != 0) {
+                if (xmlStrncmp(in, BAD_CAST "&#38;", 5) == 0) {
+                    *out++ = '&';
+                    in += 5;
+                } else {
+                    *out++ = *in++;
+                }
+            }
+            *out = 0;
+        }
+
+        if (attr[1] != NULL)
+            xmlNewNsProp(node, namespaceOf(node, attr[1], attr[2]), attr[0], value);
+        else
+            xmlNewProp(node, attr[0], value);
+        xmlFree(value);
+    }
+
+    if (parser->mCollectDepth != 0) {
+        xmlAddChild(parser->mCurrent, node);
+        parser->mCurrent = node;
+        return;
+    }
+
+    parser->mCurrent = node;
+
+    if (parser->mHandler->startElement(XMLNode(node), parser->mDepth))
+        parser->mOpen.push_back(node);
+    else
+        parser->mCollectDepth = parser->mDepth;
+}
+
+void XMLStreamParser::onEndElement(void *ctx, const unsigned char *localname,
+                                   const unsigned char *prefix, const unsigned char *URI)
+{
+    XMLStreamParser *parser = (XMLStreamParser *)ctx;
+
+    (void)localname;
+    (void)prefix;
+    (void)URI;
+
+    if (parser->mCollectDepth == parser->mDepth) {
+        xmlNodePtr node = parser->mCurrent;
+
+        parser->mCollectDepth = 0;
+        parser->mCurrent = parser->mOpen.empty() ? NULL : parser->mOpen.back();
+
+        parser->mHandler->element(XMLNode(node), parser->mDepth);
+        xmlFreeNode(node);
+    } else if (parser->mCollectDepth != 0) {
+        parser->mCurrent = parser->mCurrent->parent;
+    } else {
+        xmlNodePtr node = parser->mOpen.back();
+
+        parser->mOpen.pop_back();
+        parser->mCurrent = parser->mOpen.empty() ? NULL : parser->mOpen.back();
+
+        parser->mHandler->endElement(XMLNode(node), parser->mDepth);
+        xmlFreeNode(node);
+    }
+
+    parser->mDepth--;
+}
+
+void XMLStreamParser::onCharacters(void *ctx, const unsigned char *ch, int len)
+{
+    XMLStreamParser *parser = (XMLStreamParser *)ctx;
+
+    /* Text directly inside a streamed element is never looked at */
+    if (parser->mCollectDepth != 0)
+        xmlAddChild(parser->mCurrent, xmlNewTextLen(ch, len));
+}
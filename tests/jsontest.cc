@@ -0,0 +1,175 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+// Checks that JSON responses give the same entities as the equivalent XML responses
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "musicbrainz5/Metadata.h"
+#include "musicbrainz5/JSONParser.h"
+#include "musicbrainz5/xmlParser.h"
+
+struct CFixture
+{
+	const char *m_Name;
+	const char *m_Entity;
+	const char *m_XML;
+	const char *m_JSON;
+};
+
+static const CFixture Fixtures[]=
+{
+	{
+		"release with relations to several types of target",
+		"release",
+
+		"<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+		"<metadata xmlns=\"http://musicbrainz.org/ns/mmd-2.0#\">"
+		"<release id=\"r1\">"
+		"<title>Title</title>"
+		"<status>Official</status>"
+		"<artist-credit>"
+		"<name-credit joinphrase=\" &amp; \"><name>Credited</name><artist id=\"a1\"><name>Artist</name><sort-name>Artist</sort-name></artist></name-credit>"
+		"<name-credit><artist id=\"a2\"><name>Other</name><sort-name>Other</sort-name></artist></name-credit>"
+		"</artist-credit>"
+		"<relation-list target-type=\"artist\">"
+		"<relation type=\"producer\"><target>a3</target><direction>backward</direction>"
+		"<attribute-list><attribute>co</attribute></attribute-list>"
+		"<begin>2001</begin><ended>true</ended>"
+		"<artist id=\"a3\"><name>Producer</name><sort-name>Producer</sort-name></artist></relation>"
+		"</relation-list>"
+		"<relation-list target-type=\"work\">"
+		"<relation type=\"performance\"><target>w1</target>"
+		"<work id=\"w1\"><title>Work</title><language>eng</language></work></relation>"
+		"</relation-list>"
+		"<relation-list target-type=\"url\">"
+		"<relation type=\"discogs\"><target id=\"u1\">http://example.com/release?a=1&amp;b=2</target></relation>"
+		"</relation-list>"
+		"<relation-list target-type=\"release_group\">"
+		"<relation type=\"single from\"><target>rg1</target>"
+		"<release-group id=\"rg1\" type=\"Album\"><title>Group</title><primary-type>Album</primary-type></release-group></relation>"
+		"</relation-list>"
+		"</release>"
+		"</metadata>",
+
+		"{\"id\":\"r1\",\"title\":\"Title\",\"status\":\"Official\",\"status-id\":\"s1\",\"disambiguation\":\"\",\"barcode\":null,"
+		"\"artist-credit\":["
+		"{\"name\":\"Credited\",\"joinphrase\":\" & \",\"artist\":{\"id\":\"a1\",\"name\":\"Artist\",\"sort-name\":\"Artist\"}},"
+		"{\"name\":\"Other\",\"joinphrase\":\"\",\"artist\":{\"id\":\"a2\",\"name\":\"Other\",\"sort-name\":\"Other\"}}],"
+		"\"relations\":["
+		"{\"type\":\"producer\",\"type-id\":\"t1\",\"target-type\":\"artist\",\"direction\":\"backward\","
+		"\"attributes\":[\"co\"],\"begin\":\"2001\",\"end\":null,\"ended\":true,"
+		"\"artist\":{\"id\":\"a3\",\"name\":\"Producer\",\"sort-name\":\"Producer\"}},"
+		"{\"type\":\"performance\",\"type-id\":\"t2\",\"target-type\":\"work\",\"direction\":\"forward\","
+		"\"attributes\":[],\"begin\":null,\"end\":null,\"ended\":false,"
+		"\"work\":{\"id\":\"w1\",\"title\":\"Work\",\"language\":\"eng\"}},"
+		"{\"type\":\"discogs\",\"type-id\":\"t3\",\"target-type\":\"url\",\"direction\":\"forward\","
+		"\"attributes\":[],\"begin\":null,\"end\":null,\"ended\":false,"
+		"\"url\":{\"id\":\"u1\",\"resource\":\"http://example.com/release?a=1&b=2\"}},"
+		"{\"type\":\"single from\",\"type-id\":\"t4\",\"target-type\":\"release_group\",\"direction\":\"forward\","
+		"\"attributes\":[],\"begin\":null,\"end\":null,\"ended\":false,"
+		"\"release_group\":{\"id\":\"rg1\",\"title\":\"Group\",\"primary-type\":\"Album\",\"primary-type-id\":\"p1\"}}]}"
+	},
+
+	{
+		"search results",
+		"artist",
+
+		"<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+		"<metadata xmlns=\"http://musicbrainz.org/ns/mmd-2.0#\" xmlns:ext=\"http://musicbrainz.org/ns/ext#-2.0\">"
+		"<artist-list count=\"12\" offset=\"10\">"
+		"<artist id=\"a1\" type=\"Group\" ext:score=\"100\"><name>One</name><sort-name>One</sort-name>"
+		"<tag-list><tag count=\"2\"><name>rock</name></tag></tag-list></artist>"
+		"<artist id=\"a2\" ext:score=\"90\"><name>Two \xc3\xa9\xf0\x9f\x8e\xb5</name><sort-name>Two</sort-name></artist>"
+		"</artist-list>"
+		"</metadata>",
+
+		"{\"created\":null,\"count\":12,\"offset\":10,\"artists\":["
+		"{\"id\":\"a1\",\"type\":\"Group\",\"type-id\":\"g1\",\"score\":100,\"name\":\"One\",\"sort-name\":\"One\","
+		"\"tags\":[{\"count\":2,\"name\":\"rock\"}]},"
+		"{\"id\":\"a2\",\"score\":90,\"name\":\"Two \\u00e9\\ud83c\\udfb5\",\"sort-name\":\"Two\"}]}"
+	}
+};
+
+static bool Serialise(const char *Data, const std::string& Entity, bool JSON, std::string& Output)
+{
+	XMLResults Results;
+	XMLNode *TopNode;
+
+	std::string Buffer(Data);
+
+	if (JSON)
+		TopNode=MusicBrainz5::CJSONParser::Parse(Buffer.c_str(),Buffer.length(),Entity,&Results);
+	else
+		TopNode=XMLRootNode::parseBuffer(Buffer.c_str(),Buffer.length(),&Results);
+
+	bool Ret=eXMLErrorNone==Results.code;
+
+	if (Ret)
+	{
+		MusicBrainz5::CMetadata Metadata(*TopNode);
+
+		std::stringstream os;
+		os << Metadata;
+		Output=os.str();
+	}
+
+	delete TopNode;
+
+	return Ret;
+}
+
+int main()
+{
+	int Failures=0;
+
+	for (size_t count=0;count<sizeof(Fixtures)/sizeof(Fixtures[0]);count++)
+	{
+		const CFixture& Fixture=Fixtures[count];
+
+		std::string XMLOutput;
+		std::string JSONOutput;
+
+		if (!Serialise(Fixture.m_XML,Fixture.m_Entity,false,XMLOutput) ||
+				!Serialise(Fixture.m_JSON,Fixture.m_Entity,true,JSONOutput))
+		{
+			std::cerr << Fixture.m_Name << ": parse failed" << std::endl;
+			Failures++;
+		}
+		else if (XMLOutput!=JSONOutput)
+		{
+			std::cerr << Fixture.m_Name << ": results differ" << std::endl;
+			std::cerr << "XML:" << std::endl << XMLOutput << std::endl;
+			std::cerr << "JSON:" << std::endl << JSONOutput << std::endl;
+			Failures++;
+		}
+		else
+			std::cout << Fixture.m_Name << ": ok" << std::endl;
+	}
+
+	return Failures ? 1 : 0;
+}
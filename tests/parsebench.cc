@@ -0,0 +1,186 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+// Measures how fast MusicBrainz XML or JSON responses are turned into entities, and
+// how many allocations that takes
+//
+// Usage: parsebench file [iterations] [entity]
+//
+// JSON responses are recognised from their contents. Entity is the entity the query
+// was made for ("release" by default), which JSON lookups need to be converted
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <new>
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <libxml/xmlmemory.h>
+
+#include "musicbrainz5/Metadata.h"
+#include "musicbrainz5/JSONParser.h"
+#include "musicbrainz5/xmlParser.h"
+
+static unsigned long Allocations=0;
+
+#if __cplusplus >= 201103L
+void *operator new(size_t Size)
+#else
+void *operator new(size_t Size) throw(std::bad_alloc)
+#endif
+{
+	Allocations++;
+
+	void *Ret=malloc(Size ? Size : 1);
+	if (!Ret)
+		throw std::bad_alloc();
+
+	return Ret;
+}
+
+#if __cplusplus >= 201103L
+void operator delete(void *Ptr) noexcept
+#else
+void operator delete(void *Ptr) throw()
+#endif
+{
+	free(Ptr);
+}
+
+#if __cplusplus >= 201402L
+void operator delete(void *Ptr, size_t) noexcept
+{
+	free(Ptr);
+}
+#endif
+
+static void *CountMalloc(size_t Size)
+{
+	Allocations++;
+
+	return malloc(Size);
+}
+
+static void *CountRealloc(void *Ptr, size_t Size)
+{
+	Allocations++;
+
+	return realloc(Ptr,Size);
+}
+
+static char *CountStrdup(const char *String)
+{
+	Allocations++;
+
+	return strdup(String);
+}
+
+static double Now()
+{
+	struct timespec TimeNow;
+	clock_gettime(CLOCK_MONOTONIC,&TimeNow);
+
+	return TimeNow.tv_sec+TimeNow.tv_nsec/1e9;
+}
+
+int main(int argc, const char *argv[])
+{
+	if (argc<2)
+	{
+		std::cerr << "Usage: " << argv[0] << " file [iterations] [entity]" << std::endl;
+		return 1;
+	}
+
+	std::ifstream File(argv[1],std::ios::binary);
+	if (!File)
+	{
+		std::cerr << "Unable to open '" << argv[1] << "'" << std::endl;
+		return 1;
+	}
+
+	std::stringstream Buffer;
+	Buffer << File.rdbuf();
+	std::string Data=Buffer.str();
+
+	int Iterations=argc>2 ? atoi(argv[2]) : 100;
+	std::string Entity=argc>3 ? argv[3] : "release";
+	bool JSON=MusicBrainz5::CJSONParser::IsJSON(Data.c_str(),Data.length());
+
+	// Allocations made by libxml2 are counted along with those made by the library
+
+	xmlMemSetup(free,CountMalloc,CountRealloc,CountStrdup);
+
+	double DocumentTime=0;
+	double EntityTime=0;
+	unsigned long DocumentAllocations=0;
+	unsigned long EntityAllocations=0;
+
+	for (int count=0;count<Iterations;count++)
+	{
+		unsigned long StartAllocations=Allocations;
+		double Start=Now();
+
+		XMLResults Results;
+		XMLNode *TopNode;
+
+		if (JSON)
+			TopNode=MusicBrainz5::CJSONParser::Parse(Data.c_str(),Data.length(),Entity,&Results);
+		else
+			TopNode=XMLRootNode::parseBuffer(Data.c_str(),Data.length(),&Results);
+
+		double Parsed=Now();
+		unsigned long ParsedAllocations=Allocations;
+
+		if (Results.code!=eXMLErrorNone)
+		{
+			std::cerr << "Error parsing '" << argv[1] << "'" << std::endl;
+			delete TopNode;
+			return 1;
+		}
+
+		{
+			MusicBrainz5::CMetadata Metadata(*TopNode);
+		}
+
+		EntityTime+=Now()-Parsed;
+		DocumentTime+=Parsed-Start;
+		EntityAllocations+=Allocations-ParsedAllocations;
+		DocumentAllocations+=ParsedAllocations-StartAllocations;
+
+		delete TopNode;
+	}
+
+	double MB=Data.length()*static_cast<double>(Iterations)/(1024*1024);
+
+	std::cout << "Size:     " << Data.length() << " bytes, " << Iterations << " iterations" << std::endl;
+	std::cout << (JSON ? "JSON:     " : "XML:      ") << DocumentTime*1000/Iterations << " ms per document, " << MB/DocumentTime << " MB/s, " << DocumentAllocations/Iterations << " allocations" << std::endl;
+	std::cout << "Entities: " << EntityTime*1000/Iterations << " ms per document, " << MB/EntityTime << " MB/s, " << EntityAllocations/Iterations << " allocations" << std::endl;
+
+	return 0;
+}
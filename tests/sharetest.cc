@@ -0,0 +1,175 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+
+// Checks that copying and moving entities that share immutable data leaves the other
+// entities sharing it unchanged
+
+#include <iostream>
+#include <string>
+
+#include <pthread.h>
+
+#include "musicbrainz5/Metadata.h"
+#include "musicbrainz5/Release.h"
+#include "musicbrainz5/ReleaseList.h"
+#include "musicbrainz5/SharedData.h"
+#include "musicbrainz5/StringPool.h"
+#include "musicbrainz5/xmlParser.h"
+
+static const char *Response=
+	"<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+	"<metadata xmlns=\"http://musicbrainz.org/ns/mmd-2.0#\">"
+	"<release id=\"r1\"><title>Bleach</title><status>Official</status></release>"
+	"</metadata>";
+
+static int Failures=0;
+
+static void Check(const std::string& Name, const MusicBrainz5::CRelease *Release, const std::string& ID, const std::string& Title)
+{
+	if (!Release || Release->ID()!=ID || Release->Title()!=Title)
+	{
+		std::cerr << Name << ": expected '" << ID << "' '" << Title << "', got ";
+		if (Release)
+			std::cerr << "'" << Release->ID() << "' '" << Release->Title() << "'" << std::endl;
+		else
+			std::cerr << "no release" << std::endl;
+
+		Failures++;
+	}
+	else
+		std::cout << Name << ": ok" << std::endl;
+}
+
+// Queries hand the same immutable result to every thread waiting for it, and each
+// moves the entity it returns out of its own copy
+
+static void *MoveThread(void *UserData)
+{
+	const MusicBrainz5::CMetadata *Original=static_cast<const MusicBrainz5::CMetadata *>(UserData);
+	long Failed=0;
+
+	for (int count=0;count<1000;count++)
+	{
+		MusicBrainz5::CMetadata Copy(*Original);
+		MusicBrainz5::CRelease Release;
+
+#if __cplusplus >= 201103L
+		Release=std::move(*Copy.Release());
+#else
+		Release=*Copy.Release();
+#endif
+
+		if (Release.Title()!="Bleach" || Original->Release()->Title()!="Bleach")
+			Failed++;
+	}
+
+	return reinterpret_cast<void *>(Failed);
+}
+
+int main()
+{
+	std::string Buffer(Response);
+
+	XMLResults Results;
+	XMLNode *TopNode=XMLRootNode::parseBuffer(Buffer.c_str(),Buffer.length(),&Results);
+	if (eXMLErrorNone!=Results.code)
+	{
+		std::cerr << "parse failed" << std::endl;
+		delete TopNode;
+		return 1;
+	}
+
+	MusicBrainz5::CMetadata *Original;
+
+	{
+		MusicBrainz5::CImmutableScope Immutable(true);
+		Original=new MusicBrainz5::CMetadata(*TopNode);
+	}
+
+	delete TopNode;
+
+	{
+		MusicBrainz5::CMetadata Copy(*Original);
+		MusicBrainz5::CRelease Release;
+
+#if __cplusplus >= 201103L
+		Release=std::move(*Copy.Release());
+#else
+		Release=*Copy.Release();
+#endif
+
+		Check("moved release",&Release,"r1","Bleach");
+
+		if (Release.InternedStatus()!=MusicBrainz5::CStringPool::Intern("Official"))
+		{
+			std::cerr << "interned status: differs from the pooled string" << std::endl;
+			Failures++;
+		}
+		else
+			std::cout << "interned status: ok" << std::endl;
+		Check("copy after move",Copy.Release(),"r1","Bleach");
+		Check("original after move",Original->Release(),"r1","Bleach");
+
+#if __cplusplus >= 201103L
+		MusicBrainz5::CMetadata Moved(std::move(Copy));
+#else
+		MusicBrainz5::CMetadata Moved(Copy);
+#endif
+
+		Check("moved metadata",Moved.Release(),"r1","Bleach");
+		Check("original after metadata move",Original->Release(),"r1","Bleach");
+	}
+
+	Check("original after copies destroyed",Original->Release(),"r1","Bleach");
+
+	pthread_t Threads[8];
+	long Failed=0;
+
+	for (size_t count=0;count<sizeof(Threads)/sizeof(Threads[0]);count++)
+		pthread_create(&Threads[count],0,MoveThread,Original);
+
+	for (size_t count=0;count<sizeof(Threads)/sizeof(Threads[0]);count++)
+	{
+		void *ThreadFailed;
+
+		pthread_join(Threads[count],&ThreadFailed);
+		Failed+=reinterpret_cast<long>(ThreadFailed);
+	}
+
+	if (Failed)
+	{
+		std::cerr << "moves from several threads: " << Failed << " failed" << std::endl;
+		Failures++;
+	}
+	else
+		std::cout << "moves from several threads: ok" << std::endl;
+
+	Check("original after moves from several threads",Original->Release(),"r1","Bleach");
+
+	delete Original;
+
+	return Failures ? 1 : 0;
+}